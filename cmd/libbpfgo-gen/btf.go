@@ -0,0 +1,375 @@
+package main
+
+import (
+	"bytes"
+	"debug/elf"
+	"encoding/binary"
+	"errors"
+	"fmt"
+)
+
+//
+// BTF (BPF Type Format) parsing
+//
+// Only what is needed to generate Go bindings is parsed: the type graph and
+// its names. Reference: https://docs.kernel.org/bpf/btf.html
+//
+
+const (
+	btfMagic      = 0xeb9f
+	btfHeaderSize = 24
+)
+
+type btfKind uint32
+
+const (
+	btfKindUnknown btfKind = iota
+	btfKindInt
+	btfKindPtr
+	btfKindArray
+	btfKindStruct
+	btfKindUnion
+	btfKindEnum
+	btfKindFwd
+	btfKindTypedef
+	btfKindVolatile
+	btfKindConst
+	btfKindRestrict
+	btfKindFunc
+	btfKindFuncProto
+	btfKindVar
+	btfKindDatasec
+	btfKindFloat
+	btfKindDeclTag
+	btfKindTypeTag
+	btfKindEnum64
+)
+
+// btf_type int encoding bits
+const (
+	btfIntSigned = 1 << 0
+	btfIntChar   = 1 << 1
+	btfIntBool   = 1 << 2
+)
+
+type btfMember struct {
+	name      string
+	typeID    uint32
+	bitOffset uint32
+	bitSize   uint32 // zero unless it is a bitfield
+}
+
+type btfSecVar struct {
+	typeID uint32
+	offset uint32
+	size   uint32
+}
+
+type btfType struct {
+	kind btfKind
+	name string
+	size uint32 // int, struct, union, enum, datasec and float
+	ref  uint32 // ptr, typedef, modifiers, func and var referenced type
+
+	intEncoding uint8
+	intBits     uint8
+
+	elemType uint32 // array
+	nelems   uint32 // array
+
+	members []btfMember // struct and union
+	vars    []btfSecVar // datasec
+}
+
+// btfSpec holds all the types of a BTF blob, indexed by type ID (0 is void).
+type btfSpec struct {
+	types []*btfType
+}
+
+// loadBTF parses the .BTF section of the ELF object.
+func loadBTF(f *elf.File) (*btfSpec, error) {
+	sec := f.Section(".BTF")
+	if sec == nil {
+		return nil, errors.New("object has no .BTF section")
+	}
+
+	data, err := sec.Data()
+	if err != nil {
+		return nil, fmt.Errorf("failed to read .BTF section: %w", err)
+	}
+
+	return parseBTF(data, f.ByteOrder)
+}
+
+func parseBTF(data []byte, bo binary.ByteOrder) (*btfSpec, error) {
+	if len(data) < btfHeaderSize || bo.Uint16(data) != btfMagic {
+		return nil, errors.New("invalid BTF header")
+	}
+
+	hdrLen := bo.Uint32(data[4:])
+	typeOff := bo.Uint32(data[8:])
+	typeLen := bo.Uint32(data[12:])
+	strOff := bo.Uint32(data[16:])
+	strLen := bo.Uint32(data[20:])
+
+	if uint64(hdrLen)+uint64(typeOff)+uint64(typeLen) > uint64(len(data)) ||
+		uint64(hdrLen)+uint64(strOff)+uint64(strLen) > uint64(len(data)) {
+		return nil, errors.New("BTF sections out of bounds")
+	}
+
+	types := data[hdrLen+typeOff : hdrLen+typeOff+typeLen]
+	strs := data[hdrLen+strOff : hdrLen+strOff+strLen]
+
+	str := func(off uint32) (string, error) {
+		if off >= uint32(len(strs)) {
+			return "", fmt.Errorf("BTF string offset %d out of bounds", off)
+		}
+		end := bytes.IndexByte(strs[off:], 0)
+		if end < 0 {
+			return "", fmt.Errorf("BTF string at offset %d not terminated", off)
+		}
+		return string(strs[off : off+uint32(end)]), nil
+	}
+
+	spec := &btfSpec{
+		types: []*btfType{{kind: btfKindUnknown}}, // void
+	}
+
+	r := btfReader{data: types, bo: bo}
+	for r.remaining() > 0 {
+		nameOff := r.u32()
+		info := r.u32()
+		sizeOrType := r.u32()
+		if r.err != nil {
+			return nil, r.err
+		}
+
+		name, err := str(nameOff)
+		if err != nil {
+			return nil, err
+		}
+
+		vlen := int(info & 0xffff)
+		kindFlag := info>>31 == 1
+		t := &btfType{
+			kind: btfKind((info >> 24) & 0x1f),
+			name: name,
+		}
+
+		switch t.kind {
+		case btfKindInt:
+			t.size = sizeOrType
+			enc := r.u32()
+			t.intEncoding = uint8((enc >> 24) & 0x0f)
+			t.intBits = uint8(enc & 0xff)
+		case btfKindPtr, btfKindTypedef, btfKindVolatile, btfKindConst,
+			btfKindRestrict, btfKindFunc, btfKindTypeTag:
+			t.ref = sizeOrType
+		case btfKindFwd:
+		case btfKindArray:
+			t.elemType = r.u32()
+			r.u32() // index type
+			t.nelems = r.u32()
+		case btfKindStruct, btfKindUnion:
+			t.size = sizeOrType
+			for i := 0; i < vlen; i++ {
+				m := btfMember{}
+				if m.name, err = str(r.u32()); err != nil {
+					return nil, err
+				}
+				m.typeID = r.u32()
+				offset := r.u32()
+				if kindFlag {
+					m.bitSize = offset >> 24
+					m.bitOffset = offset & 0xffffff
+				} else {
+					m.bitOffset = offset
+				}
+				t.members = append(t.members, m)
+			}
+		case btfKindEnum:
+			t.size = sizeOrType
+			r.skip(vlen * 8)
+		case btfKindEnum64:
+			t.size = sizeOrType
+			r.skip(vlen * 12)
+		case btfKindFuncProto:
+			t.ref = sizeOrType
+			r.skip(vlen * 8)
+		case btfKindVar:
+			t.ref = sizeOrType
+			r.u32() // linkage
+		case btfKindDatasec:
+			t.size = sizeOrType
+			for i := 0; i < vlen; i++ {
+				t.vars = append(t.vars, btfSecVar{
+					typeID: r.u32(),
+					offset: r.u32(),
+					size:   r.u32(),
+				})
+			}
+		case btfKindFloat:
+			t.size = sizeOrType
+		case btfKindDeclTag:
+			t.ref = sizeOrType
+			r.u32() // component index
+		default:
+			return nil, fmt.Errorf("unknown BTF kind %d", t.kind)
+		}
+		if r.err != nil {
+			return nil, r.err
+		}
+
+		spec.types = append(spec.types, t)
+	}
+
+	return spec, nil
+}
+
+func (s *btfSpec) typeByID(id uint32) (*btfType, error) {
+	if int(id) >= len(s.types) {
+		return nil, fmt.Errorf("BTF type id %d out of bounds", id)
+	}
+
+	return s.types[id], nil
+}
+
+// skipQualifiers follows modifiers and typedefs down to the underlying type.
+func (s *btfSpec) skipQualifiers(id uint32) (uint32, *btfType, error) {
+	for i := 0; i < len(s.types); i++ {
+		t, err := s.typeByID(id)
+		if err != nil {
+			return 0, nil, err
+		}
+		switch t.kind {
+		case btfKindTypedef, btfKindVolatile, btfKindConst, btfKindRestrict, btfKindTypeTag:
+			id = t.ref
+		default:
+			return id, t, nil
+		}
+	}
+
+	return 0, nil, fmt.Errorf("BTF type id %d: reference loop", id)
+}
+
+// sizeof returns the size in bytes of the given type.
+func (s *btfSpec) sizeof(id uint32) (uint32, error) {
+	_, t, err := s.skipQualifiers(id)
+	if err != nil {
+		return 0, err
+	}
+
+	switch t.kind {
+	case btfKindInt, btfKindStruct, btfKindUnion, btfKindEnum, btfKindEnum64,
+		btfKindFloat, btfKindDatasec:
+		return t.size, nil
+	case btfKindPtr:
+		return 8, nil
+	case btfKindArray:
+		elemSize, err := s.sizeof(t.elemType)
+		if err != nil {
+			return 0, err
+		}
+		return elemSize * t.nelems, nil
+	case btfKindVar:
+		return s.sizeof(t.ref)
+	}
+
+	return 0, fmt.Errorf("BTF type id %d (kind %d) has no size", id, t.kind)
+}
+
+// datasec returns the DATASEC type with the given name, or nil.
+func (s *btfSpec) datasec(name string) *btfType {
+	for _, t := range s.types {
+		if t.kind == btfKindDatasec && t.name == name {
+			return t
+		}
+	}
+
+	return nil
+}
+
+// fixupDatasecs fills in the DATASEC sizes and variable offsets from the ELF
+// sections and symbols, since the compiler leaves them zeroed in objects
+// (libbpf does the same when opening the object).
+func (s *btfSpec) fixupDatasecs(f *elf.File) error {
+	syms, err := f.Symbols()
+	if err != nil {
+		return fmt.Errorf("failed to read symbols: %w", err)
+	}
+
+	for _, t := range s.types {
+		if t.kind != btfKindDatasec {
+			continue
+		}
+
+		sec := f.Section(t.name)
+		if sec == nil {
+			continue // e.g. .kconfig and .ksyms externs
+		}
+		t.size = uint32(sec.Size)
+
+		offsets := make(map[string]uint32)
+		for _, sym := range syms {
+			if int(sym.Section) < len(f.Sections) && f.Sections[sym.Section] == sec {
+				offsets[sym.Name] = uint32(sym.Value)
+			}
+		}
+
+		for i := range t.vars {
+			v, err := s.typeByID(t.vars[i].typeID)
+			if err != nil {
+				return err
+			}
+			offset, ok := offsets[v.name]
+			if !ok {
+				return fmt.Errorf("no symbol for variable %s in section %s", v.name, t.name)
+			}
+			size, err := s.sizeof(v.ref)
+			if err != nil {
+				return err
+			}
+			t.vars[i].offset = offset
+			t.vars[i].size = size
+		}
+	}
+
+	return nil
+}
+
+// btfReader reads consecutive words, remembering the first error.
+type btfReader struct {
+	data []byte
+	off  int
+	bo   binary.ByteOrder
+	err  error
+}
+
+func (r *btfReader) remaining() int {
+	return len(r.data) - r.off
+}
+
+func (r *btfReader) u32() uint32 {
+	if r.err != nil {
+		return 0
+	}
+	if r.remaining() < 4 {
+		r.err = errors.New("truncated BTF type section")
+		return 0
+	}
+	v := r.bo.Uint32(r.data[r.off:])
+	r.off += 4
+
+	return v
+}
+
+func (r *btfReader) skip(n int) {
+	if r.err != nil {
+		return
+	}
+	if r.remaining() < n {
+		r.err = errors.New("truncated BTF type section")
+		return
+	}
+	r.off += n
+}
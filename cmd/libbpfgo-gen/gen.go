@@ -0,0 +1,662 @@
+package main
+
+import (
+	"bytes"
+	"debug/elf"
+	"fmt"
+	"go/format"
+	"sort"
+	"strings"
+)
+
+//
+// Go bindings generation
+//
+
+// BPF_MAP_TYPE_* values of per-CPU maps, whose values are one per possible
+// CPU and so can't be decoded into a single typed value.
+var perCPUMapTypes = map[uint32]bool{
+	5:  true, // BPF_MAP_TYPE_PERCPU_HASH
+	6:  true, // BPF_MAP_TYPE_PERCPU_ARRAY
+	10: true, // BPF_MAP_TYPE_LRU_PERCPU_HASH
+	21: true, // BPF_MAP_TYPE_PERCPU_CGROUP_STORAGE
+}
+
+type genArgs struct {
+	objName string   // object file name, for the generated header
+	pkg     string   // Go package of the generated file
+	ident   string   // prefix of all generated identifiers
+	types   []string // extra BTF types to generate decoders for
+}
+
+type goType struct {
+	expr  string
+	size  uint32
+	align uint32
+}
+
+type mapSpec struct {
+	name      string
+	mapType   uint32
+	keyType   uint32 // BTF type id, zero if unknown
+	valueType uint32 // BTF type id, zero if unknown
+}
+
+type sectionSpec struct {
+	name    string
+	datasec *btfType
+}
+
+type generator struct {
+	args  genArgs
+	spec  *btfSpec
+	named map[uint32]string // BTF type id to generated Go type name
+	decls bytes.Buffer
+	sizes []string // compile-time layout checks
+	// usesUnsafe tells if the generated code uses package unsafe, which is
+	// only imported then.
+	usesUnsafe bool
+}
+
+// generate returns the Go source of the bindings for the given object.
+func generate(f *elf.File, spec *btfSpec, args genArgs) ([]byte, error) {
+	g := &generator{
+		args:  args,
+		spec:  spec,
+		named: make(map[uint32]string),
+	}
+
+	maps, err := g.maps()
+	if err != nil {
+		return nil, err
+	}
+	progs, err := programs(f)
+	if err != nil {
+		return nil, err
+	}
+
+	return g.source(maps, progs)
+}
+
+// source returns the Go source of the bindings for the given maps and
+// programs.
+func (g *generator) source(maps []mapSpec, progs []string) ([]byte, error) {
+	sections := g.sections()
+
+	// the body is generated first, to import only the packages it uses
+	var body bytes.Buffer
+	if err := g.genObjects(&body, maps, progs); err != nil {
+		return nil, err
+	}
+	if err := g.genMapAccessors(&body, maps); err != nil {
+		return nil, err
+	}
+	if err := g.genSections(&body, sections); err != nil {
+		return nil, err
+	}
+	if err := g.genDecoders(&body); err != nil {
+		return nil, err
+	}
+
+	body.Write(g.decls.Bytes())
+
+	if len(g.sizes) > 0 {
+		body.WriteString("// Compile-time checks that the generated types match the BTF layout.\nvar (\n")
+		for _, check := range g.sizes {
+			body.WriteString("\t" + check + "\n")
+		}
+		body.WriteString(")\n")
+	}
+
+	var out bytes.Buffer
+	fmt.Fprintf(&out, "// Code generated by libbpfgo-gen from %s; DO NOT EDIT.\n\n", g.args.objName)
+	fmt.Fprintf(&out, "package %s\n\n", g.args.pkg)
+	out.WriteString("import (\n")
+	if len(g.args.types) > 0 {
+		out.WriteString("\t\"fmt\"\n") // only the decoders use it
+	}
+	if g.usesUnsafe {
+		out.WriteString("\t\"unsafe\"\n")
+	}
+	if len(g.args.types) > 0 || g.usesUnsafe {
+		out.WriteString("\n")
+	}
+	out.WriteString("\tbpf \"github.com/khulnasoft-lab/libbpfgo\"\n)\n\n")
+	out.Write(body.Bytes())
+
+	src, err := format.Source(out.Bytes())
+	if err != nil {
+		return nil, fmt.Errorf("failed to format generated code: %w", err)
+	}
+
+	return src, nil
+}
+
+func (g *generator) genObjects(out *bytes.Buffer, maps []mapSpec, progs []string) error {
+	objs := g.args.ident + "Objects"
+
+	fmt.Fprintf(out, "// %s holds the maps and programs of %s.\n", objs, g.args.objName)
+	fmt.Fprintf(out, "type %s struct {\n\tModule *bpf.Module\n\tMaps %sMaps\n\tProgs %sProgs\n}\n\n", objs, g.args.ident, g.args.ident)
+
+	fmt.Fprintf(out, "type %sMaps struct {\n", g.args.ident)
+	for _, m := range maps {
+		fmt.Fprintf(out, "\t%s *bpf.BPFMap\n", exportName(m.name))
+	}
+	out.WriteString("}\n\n")
+
+	fmt.Fprintf(out, "type %sProgs struct {\n", g.args.ident)
+	for _, p := range progs {
+		fmt.Fprintf(out, "\t%s *bpf.BPFProg\n", exportName(p))
+	}
+	out.WriteString("}\n\n")
+
+	fmt.Fprintf(out, "// New%s resolves all the maps and programs of module in a single pass.\n", objs)
+	fmt.Fprintf(out, "func New%s(module *bpf.Module) (*%s, error) {\n", objs, objs)
+	fmt.Fprintf(out, "\tobjs := &%s{Module: module}\n\n", objs)
+	out.WriteString("\tit := module.Iterator()\n")
+	out.WriteString("\tfor m := it.NextMap(); m != nil; m = it.NextMap() {\n\t\tswitch m.Name() {\n")
+	for _, m := range maps {
+		fmt.Fprintf(out, "\t\tcase %q:\n\t\t\tobjs.Maps.%s = m\n", m.name, exportName(m.name))
+	}
+	out.WriteString("\t\t}\n\t}\n")
+	out.WriteString("\tfor p := it.NextProgram(); p != nil; p = it.NextProgram() {\n\t\tswitch p.Name() {\n")
+	for _, p := range progs {
+		fmt.Fprintf(out, "\t\tcase %q:\n\t\t\tobjs.Progs.%s = p\n", p, exportName(p))
+	}
+	out.WriteString("\t\t}\n\t}\n\n")
+
+	// the iterator stops early if it can't get a map info, fall back to
+	// lookups by name for whatever was not resolved
+	out.WriteString("\tvar err error\n")
+	for _, m := range maps {
+		field := "objs.Maps." + exportName(m.name)
+		fmt.Fprintf(out, "\tif %s == nil {\n\t\tif %s, err = module.GetMap(%q); err != nil {\n\t\t\treturn nil, err\n\t\t}\n\t}\n", field, field, m.name)
+	}
+	for _, p := range progs {
+		field := "objs.Progs." + exportName(p)
+		fmt.Fprintf(out, "\tif %s == nil {\n\t\tif %s, err = module.GetProgram(%q); err != nil {\n\t\t\treturn nil, err\n\t\t}\n\t}\n", field, field, p)
+	}
+	out.WriteString("\n\treturn objs, nil\n}\n\n")
+
+	return nil
+}
+
+func (g *generator) genMapAccessors(out *bytes.Buffer, maps []mapSpec) error {
+	objs := g.args.ident + "Objects"
+
+	for _, m := range maps {
+		if m.keyType == 0 || m.valueType == 0 || perCPUMapTypes[m.mapType] {
+			continue
+		}
+
+		g.usesUnsafe = true
+		name := exportName(m.name)
+		keyName := g.args.ident + name + "Key"
+		valueName := g.args.ident + name + "Value"
+
+		key, err := g.goTypeOf(m.keyType)
+		if err != nil {
+			return fmt.Errorf("map %s key: %w", m.name, err)
+		}
+		value, err := g.goTypeOf(m.valueType)
+		if err != nil {
+			return fmt.Errorf("map %s value: %w", m.name, err)
+		}
+
+		fmt.Fprintf(out, "// %s is the key type of map %s.\ntype %s = %s\n\n", keyName, m.name, keyName, key.expr)
+		fmt.Fprintf(out, "// %s is the value type of map %s.\ntype %s = %s\n\n", valueName, m.name, valueName, value.expr)
+
+		fmt.Fprintf(out, "// Lookup%s returns the value of key in map %s.\n", name, m.name)
+		fmt.Fprintf(out, "func (o *%s) Lookup%s(key %s) (*%s, error) {\n", objs, name, keyName, valueName)
+		fmt.Fprintf(out, "\tvalueBytes, err := o.Maps.%s.GetValue(unsafe.Pointer(&key))\n\tif err != nil {\n\t\treturn nil, err\n\t}\n", name)
+		fmt.Fprintf(out, "\tvalue := new(%s)\n\tcopy((*[%d]byte)(unsafe.Pointer(value))[:], valueBytes)\n\n\treturn value, nil\n}\n\n", valueName, value.size)
+
+		fmt.Fprintf(out, "// Update%s sets the value of key in map %s.\n", name, m.name)
+		fmt.Fprintf(out, "func (o *%s) Update%s(key %s, value *%s) error {\n", objs, name, keyName, valueName)
+		fmt.Fprintf(out, "\treturn o.Maps.%s.Update(unsafe.Pointer(&key), unsafe.Pointer(value))\n}\n\n", name)
+	}
+
+	return nil
+}
+
+func (g *generator) genSections(out *bytes.Buffer, sections []sectionSpec) error {
+	objs := g.args.ident + "Objects"
+
+	for _, sec := range sections {
+		g.usesUnsafe = true
+		name := exportName(strings.TrimPrefix(sec.name, "."))
+		typeName := g.args.ident + name
+
+		body, _, err := g.sectionLayout(sec.datasec)
+		if err != nil {
+			return fmt.Errorf("section %s: %w", sec.name, err)
+		}
+		fmt.Fprintf(&g.decls, "// %s mirrors the variables of the %s section.\ntype %s struct {\n%s}\n\n", typeName, sec.name, typeName, body)
+
+		size := sec.datasec.size
+
+		fmt.Fprintf(out, "// %sInitialValue returns the initial value of the %s section variables.\n", name, sec.name)
+		out.WriteString("// It must be called before the module is loaded.\n")
+		fmt.Fprintf(out, "func (o *%s) %sInitialValue() (*%s, error) {\n", objs, name, typeName)
+		fmt.Fprintf(out, "\tm, err := o.Module.GetMap(%q)\n\tif err != nil {\n\t\treturn nil, err\n\t}\n", sec.name)
+		out.WriteString("\tvalueBytes, err := m.InitialValue()\n\tif err != nil {\n\t\treturn nil, err\n\t}\n")
+		fmt.Fprintf(out, "\tvalue := new(%s)\n\tcopy((*[%d]byte)(unsafe.Pointer(value))[:], valueBytes)\n\n\treturn value, nil\n}\n\n", typeName, size)
+
+		fmt.Fprintf(out, "// Set%sInitialValue sets the initial value of the %s section variables.\n", name, sec.name)
+		out.WriteString("// It must be called before the module is loaded.\n")
+		fmt.Fprintf(out, "func (o *%s) Set%sInitialValue(value *%s) error {\n", objs, name, typeName)
+		fmt.Fprintf(out, "\tm, err := o.Module.GetMap(%q)\n\tif err != nil {\n\t\treturn err\n\t}\n\n", sec.name)
+		out.WriteString("\treturn m.SetInitialValue(unsafe.Pointer(value))\n}\n\n")
+
+		fmt.Fprintf(out, "// Read%s reads the %s section variables from the kernel.\n", name, sec.name)
+		out.WriteString("// It must be called after the module is loaded.\n")
+		fmt.Fprintf(out, "func (o *%s) Read%s() (*%s, error) {\n", objs, name, typeName)
+		fmt.Fprintf(out, "\tm, err := o.Module.GetMap(%q)\n\tif err != nil {\n\t\treturn nil, err\n\t}\n", sec.name)
+		out.WriteString("\tkey := uint32(0)\n\tvalueBytes, err := m.GetValue(unsafe.Pointer(&key))\n\tif err != nil {\n\t\treturn nil, err\n\t}\n")
+		fmt.Fprintf(out, "\tvalue := new(%s)\n\tcopy((*[%d]byte)(unsafe.Pointer(value))[:], valueBytes)\n\n\treturn value, nil\n}\n\n", typeName, size)
+
+		if strings.HasPrefix(sec.name, ".rodata") {
+			continue // frozen once loaded
+		}
+
+		fmt.Fprintf(out, "// Write%s writes the %s section variables to the kernel.\n", name, sec.name)
+		out.WriteString("// It must be called after the module is loaded.\n")
+		fmt.Fprintf(out, "func (o *%s) Write%s(value *%s) error {\n", objs, name, typeName)
+		fmt.Fprintf(out, "\tm, err := o.Module.GetMap(%q)\n\tif err != nil {\n\t\treturn err\n\t}\n", sec.name)
+		out.WriteString("\tkey := uint32(0)\n\n\treturn m.Update(unsafe.Pointer(&key), unsafe.Pointer(value))\n}\n\n")
+	}
+
+	return nil
+}
+
+func (g *generator) genDecoders(out *bytes.Buffer) error {
+	for _, typeName := range g.args.types {
+		id, err := g.typeByName(typeName)
+		if err != nil {
+			return err
+		}
+		t, err := g.goTypeOf(id)
+		if err != nil {
+			return fmt.Errorf("type %s: %w", typeName, err)
+		}
+
+		g.usesUnsafe = true
+		fn := "Decode" + g.args.ident + exportName(typeName)
+		fmt.Fprintf(out, "// %s decodes a %s, e.g. an event read from a ring or perf buffer.\n", fn, typeName)
+		fmt.Fprintf(out, "func %s(b []byte) (*%s, error) {\n", fn, t.expr)
+		fmt.Fprintf(out, "\tif len(b) < %d {\n\t\treturn nil, fmt.Errorf(\"%s: need %d bytes, got %%d\", len(b))\n\t}\n", t.size, typeName, t.size)
+		fmt.Fprintf(out, "\tvalue := new(%s)\n\tcopy((*[%d]byte)(unsafe.Pointer(value))[:], b)\n\n\treturn value, nil\n}\n\n", t.expr, t.size)
+	}
+
+	return nil
+}
+
+//
+// Object inspection
+//
+
+// maps returns the BTF defined maps (the .maps section variables).
+func (g *generator) maps() ([]mapSpec, error) {
+	sec := g.spec.datasec(".maps")
+	if sec == nil {
+		return nil, nil
+	}
+
+	var maps []mapSpec
+	for _, v := range sec.vars {
+		varType, err := g.spec.typeByID(v.typeID)
+		if err != nil {
+			return nil, err
+		}
+		_, def, err := g.spec.skipQualifiers(varType.ref)
+		if err != nil {
+			return nil, err
+		}
+		if def.kind != btfKindStruct {
+			return nil, fmt.Errorf("map %s: definition is not a struct", varType.name)
+		}
+
+		m := mapSpec{name: varType.name}
+		for _, member := range def.members {
+			switch member.name {
+			case "type":
+				// __uint(type, X) is encoded as int (*type)[X]
+				if m.mapType, err = g.uintMember(member.typeID); err != nil {
+					return nil, fmt.Errorf("map %s: %w", m.name, err)
+				}
+			case "key":
+				if m.keyType, err = g.pointee(member.typeID); err != nil {
+					return nil, fmt.Errorf("map %s: %w", m.name, err)
+				}
+			case "value":
+				if m.valueType, err = g.pointee(member.typeID); err != nil {
+					return nil, fmt.Errorf("map %s: %w", m.name, err)
+				}
+			}
+		}
+		maps = append(maps, m)
+	}
+
+	return maps, nil
+}
+
+func (g *generator) pointee(id uint32) (uint32, error) {
+	_, ptr, err := g.spec.skipQualifiers(id)
+	if err != nil {
+		return 0, err
+	}
+	if ptr.kind != btfKindPtr {
+		return 0, fmt.Errorf("type id %d is not a pointer", id)
+	}
+
+	return ptr.ref, nil
+}
+
+func (g *generator) uintMember(id uint32) (uint32, error) {
+	pointee, err := g.pointee(id)
+	if err != nil {
+		return 0, err
+	}
+	_, arr, err := g.spec.skipQualifiers(pointee)
+	if err != nil {
+		return 0, err
+	}
+	if arr.kind != btfKindArray {
+		return 0, fmt.Errorf("type id %d is not an __uint() encoding", id)
+	}
+
+	return arr.nelems, nil
+}
+
+// sections returns the global variable sections, which libbpf exposes as
+// internal array maps named after the section.
+func (g *generator) sections() []sectionSpec {
+	var sections []sectionSpec
+	for _, t := range g.spec.types {
+		if t.kind != btfKindDatasec || len(t.vars) == 0 || t.size == 0 {
+			continue
+		}
+		if t.name == ".bss" || t.name == ".data" || t.name == ".rodata" ||
+			strings.HasPrefix(t.name, ".data.") || strings.HasPrefix(t.name, ".rodata.") {
+			sections = append(sections, sectionSpec{name: t.name, datasec: t})
+		}
+	}
+
+	return sections
+}
+
+// programs returns the names of the BPF programs: the functions of the
+// executable sections other than .text, which holds subprograms, whatever
+// their binding (static programs are local symbols).
+func programs(f *elf.File) ([]string, error) {
+	syms, err := f.Symbols()
+	if err != nil {
+		return nil, fmt.Errorf("failed to read symbols: %w", err)
+	}
+
+	var progs []string
+	for _, sym := range syms {
+		if elf.ST_TYPE(sym.Info) != elf.STT_FUNC {
+			continue
+		}
+		if int(sym.Section) >= len(f.Sections) {
+			continue
+		}
+		sec := f.Sections[sym.Section]
+		if sec.Flags&elf.SHF_EXECINSTR == 0 || sec.Name == ".text" {
+			continue
+		}
+		progs = append(progs, sym.Name)
+	}
+	sort.Strings(progs)
+
+	return progs, nil
+}
+
+func (g *generator) typeByName(name string) (uint32, error) {
+	for id, t := range g.spec.types {
+		switch t.kind {
+		case btfKindStruct, btfKindUnion, btfKindTypedef, btfKindEnum, btfKindEnum64:
+			if t.name == name {
+				return uint32(id), nil
+			}
+		}
+	}
+
+	return 0, fmt.Errorf("type %s not found in BTF", name)
+}
+
+//
+// Type mapping
+//
+
+// goTypeOf returns the Go type with the same layout as the given BTF type.
+// Named structs are generated as named Go types.
+func (g *generator) goTypeOf(id uint32) (goType, error) {
+	typedefName := ""
+	for {
+		t, err := g.spec.typeByID(id)
+		if err != nil {
+			return goType{}, err
+		}
+		switch t.kind {
+		case btfKindVolatile, btfKindConst, btfKindRestrict, btfKindTypeTag:
+			id = t.ref
+			continue
+		case btfKindTypedef:
+			if typedefName == "" {
+				typedefName = t.name
+			}
+			id = t.ref
+			continue
+		}
+		break
+	}
+
+	t, err := g.spec.typeByID(id)
+	if err != nil {
+		return goType{}, err
+	}
+
+	switch t.kind {
+	case btfKindInt:
+		if t.intEncoding&btfIntBool != 0 && t.size == 1 {
+			return goType{"bool", 1, 1}, nil
+		}
+		return intType(t.size, t.intEncoding&btfIntSigned != 0), nil
+	case btfKindEnum, btfKindEnum64:
+		return intType(t.size, false), nil
+	case btfKindFloat:
+		switch t.size {
+		case 4:
+			return goType{"float32", 4, 4}, nil
+		case 8:
+			return goType{"float64", 8, 8}, nil
+		}
+		return bytesType(t.size), nil
+	case btfKindPtr:
+		return goType{"uint64", 8, 8}, nil
+	case btfKindArray:
+		elem, err := g.goTypeOf(t.elemType)
+		if err != nil {
+			return goType{}, err
+		}
+		return goType{fmt.Sprintf("[%d]%s", t.nelems, elem.expr), elem.size * t.nelems, elem.align}, nil
+	case btfKindUnion:
+		return bytesType(t.size), nil
+	case btfKindStruct:
+		name := t.name
+		if name == "" {
+			name = typedefName
+		}
+		if name == "" {
+			body, align, err := g.structLayout(t.members, t.size)
+			if err != nil {
+				return goType{}, err
+			}
+			return goType{"struct {\n" + body + "}", t.size, align}, nil
+		}
+		return g.namedStruct(id, t, name)
+	}
+
+	return goType{}, fmt.Errorf("BTF type id %d (kind %d) has no Go equivalent", id, t.kind)
+}
+
+func (g *generator) namedStruct(id uint32, t *btfType, name string) (goType, error) {
+	goName, ok := g.named[id]
+	if !ok {
+		goName = g.args.ident + exportName(name)
+		g.named[id] = goName
+
+		body, _, err := g.structLayout(t.members, t.size)
+		if err != nil {
+			return goType{}, fmt.Errorf("struct %s: %w", name, err)
+		}
+		fmt.Fprintf(&g.decls, "// %s mirrors struct %s.\ntype %s struct {\n%s}\n\n", goName, name, goName, body)
+		g.sizes = append(g.sizes, fmt.Sprintf("_ [%d]byte = [unsafe.Sizeof(%s{})]byte{}", t.size, goName))
+	}
+
+	_, align, err := g.structLayout(t.members, t.size)
+	if err != nil {
+		return goType{}, err
+	}
+
+	return goType{goName, t.size, align}, nil
+}
+
+type layoutField struct {
+	name   string
+	typeID uint32
+	offset uint32 // bytes
+	bitfld bool
+}
+
+func (g *generator) structLayout(members []btfMember, size uint32) (string, uint32, error) {
+	fields := make([]layoutField, 0, len(members))
+	for _, m := range members {
+		fields = append(fields, layoutField{
+			name:   m.name,
+			typeID: m.typeID,
+			offset: m.bitOffset / 8,
+			bitfld: m.bitSize != 0 || m.bitOffset%8 != 0,
+		})
+	}
+
+	body, align, err := g.layout(fields, size, false)
+	if err != nil {
+		return "", 0, err
+	}
+	if size%align != 0 {
+		// packed struct: Go would pad it, so fall back to byte arrays
+		return g.layout(fields, size, true)
+	}
+
+	return body, align, nil
+}
+
+func (g *generator) sectionLayout(sec *btfType) (string, uint32, error) {
+	fields := make([]layoutField, 0, len(sec.vars))
+	for _, v := range sec.vars {
+		varType, err := g.spec.typeByID(v.typeID)
+		if err != nil {
+			return "", 0, err
+		}
+		fields = append(fields, layoutField{
+			name:   varType.name,
+			typeID: varType.ref,
+			offset: v.offset,
+		})
+	}
+	sort.SliceStable(fields, func(i, j int) bool {
+		return fields[i].offset < fields[j].offset
+	})
+
+	// sections may not be padded to their alignment, so the Go struct is
+	// allowed to be bigger than the section (only its size is copied)
+	return g.layout(fields, sec.size, false)
+}
+
+// layout generates the fields of a Go struct placing each field at the same
+// offset as in C, with explicit padding. Bitfields are left as padding and
+// misaligned fields, or all fields if packed, become byte arrays.
+func (g *generator) layout(fields []layoutField, size uint32, packed bool) (string, uint32, error) {
+	var body strings.Builder
+	used := make(map[string]int)
+	cur, align := uint32(0), uint32(1)
+
+	for i, f := range fields {
+		if f.bitfld || f.offset < cur {
+			continue // covered by the padding around it
+		}
+
+		ft, err := g.goTypeOf(f.typeID)
+		if err != nil {
+			return "", 0, fmt.Errorf("field %s: %w", f.name, err)
+		}
+		if packed || f.offset%ft.align != 0 {
+			ft = bytesType(ft.size)
+		}
+
+		if f.offset > cur {
+			fmt.Fprintf(&body, "\t_ [%d]byte\n", f.offset-cur)
+		}
+
+		name := exportName(f.name)
+		if f.name == "" {
+			name = fmt.Sprintf("Anon%d", i)
+		}
+		if n := used[name]; n > 0 {
+			used[name]++
+			name = fmt.Sprintf("%s%d", name, n)
+		} else {
+			used[name] = 1
+		}
+
+		fmt.Fprintf(&body, "\t%s %s\n", name, ft.expr)
+		cur = f.offset + ft.size
+		if ft.align > align {
+			align = ft.align
+		}
+	}
+
+	if cur < size {
+		fmt.Fprintf(&body, "\t_ [%d]byte\n", size-cur)
+	}
+
+	return body.String(), align, nil
+}
+
+func intType(size uint32, signed bool) goType {
+	prefix := "uint"
+	if signed {
+		prefix = "int"
+	}
+
+	switch size {
+	case 1, 2, 4, 8:
+		return goType{fmt.Sprintf("%s%d", prefix, size*8), size, size}
+	}
+
+	return bytesType(size) // e.g. __int128
+}
+
+func bytesType(size uint32) goType {
+	return goType{fmt.Sprintf("[%d]byte", size), size, 1}
+}
+
+// exportName converts a C identifier to an exported Go identifier, e.g.
+// event_t to EventT.
+func exportName(name string) string {
+	var b strings.Builder
+	for _, part := range strings.Split(name, "_") {
+		if part == "" {
+			continue
+		}
+		b.WriteString(strings.ToUpper(part[:1]) + part[1:])
+	}
+	if b.Len() == 0 {
+		return "X"
+	}
+
+	return b.String()
+}
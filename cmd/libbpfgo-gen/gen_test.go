@@ -0,0 +1,398 @@
+package main
+
+import (
+	"bytes"
+	"debug/elf"
+	"encoding/binary"
+	"go/ast"
+	"go/importer"
+	"go/parser"
+	"go/token"
+	"go/types"
+	"strings"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+// btfBuilder assembles a little endian BTF blob for tests.
+type btfBuilder struct {
+	types bytes.Buffer
+	strs  bytes.Buffer
+	n     uint32
+}
+
+func newBTFBuilder() *btfBuilder {
+	b := &btfBuilder{}
+	b.strs.WriteByte(0)
+	return b
+}
+
+func (b *btfBuilder) str(s string) uint32 {
+	if s == "" {
+		return 0
+	}
+	off := uint32(b.strs.Len())
+	b.strs.WriteString(s)
+	b.strs.WriteByte(0)
+	return off
+}
+
+func (b *btfBuilder) words(words ...uint32) {
+	for _, w := range words {
+		_ = binary.Write(&b.types, binary.LittleEndian, w)
+	}
+}
+
+func (b *btfBuilder) add(name string, kind btfKind, vlen int, kindFlag bool, sizeOrType uint32, extra ...uint32) uint32 {
+	info := uint32(kind)<<24 | uint32(vlen)
+	if kindFlag {
+		info |= 1 << 31
+	}
+	b.words(b.str(name), info, sizeOrType)
+	b.words(extra...)
+	b.n++
+	return b.n
+}
+
+func (b *btfBuilder) intType(name string, size uint32, encoding uint32) uint32 {
+	return b.add(name, btfKindInt, 0, false, size, encoding<<24|size*8)
+}
+
+func (b *btfBuilder) structType(name string, size uint32, members ...btfMember) uint32 {
+	var extra []uint32
+	kindFlag := false
+	for _, m := range members {
+		offset := m.bitOffset
+		if m.bitSize != 0 {
+			kindFlag = true
+			offset |= m.bitSize << 24
+		}
+		extra = append(extra, b.str(m.name), m.typeID, offset)
+	}
+	return b.add(name, btfKindStruct, len(members), kindFlag, size, extra...)
+}
+
+func (b *btfBuilder) bytes() []byte {
+	var out bytes.Buffer
+	hdr := []interface{}{
+		uint16(btfMagic), uint8(1), uint8(0), uint32(btfHeaderSize),
+		uint32(0), uint32(b.types.Len()),
+		uint32(b.types.Len()), uint32(b.strs.Len()),
+	}
+	for _, v := range hdr {
+		_ = binary.Write(&out, binary.LittleEndian, v)
+	}
+	out.Write(b.types.Bytes())
+	out.Write(b.strs.Bytes())
+	return out.Bytes()
+}
+
+func TestParseBTF(t *testing.T) {
+	b := newBTFBuilder()
+	intID := b.intType("int", 4, btfIntSigned)
+	ptrID := b.add("", btfKindPtr, 0, false, intID)
+	structID := b.structType("pair", 16,
+		btfMember{name: "a", typeID: intID, bitOffset: 0},
+		btfMember{name: "p", typeID: ptrID, bitOffset: 64},
+	)
+
+	spec, err := parseBTF(b.bytes(), binary.LittleEndian)
+	require.NoError(t, err)
+	require.Len(t, spec.types, 4)
+
+	st, err := spec.typeByID(structID)
+	require.NoError(t, err)
+	assert.Equal(t, "pair", st.name)
+	assert.Equal(t, btfKindStruct, st.kind)
+	assert.Equal(t, uint32(16), st.size)
+	require.Len(t, st.members, 2)
+	assert.Equal(t, uint32(64), st.members[1].bitOffset)
+
+	size, err := spec.sizeof(ptrID)
+	require.NoError(t, err)
+	assert.Equal(t, uint32(8), size)
+
+	_, err = parseBTF(b.bytes()[:btfHeaderSize+5], binary.LittleEndian)
+	assert.Error(t, err)
+}
+
+func TestStructLayout(t *testing.T) {
+	testCases := []struct {
+		name     string
+		build    func(b *btfBuilder) uint32
+		expected []string
+	}{
+		{
+			name: "padding",
+			build: func(b *btfBuilder) uint32 {
+				charID := b.intType("char", 1, btfIntSigned|btfIntChar)
+				u64ID := b.intType("unsigned long long", 8, 0)
+				arrID := b.add("", btfKindArray, 0, false, 0, charID, charID, 3)
+				return b.structType("event", 24,
+					btfMember{name: "comm", typeID: arrID, bitOffset: 0},
+					btfMember{name: "ts_ns", typeID: u64ID, bitOffset: 64},
+				)
+			},
+			expected: []string{"type TestEvent struct", "Comm [3]int8", "_ [5]byte", "TsNs uint64", "_ [24]byte = [unsafe.Sizeof(TestEvent{})]byte{}"},
+		},
+		{
+			name: "bitfields",
+			build: func(b *btfBuilder) uint32 {
+				u32ID := b.intType("unsigned int", 4, 0)
+				return b.structType("flags", 8,
+					btfMember{name: "a", typeID: u32ID, bitOffset: 0, bitSize: 3},
+					btfMember{name: "b", typeID: u32ID, bitOffset: 3, bitSize: 5},
+					btfMember{name: "c", typeID: u32ID, bitOffset: 32},
+				)
+			},
+			expected: []string{"_ [4]byte", "C uint32"},
+		},
+		{
+			name: "packed",
+			build: func(b *btfBuilder) uint32 {
+				u8ID := b.intType("unsigned char", 1, 0)
+				u32ID := b.intType("unsigned int", 4, 0)
+				return b.structType("packed", 5,
+					btfMember{name: "a", typeID: u8ID, bitOffset: 0},
+					btfMember{name: "b", typeID: u32ID, bitOffset: 8},
+				)
+			},
+			expected: []string{"A uint8", "B [4]byte"},
+		},
+	}
+
+	for _, tc := range testCases {
+		t.Run(tc.name, func(t *testing.T) {
+			b := newBTFBuilder()
+			id := tc.build(b)
+			spec, err := parseBTF(b.bytes(), binary.LittleEndian)
+			require.NoError(t, err)
+
+			g := &generator{
+				args:  genArgs{ident: "Test"},
+				spec:  spec,
+				named: make(map[uint32]string),
+			}
+			_, err = g.goTypeOf(id)
+			require.NoError(t, err)
+
+			decls := g.decls.String() + strings.Join(g.sizes, "\n")
+			for _, expected := range tc.expected {
+				assert.Contains(t, decls, expected)
+			}
+		})
+	}
+}
+
+func TestExportName(t *testing.T) {
+	assert.Equal(t, "EventT", exportName("event_t"))
+	assert.Equal(t, "Rodata", exportName("rodata"))
+	assert.Equal(t, "HandleExecve", exportName("handle_execve"))
+	assert.Equal(t, "X", exportName("_"))
+}
+
+// libbpfgoStub declares the parts of libbpfgo the generated code uses, to
+// type check it without cgo.
+const libbpfgoStub = `package libbpfgo
+
+import "unsafe"
+
+type Module struct{}
+type BPFMap struct{}
+type BPFProg struct{}
+type BPFObjectIterator struct{}
+
+func (m *Module) Iterator() *BPFObjectIterator { return nil }
+func (m *Module) GetMap(name string) (*BPFMap, error) { return nil, nil }
+func (m *Module) GetProgram(name string) (*BPFProg, error) { return nil, nil }
+func (it *BPFObjectIterator) NextMap() *BPFMap { return nil }
+func (it *BPFObjectIterator) NextProgram() *BPFProg { return nil }
+func (b *BPFMap) Name() string { return "" }
+func (b *BPFMap) GetValue(key unsafe.Pointer) ([]byte, error) { return nil, nil }
+func (b *BPFMap) Update(key, value unsafe.Pointer) error { return nil }
+func (p *BPFProg) Name() string { return "" }
+`
+
+type stubImporter struct {
+	fset *token.FileSet
+	std  types.Importer
+	bpf  *types.Package
+}
+
+func (i *stubImporter) Import(path string) (*types.Package, error) {
+	if path != "github.com/khulnasoft-lab/libbpfgo" {
+		return i.std.Import(path)
+	}
+	if i.bpf == nil {
+		f, err := parser.ParseFile(i.fset, "libbpfgo.go", libbpfgoStub, 0)
+		if err != nil {
+			return nil, err
+		}
+		conf := types.Config{Importer: i.std}
+		if i.bpf, err = conf.Check(path, i.fset, []*ast.File{f}, nil); err != nil {
+			return nil, err
+		}
+	}
+
+	return i.bpf, nil
+}
+
+func TestGeneratedSourceCompiles(t *testing.T) {
+	fset := token.NewFileSet()
+	imp := &stubImporter{fset: fset, std: importer.ForCompiler(fset, "source", nil)}
+
+	testCases := []struct {
+		name       string
+		typedMaps  bool
+		decoders   []string
+		usesUnsafe bool
+	}{
+		{name: "typed maps", typedMaps: true, usesUnsafe: true},
+		{name: "typed maps and decoders", typedMaps: true, decoders: []string{"event"}, usesUnsafe: true},
+		{name: "untyped maps"},
+	}
+
+	for _, tc := range testCases {
+		t.Run(tc.name, func(t *testing.T) {
+			b := newBTFBuilder()
+			u32ID := b.intType("unsigned int", 4, 0)
+			u64ID := b.intType("unsigned long long", 8, 0)
+			b.structType("event", 16,
+				btfMember{name: "pid", typeID: u32ID, bitOffset: 0},
+				btfMember{name: "ts", typeID: u64ID, bitOffset: 64},
+			)
+			spec, err := parseBTF(b.bytes(), binary.LittleEndian)
+			require.NoError(t, err)
+
+			g := &generator{
+				args:  genArgs{objName: "main.bpf.o", pkg: "main", ident: "Main", types: tc.decoders},
+				spec:  spec,
+				named: make(map[uint32]string),
+			}
+			counts := mapSpec{name: "counts", mapType: 1}
+			if tc.typedMaps {
+				counts.keyType, counts.valueType = u32ID, u64ID
+			}
+			src, err := g.source([]mapSpec{counts}, []string{"handle_execve"})
+			require.NoError(t, err)
+
+			f, err := parser.ParseFile(fset, "main_bpf.go", src, 0)
+			require.NoError(t, err)
+			conf := types.Config{Importer: imp}
+			_, err = conf.Check("main", fset, []*ast.File{f}, nil)
+			assert.NoError(t, err, "%s", src)
+			assert.Equal(t, tc.usesUnsafe, bytes.Contains(src, []byte(`"unsafe"`)), "%s", src)
+		})
+	}
+}
+
+// elfSym is a symbol of the test objects built by buildELF.
+type elfSym struct {
+	name    string
+	section uint16 // 1 is .text, 2 is xdp
+	typ     elf.SymType
+	bind    elf.SymBind
+}
+
+// buildELF assembles a little endian BPF relocatable object holding a .text
+// and an xdp section, and the given symbols.
+func buildELF(t *testing.T, syms []elfSym) *elf.File {
+	var shstrtab, strtab bytes.Buffer
+	addStr := func(buf *bytes.Buffer, s string) uint32 {
+		off := uint32(buf.Len())
+		buf.WriteString(s)
+		buf.WriteByte(0)
+		return off
+	}
+	addStr(&shstrtab, "")
+	addStr(&strtab, "")
+
+	var symtab bytes.Buffer
+	require.NoError(t, binary.Write(&symtab, binary.LittleEndian, elf.Sym64{}))
+	for _, sym := range syms {
+		require.NoError(t, binary.Write(&symtab, binary.LittleEndian, elf.Sym64{
+			Name:  addStr(&strtab, sym.name),
+			Info:  elf.ST_INFO(sym.bind, sym.typ),
+			Shndx: sym.section,
+		}))
+	}
+
+	code := make([]byte, 8)
+	sections := []struct {
+		name    string
+		typ     elf.SectionType
+		flags   elf.SectionFlag
+		data    []byte
+		link    uint32
+		entsize uint64
+	}{
+		{name: ".text", typ: elf.SHT_PROGBITS, flags: elf.SHF_ALLOC | elf.SHF_EXECINSTR, data: code},
+		{name: "xdp", typ: elf.SHT_PROGBITS, flags: elf.SHF_ALLOC | elf.SHF_EXECINSTR, data: code},
+		{name: ".symtab", typ: elf.SHT_SYMTAB, data: symtab.Bytes(), link: 4, entsize: 24},
+		{name: ".strtab", typ: elf.SHT_STRTAB, data: strtab.Bytes()},
+		{name: ".shstrtab", typ: elf.SHT_STRTAB},
+	}
+
+	var data bytes.Buffer
+	headers := []elf.Section64{{}}
+	for i, sec := range sections {
+		nameOff := addStr(&shstrtab, sec.name)
+		if i == len(sections)-1 {
+			sec.data = shstrtab.Bytes()
+		}
+		headers = append(headers, elf.Section64{
+			Name:      nameOff,
+			Type:      uint32(sec.typ),
+			Flags:     uint64(sec.flags),
+			Off:       uint64(64 + data.Len()),
+			Size:      uint64(len(sec.data)),
+			Link:      sec.link,
+			Addralign: 1,
+			Entsize:   sec.entsize,
+		})
+		data.Write(sec.data)
+	}
+
+	hdr := elf.Header64{
+		Type:      uint16(elf.ET_REL),
+		Machine:   uint16(elf.EM_BPF),
+		Version:   uint32(elf.EV_CURRENT),
+		Shoff:     uint64(64 + data.Len()),
+		Ehsize:    64,
+		Shentsize: 64,
+		Shnum:     uint16(len(headers)),
+		Shstrndx:  uint16(len(headers) - 1),
+	}
+	copy(hdr.Ident[:], elf.ELFMAG)
+	hdr.Ident[elf.EI_CLASS] = byte(elf.ELFCLASS64)
+	hdr.Ident[elf.EI_DATA] = byte(elf.ELFDATA2LSB)
+	hdr.Ident[elf.EI_VERSION] = byte(elf.EV_CURRENT)
+
+	var obj bytes.Buffer
+	require.NoError(t, binary.Write(&obj, binary.LittleEndian, hdr))
+	obj.Write(data.Bytes())
+	for _, sh := range headers {
+		require.NoError(t, binary.Write(&obj, binary.LittleEndian, sh))
+	}
+
+	f, err := elf.NewFile(bytes.NewReader(obj.Bytes()))
+	require.NoError(t, err)
+
+	return f
+}
+
+func TestPrograms(t *testing.T) {
+	f := buildELF(t, []elfSym{
+		{name: "global_prog", section: 2, typ: elf.STT_FUNC, bind: elf.STB_GLOBAL},
+		{name: "static_prog", section: 2, typ: elf.STT_FUNC, bind: elf.STB_LOCAL},
+		{name: "weak_prog", section: 2, typ: elf.STT_FUNC, bind: elf.STB_WEAK},
+		{name: "subprog", section: 1, typ: elf.STT_FUNC, bind: elf.STB_GLOBAL},
+		{name: "label", section: 2, typ: elf.STT_NOTYPE, bind: elf.STB_LOCAL},
+	})
+
+	progs, err := programs(f)
+	require.NoError(t, err)
+	assert.Equal(t, []string{"global_prog", "static_prog", "weak_prog"}, progs)
+}
@@ -0,0 +1,101 @@
+// Command libbpfgo-gen generates typed Go bindings for a BPF object file,
+// similar to the skeletons generated by bpftool for C programs.
+//
+// From the object BTF it generates:
+//
+//   - a <Ident>Objects struct holding all the maps and programs, resolved in a
+//     single pass by New<Ident>Objects(module);
+//   - Go types mirroring the key and value types of each map, together with
+//     typed Lookup and Update accessors;
+//   - Go types mirroring the global variable sections (.rodata, .data, .bss and
+//     custom .data.* and .rodata.* sections), with accessors to set their
+//     initial values before load and to read (and write) them after load;
+//   - Decode functions for the extra types given with -type, e.g. the events
+//     sent through ring or perf buffers.
+//
+// Typical usage, next to the Go code loading the object:
+//
+//	//go:generate go run github.com/khulnasoft-lab/libbpfgo/cmd/libbpfgo-gen -obj main.bpf.o -type event -out main_bpf.go
+//
+// Generated struct layouts match the C ones, with explicit padding, and are
+// checked at compile time. Bitfields are left as padding and unions as byte
+// arrays.
+package main
+
+import (
+	"debug/elf"
+	"flag"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+)
+
+func main() {
+	if err := run(); err != nil {
+		fmt.Fprintln(os.Stderr, "libbpfgo-gen:", err)
+		os.Exit(1)
+	}
+}
+
+func run() error {
+	obj := flag.String("obj", "", "BPF object file (required)")
+	pkg := flag.String("pkg", "main", "package of the generated file")
+	out := flag.String("out", "", "output file (default stdout)")
+	ident := flag.String("ident", "", "prefix of the generated identifiers (default derived from the object name)")
+	types := flag.String("type", "", "comma separated BTF types to generate decoders for")
+	flag.Parse()
+
+	if *obj == "" {
+		flag.Usage()
+		return fmt.Errorf("-obj is required")
+	}
+
+	args := genArgs{
+		objName: filepath.Base(*obj),
+		pkg:     *pkg,
+		ident:   *ident,
+	}
+	if args.ident == "" {
+		stem := strings.TrimSuffix(args.objName, ".o")
+		stem = strings.TrimSuffix(stem, ".bpf")
+		args.ident = exportName(strings.NewReplacer("-", "_", ".", "_").Replace(stem))
+	}
+	if *types != "" {
+		args.types = strings.Split(*types, ",")
+	}
+
+	src, err := generateFile(*obj, args)
+	if err != nil {
+		return err
+	}
+
+	if *out == "" {
+		_, err = os.Stdout.Write(src)
+		return err
+	}
+
+	return os.WriteFile(*out, src, 0644)
+}
+
+func generateFile(path string, args genArgs) ([]byte, error) {
+	f, err := elf.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to open %s: %w", path, err)
+	}
+	defer f.Close()
+
+	if f.Machine != elf.EM_BPF {
+		return nil, fmt.Errorf("%s is not a BPF object", path)
+	}
+
+	spec, err := loadBTF(f)
+	if err != nil {
+		return nil, fmt.Errorf("%s: %w", path, err)
+	}
+	if err := spec.fixupDatasecs(f); err != nil {
+		return nil, fmt.Errorf("%s: %w", path, err)
+	}
+
+	return generate(f, spec, args)
+}
@@ -0,0 +1,73 @@
+// Command libbpfgo-loader records the loading of a BPF object into a loader
+// blob, to be embedded in the application and loaded with
+// libbpfgo.NewModuleFromLoaderBlob. Loading a blob skips the ELF and BTF
+// parsing and the CO-RE relocations of the regular path, which is what
+// dominates the startup time of small programs.
+//
+// It doesn't load anything into the kernel, so it runs unprivileged as a
+// build step:
+//
+//	//go:generate go run github.com/khulnasoft-lab/libbpfgo/cmd/libbpfgo-loader -obj main.bpf.o -out main.bpf.lskel
+//
+// Like any libbpfgo program, it must be built against libbpf (CGO_CFLAGS and
+// CGO_LDFLAGS).
+package main
+
+import (
+	"flag"
+	"fmt"
+	"os"
+	"strings"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func main() {
+	if err := run(); err != nil {
+		fmt.Fprintln(os.Stderr, "libbpfgo-loader:", err)
+		os.Exit(1)
+	}
+}
+
+func run() error {
+	obj := flag.String("obj", "", "BPF object file (required)")
+	out := flag.String("out", "", "output file (default <obj>.lskel)")
+	noAutoload := flag.String("no-autoload", "", "comma separated programs not to load")
+	flag.Parse()
+
+	if *obj == "" {
+		flag.Usage()
+		return fmt.Errorf("-obj is required")
+	}
+	if *out == "" {
+		*out = strings.TrimSuffix(*obj, ".o") + ".lskel"
+	}
+
+	module, err := bpf.NewModuleFromFileArgs(bpf.NewModuleArgs{
+		BPFObjPath:      *obj,
+		SkipMemlockBump: true,
+	})
+	if err != nil {
+		return err
+	}
+	defer module.Close()
+
+	if *noAutoload != "" {
+		for _, name := range strings.Split(*noAutoload, ",") {
+			prog, err := module.GetProgram(name)
+			if err != nil {
+				return err
+			}
+			if err := prog.SetAutoload(false); err != nil {
+				return err
+			}
+		}
+	}
+
+	blob, err := module.GenerateLoaderBlob()
+	if err != nil {
+		return err
+	}
+
+	return os.WriteFile(*out, blob, 0644)
+}
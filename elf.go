@@ -1,6 +1,7 @@
 package libbpfgo
 
 import (
+	"bytes"
 	"debug/elf"
 	"encoding/binary"
 	"errors"
@@ -16,37 +17,68 @@ type Symbol struct {
 	byteOrder   binary.ByteOrder
 }
 
-func getGlobalVariableSymbol(e *elf.File, varName string) (*Symbol, error) {
+// getGlobalVariableSymbols indexes by name the symbols of the global variable
+// sections.
+func getGlobalVariableSymbols(e *elf.File) (map[string]Symbol, error) {
 	regularSymbols, err := e.Symbols()
 	if err != nil {
 		return nil, err
 	}
 
-	var symbols []Symbol
+	symbols := make(map[string]Symbol)
 	for _, s := range regularSymbols {
 		i := int(s.Section)
 		if i >= len(e.Sections) {
 			continue
 		}
 		sectionName := e.Sections[i].Name
-		if isGlobalVariableSection(sectionName) {
-			symbols = append(symbols, Symbol{
-				name:        s.Name,
-				size:        int(s.Size),
-				offset:      int(s.Value),
-				sectionName: sectionName,
-				byteOrder:   e.ByteOrder,
-			})
+		if !isGlobalVariableSection(sectionName) {
+			continue
+		}
+		if _, ok := symbols[s.Name]; ok {
+			continue // first one wins, as in a linear search
+		}
+		symbols[s.Name] = Symbol{
+			name:        s.Name,
+			size:        int(s.Size),
+			offset:      int(s.Value),
+			sectionName: sectionName,
+			byteOrder:   e.ByteOrder,
 		}
 	}
 
-	for _, s := range symbols {
-		if s.name == varName {
-			return &s, nil
+	return symbols, nil
+}
+
+// globalVariableSymbol looks up a global variable symbol of the module
+// object. The object ELF is only parsed by the first lookup, since most
+// modules don't initialize global variables.
+func (m *Module) globalVariableSymbol(varName string) (*Symbol, error) {
+	if m.globalSymbols == nil {
+		var e *elf.File
+		var err error
+		if m.objBuff != nil {
+			e, err = elf.NewFile(bytes.NewReader(m.objBuff))
+		} else {
+			e, err = elf.Open(m.objPath)
 		}
+		if err != nil {
+			return nil, err
+		}
+		defer e.Close()
+
+		m.globalSymbols, err = getGlobalVariableSymbols(e)
+		if err != nil {
+			return nil, err
+		}
+	}
+
+	s, ok := m.globalSymbols[varName]
+	if !ok {
+		return nil, errors.New("symbol not found")
 	}
 
-	return nil, errors.New("symbol not found")
+	return &s, nil
 }
 
 func isGlobalVariableSection(sectionName string) bool {
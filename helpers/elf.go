@@ -1,17 +1,53 @@
 package helpers
 
 import (
+	"bytes"
 	"debug/elf"
+	"encoding/binary"
+	"encoding/hex"
 	"errors"
 	"fmt"
+	"sort"
 )
 
 // SymbolToOffset attempts to resolve a 'symbol' name in the binary found at
-// 'path' to an offset. The offset can be used for attaching a u(ret)probe
+// 'path' to an offset. The offset can be used for attaching a u(ret)probe.
+//
+// The binary symbols are indexed once and cached (see ELFSymbolCache).
 func SymbolToOffset(path, symbol string) (uint32, error) {
+	return defaultELFSymbolCache.SymbolToOffset(path, symbol)
+}
+
+//
+// ELFSymbolIndex
+//
+
+// ELFSymbol is a symbol of an ELF binary.
+type ELFSymbol struct {
+	Name  string
+	Value uint64
+	Size  uint64
+	// Offset is the file offset of the symbol, if it is in an executable
+	// section.
+	Offset uint64
+	// Executable tells whether the symbol is in an executable section.
+	Executable bool
+}
+
+// ELFSymbolIndex indexes the symbols of an ELF binary, regular and dynamic,
+// by name and by address.
+type ELFSymbolIndex struct {
+	byName  []ELFSymbol // sorted by name, first occurrence of each name
+	byAddr  []int       // byName indexes of the sized executable symbols, sorted by value
+	loads   []elf.ProgHeader
+	buildID string
+}
+
+// NewELFSymbolIndex parses the symbols of the binary at path.
+func NewELFSymbolIndex(path string) (*ELFSymbolIndex, error) {
 	f, err := elf.Open(path)
 	if err != nil {
-		return 0, fmt.Errorf("could not open elf file to resolve symbol offset: %w", err)
+		return nil, fmt.Errorf("could not open elf file to resolve symbol offset: %w", err)
 	}
 	defer f.Close()
 
@@ -20,41 +56,239 @@ func SymbolToOffset(path, symbol string) (uint32, error) {
 
 	// Only if we failed getting both regular and dynamic symbols - then we abort.
 	if regularSymbolsErr != nil && dynamicSymbolsErr != nil {
-		return 0, fmt.Errorf("could not open regular or dynamic symbol sections to resolve symbol offset: %w %s", regularSymbolsErr, dynamicSymbolsErr)
+		return nil, fmt.Errorf("could not open regular or dynamic symbol sections to resolve symbol offset: %w %s", regularSymbolsErr, dynamicSymbolsErr)
+	}
+
+	var execSections []*elf.Section
+	for _, s := range f.Sections {
+		if s.Flags == elf.SHF_ALLOC+elf.SHF_EXECINSTR {
+			execSections = append(execSections, s)
+		}
 	}
 
-	// Concatenating into a single list.
-	// The list can have duplications, but we will find the first occurrence which is sufficient.
+	// The lists can have duplications: the first occurrence is kept, regular
+	// symbols first.
 	syms := append(regularSymbols, dynamicSymbols...)
+	index := &ELFSymbolIndex{
+		byName:  make([]ELFSymbol, 0, len(syms)),
+		buildID: readBuildID(f),
+	}
+	for _, prog := range f.Progs {
+		if prog.Type == elf.PT_LOAD && prog.Flags&elf.PF_X != 0 {
+			index.loads = append(index.loads, prog.ProgHeader)
+		}
+	}
+	seen := make(map[string]bool, len(syms))
+	for _, s := range syms {
+		if s.Name == "" || seen[s.Name] {
+			continue
+		}
+		seen[s.Name] = true
 
-	sectionsToSearchForSymbol := []*elf.Section{}
+		sym := ELFSymbol{
+			Name:  s.Name,
+			Value: s.Value,
+			Size:  s.Size,
+		}
+		for _, section := range execSections {
+			if s.Value >= section.Addr && s.Value < section.Addr+section.Size {
+				sym.Offset = s.Value - section.Addr + section.Offset
+				sym.Executable = true
+				break
+			}
+		}
+		index.byName = append(index.byName, sym)
+	}
 
-	for i := range f.Sections {
-		if f.Sections[i].Flags == elf.SHF_ALLOC+elf.SHF_EXECINSTR {
-			sectionsToSearchForSymbol = append(sectionsToSearchForSymbol, f.Sections[i])
+	sort.Slice(index.byName, func(i, j int) bool {
+		return index.byName[i].Name < index.byName[j].Name
+	})
+	for i, sym := range index.byName {
+		if sym.Executable && sym.Size > 0 {
+			index.byAddr = append(index.byAddr, i)
 		}
 	}
+	sort.Slice(index.byAddr, func(i, j int) bool {
+		return index.byName[index.byAddr[i]].Value < index.byName[index.byAddr[j]].Value
+	})
 
-	var executableSection *elf.Section
+	return index, nil
+}
 
-	for j := range syms {
-		if syms[j].Name == symbol {
-			// Find what section the symbol is in by checking the executable section's
-			// addr space.
-			for m := range sectionsToSearchForSymbol {
-				if syms[j].Value > sectionsToSearchForSymbol[m].Addr &&
-					syms[j].Value < sectionsToSearchForSymbol[m].Addr+sectionsToSearchForSymbol[m].Size {
-					executableSection = sectionsToSearchForSymbol[m]
-				}
-			}
+// Lookup returns the symbol with the given name.
+func (i *ELFSymbolIndex) Lookup(name string) (*ELFSymbol, bool) {
+	n := sort.Search(len(i.byName), func(j int) bool {
+		return i.byName[j].Name >= name
+	})
+	if n == len(i.byName) || i.byName[n].Name != name {
+		return nil, false
+	}
 
-			if executableSection == nil {
-				return 0, errors.New("could not find symbol in executable sections of binary")
-			}
+	return &i.byName[n], true
+}
+
+// SymbolToOffset resolves the symbol name to an offset, which can be used for
+// attaching a u(ret)probe.
+func (i *ELFSymbolIndex) SymbolToOffset(name string) (uint32, error) {
+	sym, ok := i.Lookup(name)
+	if !ok {
+		return 0, fmt.Errorf("symbol %s not found", name)
+	}
+	if !sym.Executable {
+		return 0, errors.New("could not find symbol in executable sections of binary")
+	}
+
+	return uint32(sym.Offset), nil
+}
+
+// SymbolAt returns the executable symbol whose address range contains addr.
+func (i *ELFSymbolIndex) SymbolAt(addr uint64) (*ELFSymbol, bool) {
+	// first symbol after addr
+	n := sort.Search(len(i.byAddr), func(j int) bool {
+		return i.byName[i.byAddr[j]].Value > addr
+	})
+	if n == 0 {
+		return nil, false
+	}
 
-			return uint32(syms[j].Value - executableSection.Addr + executableSection.Offset), nil
+	sym := &i.byName[i.byAddr[n-1]]
+	if addr >= sym.Value+sym.Size {
+		return nil, false
+	}
+
+	return sym, true
+}
+
+// SymbolAtOffset returns the executable symbol containing the file offset,
+// as found in process mappings and build ID stack traces.
+func (i *ELFSymbolIndex) SymbolAtOffset(offset uint64) (*ELFSymbol, bool) {
+	for _, load := range i.loads {
+		if offset >= load.Off && offset < load.Off+load.Filesz {
+			return i.SymbolAt(offset - load.Off + load.Vaddr)
 		}
 	}
 
-	return 0, fmt.Errorf("symbol %s not found in %s", symbol, path)
+	return nil, false
+}
+
+// BuildID returns the GNU build ID of the binary, in hex, if it has one.
+func (i *ELFSymbolIndex) BuildID() string {
+	return i.buildID
+}
+
+// Len returns the number of indexed symbols.
+func (i *ELFSymbolIndex) Len() int {
+	return len(i.byName)
+}
+
+// ntGNUBuildID is the type of the build ID note.
+const ntGNUBuildID = 3
+
+func readBuildID(f *elf.File) string {
+	section := f.Section(".note.gnu.build-id")
+	if section == nil {
+		return ""
+	}
+	data, err := section.Data()
+	if err != nil {
+		return ""
+	}
+
+	var buildID string
+	_ = forEachELFNote(data, f.ByteOrder, func(name string, noteType uint32, desc []byte) bool {
+		if noteType == ntGNUBuildID && name == "GNU" {
+			buildID = hex.EncodeToString(desc)
+			return false
+		}
+		return true
+	})
+
+	return buildID
+}
+
+// forEachELFNote calls fn with the name, type and descriptor of each note of
+// a note section, until fn returns false. It fails on truncated notes.
+func forEachELFNote(data []byte, order binary.ByteOrder, fn func(name string, noteType uint32, desc []byte) bool) error {
+	// note header: name size, descriptor size and type, then the name and
+	// the descriptor, both 4 bytes aligned
+	for len(data) > 0 {
+		if len(data) < 12 {
+			return errors.New("truncated note header")
+		}
+		nameSize := uint64(order.Uint32(data[0:4]))
+		descSize := uint64(order.Uint32(data[4:8]))
+		noteType := order.Uint32(data[8:12])
+		nameEnd := 12 + alignNote(nameSize)
+		descEnd := nameEnd + alignNote(descSize)
+		if uint64(len(data)) < descEnd {
+			return errors.New("truncated note")
+		}
+		name := bytes.TrimRight(data[12:12+nameSize], "\x00")
+		desc := data[nameEnd : nameEnd+descSize]
+		data = data[descEnd:]
+
+		if !fn(string(name), noteType, desc) {
+			return nil
+		}
+	}
+
+	return nil
+}
+
+func alignNote(size uint64) uint64 {
+	return (size + 3) &^ 3
+}
+
+//
+// ELFSymbolCache
+//
+
+var defaultELFSymbolCache = NewELFSymbolCache(64)
+
+// ELFSymbolCache caches the symbol indexes of the most recently used
+// binaries. Binaries are identified by device, inode, modification time and
+// size, so a replaced binary is indexed again. It is safe for concurrent use,
+// and each binary is parsed once even when queried concurrently.
+type ELFSymbolCache struct {
+	files *fileCache
+}
+
+// NewELFSymbolCache creates a cache of at most capacity binaries.
+func NewELFSymbolCache(capacity int) *ELFSymbolCache {
+	return &ELFSymbolCache{
+		files: newFileCache(capacity, func(path string) (interface{}, error) {
+			return NewELFSymbolIndex(path)
+		}),
+	}
+}
+
+// Index returns the symbol index of the binary at path.
+func (c *ELFSymbolCache) Index(path string) (*ELFSymbolIndex, error) {
+	index, err := c.files.get(path)
+	if err != nil {
+		return nil, err
+	}
+
+	return index.(*ELFSymbolIndex), nil
+}
+
+// SymbolToOffset resolves the symbol name of the binary at path to an offset,
+// which can be used for attaching a u(ret)probe.
+func (c *ELFSymbolCache) SymbolToOffset(path, symbol string) (uint32, error) {
+	index, err := c.Index(path)
+	if err != nil {
+		return 0, err
+	}
+
+	offset, err := index.SymbolToOffset(symbol)
+	if err != nil {
+		return 0, fmt.Errorf("%w in %s", err, path)
+	}
+
+	return offset, nil
+}
+
+// Len returns the number of cached binaries.
+func (c *ELFSymbolCache) Len() int {
+	return c.files.len()
 }
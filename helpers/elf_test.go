@@ -0,0 +1,126 @@
+package helpers
+
+import (
+	"debug/elf"
+	"io"
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+// testSymbol is a function exported by libc.
+const testSymbol = "getpid"
+
+// libcPath returns the path of the host libc, skipping the test if there is
+// none (Go test binaries are stripped, so they can't be used instead).
+func libcPath(t *testing.T) string {
+	for _, pattern := range []string{
+		"/lib/*-linux-gnu/libc.so.6",
+		"/usr/lib/*-linux-gnu/libc.so.6",
+		"/lib64/libc.so.6",
+		"/usr/lib64/libc.so.6",
+		"/usr/lib/libc.so.6",
+		"/lib/ld-musl-*.so.1",
+	} {
+		if matches, _ := filepath.Glob(pattern); len(matches) > 0 {
+			return matches[0]
+		}
+	}
+	t.Skip("libc not found")
+	return ""
+}
+
+func TestELFSymbolIndex(t *testing.T) {
+	path := libcPath(t)
+
+	index, err := NewELFSymbolIndex(path)
+	require.NoError(t, err)
+	require.NotZero(t, index.Len())
+
+	f, err := elf.Open(path)
+	require.NoError(t, err)
+	defer f.Close()
+
+	sym, ok := index.Lookup(testSymbol)
+	require.True(t, ok)
+	assert.True(t, sym.Executable)
+
+	var text *elf.Section
+	for _, s := range f.Sections {
+		if s.Flags&elf.SHF_EXECINSTR != 0 && sym.Value >= s.Addr && sym.Value < s.Addr+s.Size {
+			text = s
+		}
+	}
+	require.NotNil(t, text)
+
+	offset, err := index.SymbolToOffset(testSymbol)
+	require.NoError(t, err)
+	assert.Equal(t, uint32(sym.Value-text.Addr+text.Offset), offset)
+
+	at, ok := index.SymbolAt(sym.Value + sym.Size/2)
+	require.True(t, ok)
+	assert.Equal(t, testSymbol, at.Name)
+	at, ok = index.SymbolAtOffset(uint64(offset) + sym.Size/2)
+	require.True(t, ok)
+	assert.Equal(t, testSymbol, at.Name)
+
+	if f.Section(".note.gnu.build-id") != nil {
+		assert.NotEmpty(t, index.BuildID())
+	}
+
+	_, ok = index.Lookup("no_such_symbol")
+	assert.False(t, ok)
+	_, err = index.SymbolToOffset("no_such_symbol")
+	assert.Error(t, err)
+	_, ok = index.SymbolAt(0)
+	assert.False(t, ok)
+}
+
+func TestELFSymbolCache(t *testing.T) {
+	path := libcPath(t)
+
+	// a copy is a different binary
+	copyPath := filepath.Join(t.TempDir(), "copy")
+	src, err := os.Open(path)
+	require.NoError(t, err)
+	defer src.Close()
+	dst, err := os.Create(copyPath)
+	require.NoError(t, err)
+	_, err = io.Copy(dst, src)
+	require.NoError(t, err)
+	require.NoError(t, dst.Close())
+
+	cache := NewELFSymbolCache(1)
+
+	var wg sync.WaitGroup
+	indexes := make([]*ELFSymbolIndex, 4)
+	for i := range indexes {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			indexes[i], _ = cache.Index(path)
+		}(i)
+	}
+	wg.Wait()
+	for _, index := range indexes {
+		assert.Same(t, indexes[0], index)
+	}
+
+	copyIndex, err := cache.Index(copyPath)
+	require.NoError(t, err)
+	assert.NotSame(t, indexes[0], copyIndex)
+	assert.Equal(t, 1, cache.Len())
+
+	offset, err := cache.SymbolToOffset(path, testSymbol)
+	require.NoError(t, err)
+	expected, err := indexes[0].SymbolToOffset(testSymbol)
+	require.NoError(t, err)
+	assert.Equal(t, expected, offset)
+
+	_, err = cache.Index(filepath.Join(t.TempDir(), "missing"))
+	assert.Error(t, err)
+}
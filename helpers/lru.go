@@ -0,0 +1,151 @@
+package helpers
+
+import (
+	"container/list"
+	"os"
+	"sync"
+	"syscall"
+)
+
+//
+// LRU cache
+//
+
+type lruEntry struct {
+	key   interface{}
+	value interface{}
+}
+
+// lruCache is a cache of at most capacity entries, evicting the least
+// recently used ones. It isn't safe for concurrent use.
+type lruCache struct {
+	capacity int
+	lru      *list.List // of *lruEntry, most recently used first
+	entries  map[interface{}]*list.Element
+}
+
+func newLRUCache(capacity int) *lruCache {
+	return &lruCache{
+		capacity: capacity,
+		lru:      list.New(),
+		entries:  make(map[interface{}]*list.Element),
+	}
+}
+
+func (c *lruCache) get(key interface{}) (interface{}, bool) {
+	elem, ok := c.entries[key]
+	if !ok {
+		return nil, false
+	}
+	c.lru.MoveToFront(elem)
+
+	return elem.Value.(*lruEntry).value, true
+}
+
+func (c *lruCache) add(key, value interface{}) {
+	if elem, ok := c.entries[key]; ok {
+		elem.Value.(*lruEntry).value = value
+		c.lru.MoveToFront(elem)
+		return
+	}
+	c.entries[key] = c.lru.PushFront(&lruEntry{key, value})
+	if c.lru.Len() > c.capacity {
+		oldest := c.lru.Back()
+		c.lru.Remove(oldest)
+		delete(c.entries, oldest.Value.(*lruEntry).key)
+	}
+}
+
+func (c *lruCache) remove(key interface{}) {
+	if elem, ok := c.entries[key]; ok {
+		c.lru.Remove(elem)
+		delete(c.entries, key)
+	}
+}
+
+func (c *lruCache) len() int {
+	return c.lru.Len()
+}
+
+//
+// File cache
+//
+
+// fileKey identifies a file version: a replaced or modified file gets
+// another key.
+type fileKey struct {
+	dev   uint64
+	ino   uint64
+	mtime int64
+	size  int64
+}
+
+type fileCacheEntry struct {
+	once  sync.Once
+	value interface{}
+	err   error
+}
+
+// fileCache caches what read returns for the most recently used files. It is
+// safe for concurrent use, and each file is read once even when queried
+// concurrently. Failures aren't cached.
+type fileCache struct {
+	mu    sync.Mutex
+	files *lruCache // fileKey to *fileCacheEntry
+	read  func(path string) (interface{}, error)
+}
+
+func newFileCache(capacity int, read func(path string) (interface{}, error)) *fileCache {
+	if capacity < 1 {
+		capacity = 1
+	}
+
+	return &fileCache{
+		files: newLRUCache(capacity),
+		read:  read,
+	}
+}
+
+func (c *fileCache) get(path string) (interface{}, error) {
+	info, err := os.Stat(path)
+	if err != nil {
+		return nil, err
+	}
+	key := fileKey{
+		mtime: info.ModTime().UnixNano(),
+		size:  info.Size(),
+	}
+	if stat, ok := info.Sys().(*syscall.Stat_t); ok {
+		key.dev = uint64(stat.Dev)
+		key.ino = uint64(stat.Ino)
+	}
+
+	c.mu.Lock()
+	value, ok := c.files.get(key)
+	if !ok {
+		value = &fileCacheEntry{}
+		c.files.add(key, value)
+	}
+	entry := value.(*fileCacheEntry)
+	c.mu.Unlock()
+
+	entry.once.Do(func() {
+		entry.value, entry.err = c.read(path)
+	})
+	if entry.err != nil {
+		c.mu.Lock()
+		if value, ok := c.files.get(key); ok && value == entry {
+			c.files.remove(key)
+		}
+		c.mu.Unlock()
+	}
+
+	return entry.value, entry.err
+}
+
+func (c *fileCache) len() int {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	return c.files.len()
+}
@@ -0,0 +1,88 @@
+package helpers
+
+import (
+	"errors"
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestLRUCache(t *testing.T) {
+	c := newLRUCache(2)
+	c.add(1, "a")
+	c.add(2, "b")
+	_, ok := c.get(1)
+	assert.True(t, ok)
+	c.add(3, "c") // evicts 2
+
+	_, ok = c.get(2)
+	assert.False(t, ok)
+	v, ok := c.get(1)
+	assert.True(t, ok)
+	assert.Equal(t, "a", v)
+	assert.Equal(t, 2, c.len())
+
+	c.remove(1)
+	assert.Equal(t, 1, c.len())
+}
+
+func TestFileCache(t *testing.T) {
+	dir := t.TempDir()
+	path := filepath.Join(dir, "file")
+	require.NoError(t, os.WriteFile(path, []byte("v1"), 0600))
+
+	var mu sync.Mutex
+	reads := 0
+	fail := false
+	c := newFileCache(1, func(path string) (interface{}, error) {
+		mu.Lock()
+		defer mu.Unlock()
+		reads++
+		if fail {
+			return nil, errors.New("read failure")
+		}
+		return os.ReadFile(path)
+	})
+
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			value, err := c.get(path)
+			assert.NoError(t, err)
+			assert.Equal(t, []byte("v1"), value)
+		}()
+	}
+	wg.Wait()
+	assert.Equal(t, 1, reads)
+
+	// a modified file is read again
+	require.NoError(t, os.WriteFile(path, []byte("v22"), 0600))
+	require.NoError(t, os.Chtimes(path, time.Now(), time.Now().Add(time.Second)))
+	value, err := c.get(path)
+	require.NoError(t, err)
+	assert.Equal(t, []byte("v22"), value)
+	assert.Equal(t, 2, reads)
+	assert.Equal(t, 1, c.len())
+
+	// failures aren't cached
+	other := filepath.Join(dir, "other")
+	require.NoError(t, os.WriteFile(other, nil, 0600))
+	fail = true
+	_, err = c.get(other)
+	assert.Error(t, err)
+	assert.Equal(t, 0, c.len())
+	fail = false
+	_, err = c.get(other)
+	assert.NoError(t, err)
+	assert.Equal(t, 4, reads)
+
+	_, err = c.get(filepath.Join(dir, "missing"))
+	assert.Error(t, err)
+}
@@ -0,0 +1,547 @@
+package helpers
+
+import (
+	"bufio"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+	"syscall"
+	"unsafe"
+)
+
+/*
+ * The helpers in this file decode the stacks collected by BPF programs in
+ * BPF_MAP_TYPE_STACK_TRACE maps, and symbolize them: kernel frames through
+ * /proc/kallsyms, user frames through /proc/<pid>/maps and the ELF symbols of
+ * the mapped binaries, or through build IDs (BPF_F_USER_BUILD_ID).
+ */
+
+//
+// Stack trace decoding
+//
+
+// StackReader reads the values of a stack trace map, as *libbpfgo.BPFMap
+// does.
+type StackReader interface {
+	GetValue(key unsafe.Pointer) ([]byte, error)
+}
+
+// ReadStacks reads the stacks of the given ids from a stack trace map, each
+// id once. Negative ids (failed bpf_get_stackid() calls) and missing stacks
+// are skipped.
+func ReadStacks(stacks StackReader, ids []int32) (map[int32][]byte, error) {
+	values := make(map[int32][]byte)
+	for _, id := range ids {
+		if id < 0 {
+			continue
+		}
+		if _, ok := values[id]; ok {
+			continue
+		}
+		key := uint32(id)
+		value, err := stacks.GetValue(unsafe.Pointer(&key))
+		if err != nil {
+			if errors.Is(err, syscall.ENOENT) {
+				continue
+			}
+			return nil, err
+		}
+		values[id] = value
+	}
+
+	return values, nil
+}
+
+// DecodeStack decodes the instruction pointers of a stack trace map value,
+// innermost first.
+func DecodeStack(value []byte) []uint64 {
+	if len(value) < 8 {
+		return nil
+	}
+	ips := unsafe.Slice((*uint64)(unsafe.Pointer(&value[0])), len(value)/8)
+	n := 0
+	for n < len(ips) && ips[n] != 0 {
+		n++
+	}
+	stack := make([]uint64, n)
+	copy(stack, ips)
+
+	return stack
+}
+
+// StackBuildIDStatus is the status of a build ID stack frame.
+type StackBuildIDStatus int32
+
+const (
+	StackBuildIDEmpty StackBuildIDStatus = iota
+	// StackBuildIDValid frames have a build ID and a file offset.
+	StackBuildIDValid
+	// StackBuildIDIP frames only have an instruction pointer, the build ID
+	// couldn't be read.
+	StackBuildIDIP
+)
+
+// StackBuildID is a frame of a stack collected with BPF_F_USER_BUILD_ID.
+type StackBuildID struct {
+	Status  StackBuildIDStatus
+	BuildID string // hex
+	// Offset is the file offset if the status is valid, or the instruction
+	// pointer.
+	Offset uint64
+}
+
+// sizeofStackBuildID is the size of struct bpf_stack_build_id.
+const sizeofStackBuildID = 32
+
+// DecodeBuildIDStack decodes the frames of a stack trace map value collected
+// with BPF_F_USER_BUILD_ID, innermost first.
+func DecodeBuildIDStack(value []byte) []StackBuildID {
+	var frames []StackBuildID
+	for ; len(value) >= sizeofStackBuildID; value = value[sizeofStackBuildID:] {
+		status := StackBuildIDStatus(*(*int32)(unsafe.Pointer(&value[0])))
+		if status == StackBuildIDEmpty {
+			break
+		}
+		frame := StackBuildID{
+			Status: status,
+			Offset: *(*uint64)(unsafe.Pointer(&value[24])),
+		}
+		if status == StackBuildIDValid {
+			frame.BuildID = hex.EncodeToString(value[4:24])
+		}
+		frames = append(frames, frame)
+	}
+
+	return frames
+}
+
+//
+// Symbolizer
+//
+
+// StackFrame is a symbolized stack frame.
+type StackFrame struct {
+	Address uint64
+	// Symbol is the function containing the address, empty if unresolved.
+	Symbol string
+	// Offset is the offset of the address in the function.
+	Offset uint64
+	// Module is the kernel module owning the function ("system" for
+	// vmlinux), or the path of the binary.
+	Module string
+}
+
+// SymbolizerOpts bounds the caches of a Symbolizer.
+type SymbolizerOpts struct {
+	// MaxStacks is the number of symbolized stacks kept, 4096 if zero.
+	MaxStacks int
+	// MaxProcesses is the number of process mappings kept, 1024 if zero.
+	MaxProcesses int
+	// MaxBinaries is the number of binary symbol tables kept, 64 if zero.
+	MaxBinaries int
+}
+
+// Symbolizer symbolizes kernel and user stacks. Identical stacks are
+// symbolized once and share their frames, which must not be modified. All
+// the caches are bounded, the least recently used entries being evicted. It
+// is safe for concurrent use.
+type Symbolizer struct {
+	kallsymsPath string
+	procPath     string
+
+	kernelOnce sync.Once
+	kernel     *kernelAddrIndex
+	kernelErr  error
+	binaries   *ELFSymbolCache
+
+	mu         sync.Mutex
+	stacks     *lruCache // stack key to []StackFrame
+	processes  *lruCache // pid to *processMappings
+	buildIDs   *lruCache // build ID to binary path
+	generation uint64
+}
+
+// NewSymbolizer creates a Symbolizer. The kernel symbols are read by the
+// first kernel stack symbolization.
+func NewSymbolizer(opts SymbolizerOpts) *Symbolizer {
+	if opts.MaxStacks <= 0 {
+		opts.MaxStacks = 4096
+	}
+	if opts.MaxProcesses <= 0 {
+		opts.MaxProcesses = 1024
+	}
+	if opts.MaxBinaries <= 0 {
+		opts.MaxBinaries = 64
+	}
+
+	return &Symbolizer{
+		kallsymsPath: kallsymsPath,
+		procPath:     "/proc",
+		binaries:     NewELFSymbolCache(opts.MaxBinaries),
+		stacks:       newLRUCache(opts.MaxStacks),
+		processes:    newLRUCache(opts.MaxProcesses),
+		buildIDs:     newLRUCache(opts.MaxBinaries),
+	}
+}
+
+// KernelStack symbolizes a kernel stack, resolving each address to the
+// nearest preceding kernel symbol.
+func (s *Symbolizer) KernelStack(ips []uint64) ([]StackFrame, error) {
+	s.kernelOnce.Do(func() {
+		s.kernel, s.kernelErr = newKernelAddrIndex(s.kallsymsPath)
+	})
+	if s.kernelErr != nil {
+		return nil, s.kernelErr
+	}
+
+	key := stackKey("k", 0, ips)
+	if frames, ok := s.cachedStack(key); ok {
+		return frames, nil
+	}
+
+	frames := make([]StackFrame, len(ips))
+	for i, ip := range ips {
+		frames[i] = s.kernel.frame(ip)
+	}
+	s.cacheStack(key, frames)
+
+	return frames, nil
+}
+
+// UserStack symbolizes a user stack of the process, through its mappings
+// and the ELF symbols of the mapped binaries, read through the process root
+// (so binaries of containers are found). The mappings are read again when
+// an address isn't mapped, e.g. after a dlopen().
+func (s *Symbolizer) UserStack(pid int, ips []uint64) ([]StackFrame, error) {
+	mappings, err := s.processMappings(pid, false)
+	if err != nil {
+		return nil, err
+	}
+	for _, ip := range ips {
+		if _, ok := mappings.find(ip); !ok {
+			if mappings, err = s.processMappings(pid, true); err != nil {
+				return nil, err
+			}
+			break
+		}
+	}
+
+	key := stackKey("u", mappings.generation, ips)
+	if frames, ok := s.cachedStack(key); ok {
+		return frames, nil
+	}
+
+	frames := make([]StackFrame, len(ips))
+	for i, ip := range ips {
+		frames[i] = StackFrame{Address: ip}
+		m, ok := mappings.find(ip)
+		if !ok {
+			continue
+		}
+		frames[i].Module = m.path
+		path := filepath.Join(s.procPath, strconv.Itoa(pid), "root", m.path)
+		s.symbolizeOffset(&frames[i], path, ip-m.start+m.offset)
+	}
+	s.cacheStack(key, frames)
+
+	return frames, nil
+}
+
+// BuildIDStack symbolizes a user stack collected with BPF_F_USER_BUILD_ID.
+// Build IDs are resolved to the binaries seen in the mappings of symbolized
+// user stacks, or added by AddBinary.
+func (s *Symbolizer) BuildIDStack(stack []StackBuildID) []StackFrame {
+	var b strings.Builder
+	b.WriteString("b")
+	for _, f := range stack {
+		fmt.Fprintf(&b, "%d:%s:%x/", f.Status, f.BuildID, f.Offset)
+	}
+	key := b.String()
+	if frames, ok := s.cachedStack(key); ok {
+		return frames
+	}
+
+	frames := make([]StackFrame, len(stack))
+	known := true
+	for i, f := range stack {
+		frames[i] = StackFrame{Address: f.Offset}
+		if f.Status != StackBuildIDValid {
+			continue
+		}
+		s.mu.Lock()
+		path, ok := s.buildIDs.get(f.BuildID)
+		s.mu.Unlock()
+		if !ok {
+			known = false
+			continue
+		}
+		frames[i].Module = path.(string)
+		s.symbolizeOffset(&frames[i], path.(string), f.Offset)
+	}
+	// stacks with unknown build IDs aren't kept, since the binaries can be
+	// seen later
+	if known {
+		s.cacheStack(key, frames)
+	}
+
+	return frames
+}
+
+// AddBinary indexes the binary at path, so that BuildIDStack resolves its
+// build ID.
+func (s *Symbolizer) AddBinary(path string) error {
+	index, err := s.binaries.Index(path)
+	if err != nil {
+		return err
+	}
+	if index.BuildID() == "" {
+		return fmt.Errorf("%s has no build ID", path)
+	}
+	s.mu.Lock()
+	s.buildIDs.add(index.BuildID(), path)
+	s.mu.Unlock()
+
+	return nil
+}
+
+// ForgetProcess drops the mappings of the process, e.g. when it exits, so
+// that a process reusing its pid isn't symbolized with them.
+func (s *Symbolizer) ForgetProcess(pid int) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	s.processes.remove(pid)
+}
+
+func (s *Symbolizer) symbolizeOffset(frame *StackFrame, path string, offset uint64) {
+	index, err := s.binaries.Index(path)
+	if err != nil {
+		return
+	}
+	if buildID := index.BuildID(); buildID != "" {
+		s.mu.Lock()
+		s.buildIDs.add(buildID, path)
+		s.mu.Unlock()
+	}
+	if sym, ok := index.SymbolAtOffset(offset); ok {
+		frame.Symbol = sym.Name
+		frame.Offset = offset - sym.Offset
+	}
+}
+
+func (s *Symbolizer) cachedStack(key string) ([]StackFrame, bool) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	frames, ok := s.stacks.get(key)
+	if !ok {
+		return nil, false
+	}
+
+	return frames.([]StackFrame), true
+}
+
+func (s *Symbolizer) cacheStack(key string, frames []StackFrame) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	s.stacks.add(key, frames)
+}
+
+// stackKey identifies a stack: its kind, the generation of the process
+// mappings for user stacks, and its addresses.
+func stackKey(kind string, generation uint64, ips []uint64) string {
+	var b strings.Builder
+	b.Grow(len(kind) + 8 + 8*len(ips))
+	b.WriteString(kind)
+	b.WriteString(strconv.FormatUint(generation, 16))
+	if len(ips) > 0 {
+		b.Write(unsafe.Slice((*byte)(unsafe.Pointer(&ips[0])), 8*len(ips)))
+	}
+
+	return b.String()
+}
+
+//
+// Kernel symbols by address
+//
+
+// kernelAddrIndex indexes the kernel text symbols by address.
+type kernelAddrIndex struct {
+	addrs  []uint64 // sorted
+	names  []string
+	owners []string
+}
+
+func newKernelAddrIndex(path string) (*kernelAddrIndex, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("could not open %s: %w", path, err)
+	}
+	defer file.Close()
+
+	type symbol struct {
+		addr  uint64
+		name  string
+		owner string
+	}
+	var symbols []symbol
+	owners := make(map[string]string) // interned owners
+	scanner := bufio.NewScanner(file)
+	for scanner.Scan() {
+		line := strings.Fields(scanner.Text())
+		if len(line) < 3 || (line[1] != "t" && line[1] != "T") {
+			continue
+		}
+		addr, err := strconv.ParseUint(line[0], 16, 64)
+		if err != nil || addr == 0 {
+			continue // hidden addresses (kptr_restrict)
+		}
+		_, name, owner := parseSymbolLine(line)
+		if interned, ok := owners[owner]; ok {
+			owner = interned
+		} else {
+			owners[owner] = owner
+		}
+		symbols = append(symbols, symbol{addr, name, owner})
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, fmt.Errorf("could not read %s: %w", path, err)
+	}
+	if len(symbols) == 0 {
+		return nil, fmt.Errorf("no kernel symbol address in %s", path)
+	}
+
+	sort.SliceStable(symbols, func(i, j int) bool {
+		return symbols[i].addr < symbols[j].addr
+	})
+	index := &kernelAddrIndex{
+		addrs:  make([]uint64, len(symbols)),
+		names:  make([]string, len(symbols)),
+		owners: make([]string, len(symbols)),
+	}
+	for i, sym := range symbols {
+		index.addrs[i] = sym.addr
+		index.names[i] = sym.name
+		index.owners[i] = sym.owner
+	}
+
+	return index, nil
+}
+
+// frame resolves the address to the nearest preceding symbol.
+func (k *kernelAddrIndex) frame(addr uint64) StackFrame {
+	frame := StackFrame{Address: addr}
+	i := sort.Search(len(k.addrs), func(i int) bool {
+		return k.addrs[i] > addr
+	}) - 1
+	if i < 0 {
+		return frame
+	}
+	frame.Symbol = k.names[i]
+	frame.Offset = addr - k.addrs[i]
+	frame.Module = k.owners[i]
+
+	return frame
+}
+
+//
+// Process mappings
+//
+
+type procMapping struct {
+	start  uint64
+	end    uint64
+	offset uint64
+	path   string
+}
+
+type processMappings struct {
+	mappings   []procMapping // executable file mappings, sorted by start
+	generation uint64
+}
+
+func (p *processMappings) find(addr uint64) (*procMapping, bool) {
+	i := sort.Search(len(p.mappings), func(i int) bool {
+		return p.mappings[i].end > addr
+	})
+	if i == len(p.mappings) || addr < p.mappings[i].start {
+		return nil, false
+	}
+
+	return &p.mappings[i], true
+}
+
+func (s *Symbolizer) processMappings(pid int, refresh bool) (*processMappings, error) {
+	s.mu.Lock()
+	if cached, ok := s.processes.get(pid); ok && !refresh {
+		s.mu.Unlock()
+		return cached.(*processMappings), nil
+	}
+	s.mu.Unlock()
+
+	mappings, err := readProcMaps(filepath.Join(s.procPath, strconv.Itoa(pid), "maps"))
+	if err != nil {
+		return nil, err
+	}
+
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.generation++
+	p := &processMappings{
+		mappings:   mappings,
+		generation: s.generation,
+	}
+	s.processes.add(pid, p)
+
+	return p, nil
+}
+
+// readProcMaps reads the executable file mappings of a process, with lines
+// "start-end perms offset dev inode path".
+func readProcMaps(path string) ([]procMapping, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("could not open %s: %w", path, err)
+	}
+	defer file.Close()
+
+	var mappings []procMapping
+	scanner := bufio.NewScanner(file)
+	for scanner.Scan() {
+		fields := strings.Fields(scanner.Text())
+		if len(fields) < 6 || !strings.Contains(fields[1], "x") || !strings.HasPrefix(fields[5], "/") {
+			continue
+		}
+		start, end, ok := strings.Cut(fields[0], "-")
+		if !ok {
+			continue
+		}
+		m := procMapping{
+			path: strings.TrimSuffix(strings.Join(fields[5:], " "), " (deleted)"),
+		}
+		var err1, err2, err3 error
+		m.start, err1 = strconv.ParseUint(start, 16, 64)
+		m.end, err2 = strconv.ParseUint(end, 16, 64)
+		m.offset, err3 = strconv.ParseUint(fields[2], 16, 64)
+		if err1 != nil || err2 != nil || err3 != nil {
+			continue
+		}
+		mappings = append(mappings, m)
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, fmt.Errorf("could not read %s: %w", path, err)
+	}
+
+	sort.Slice(mappings, func(i, j int) bool {
+		return mappings[i].start < mappings[j].start
+	})
+
+	return mappings, nil
+}
@@ -0,0 +1,114 @@
+package helpers
+
+import (
+	"encoding/binary"
+	"encoding/hex"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strconv"
+	"syscall"
+	"testing"
+	"unsafe"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+type testStackReader map[uint32][]byte
+
+func (r testStackReader) GetValue(key unsafe.Pointer) ([]byte, error) {
+	value, ok := r[*(*uint32)(key)]
+	if !ok {
+		return nil, fmt.Errorf("failed to lookup value: %w", syscall.ENOENT)
+	}
+	return value, nil
+}
+
+func TestDecodeStacks(t *testing.T) {
+	value := make([]byte, 4*8)
+	binary.LittleEndian.PutUint64(value[0:], 0x1000)
+	binary.LittleEndian.PutUint64(value[8:], 0x2000)
+	assert.Equal(t, []uint64{0x1000, 0x2000}, DecodeStack(value))
+
+	buildID := make([]byte, 20)
+	buildID[0] = 0xab
+	value = make([]byte, 3*sizeofStackBuildID)
+	binary.LittleEndian.PutUint32(value[0:], uint32(StackBuildIDValid))
+	copy(value[4:], buildID)
+	binary.LittleEndian.PutUint64(value[24:], 0x1234)
+	binary.LittleEndian.PutUint32(value[32:], uint32(StackBuildIDIP))
+	binary.LittleEndian.PutUint64(value[56:], 0x7f0000001000)
+	assert.Equal(t, []StackBuildID{
+		{Status: StackBuildIDValid, BuildID: hex.EncodeToString(buildID), Offset: 0x1234},
+		{Status: StackBuildIDIP, Offset: 0x7f0000001000},
+	}, DecodeBuildIDStack(value))
+
+	stacks, err := ReadStacks(testStackReader{1: []byte("a"), 2: []byte("b")}, []int32{1, -14, 1, 2, 3})
+	require.NoError(t, err)
+	assert.Equal(t, map[int32][]byte{1: []byte("a"), 2: []byte("b")}, stacks)
+}
+
+func TestSymbolizerKernelStack(t *testing.T) {
+	kallsyms := filepath.Join(t.TempDir(), "kallsyms")
+	require.NoError(t, os.WriteFile(kallsyms, []byte(`ffffffff81000000 T _stext
+ffffffff81000100 t do_one
+ffffffff81000200 D some_data
+ffffffff81000300 T do_two
+ffffffffc0000000 t ext4_read [ext4]
+`), 0o644))
+
+	s := NewSymbolizer(SymbolizerOpts{})
+	s.kallsymsPath = kallsyms
+
+	frames, err := s.KernelStack([]uint64{0xffffffff81000110, 0xffffffff81000250, 0xffffffffc0000008, 0x1000})
+	require.NoError(t, err)
+	assert.Equal(t, []StackFrame{
+		{Address: 0xffffffff81000110, Symbol: "do_one", Offset: 0x10, Module: "system"},
+		{Address: 0xffffffff81000250, Symbol: "do_one", Offset: 0x150, Module: "system"},
+		{Address: 0xffffffffc0000008, Symbol: "ext4_read", Offset: 0x8, Module: "ext4"},
+		{Address: 0x1000},
+	}, frames)
+
+	// identical stacks are interned
+	again, err := s.KernelStack([]uint64{0xffffffff81000110, 0xffffffff81000250, 0xffffffffc0000008, 0x1000})
+	require.NoError(t, err)
+	assert.Same(t, &frames[0], &again[0])
+}
+
+func TestSymbolizerUserStack(t *testing.T) {
+	libc := libcPath(t)
+	index, err := NewELFSymbolIndex(libc)
+	require.NoError(t, err)
+	sym, ok := index.Lookup(testSymbol)
+	require.True(t, ok)
+
+	// a process mapping libc from offset 0, with the host as root
+	const pid = 4242
+	const start = 0x7f0000000000
+	procPath := t.TempDir()
+	dir := filepath.Join(procPath, strconv.Itoa(pid))
+	require.NoError(t, os.MkdirAll(dir, 0o755))
+	require.NoError(t, os.Symlink("/", filepath.Join(dir, "root")))
+	maps := fmt.Sprintf("%x-%x r-xp 00000000 08:01 1234 %s\n", uint64(start), uint64(start+0x10000000), libc)
+	require.NoError(t, os.WriteFile(filepath.Join(dir, "maps"), []byte(maps), 0o644))
+
+	s := NewSymbolizer(SymbolizerOpts{})
+	s.procPath = procPath
+
+	frames, err := s.UserStack(pid, []uint64{start + sym.Offset + 1, 0x1000})
+	require.NoError(t, err)
+	assert.Equal(t, StackFrame{Address: start + sym.Offset + 1, Symbol: testSymbol, Offset: 1, Module: libc}, frames[0])
+	assert.Equal(t, StackFrame{Address: 0x1000}, frames[1])
+
+	// the build ID of the binary was seen in the mappings
+	if buildID := index.BuildID(); buildID != "" {
+		frames := s.BuildIDStack([]StackBuildID{{Status: StackBuildIDValid, BuildID: buildID, Offset: sym.Offset}})
+		assert.Equal(t, testSymbol, frames[0].Symbol)
+	}
+
+	s.ForgetProcess(pid)
+	require.NoError(t, os.Remove(filepath.Join(dir, "maps")))
+	_, err = s.UserStack(pid, []uint64{start})
+	assert.Error(t, err)
+}
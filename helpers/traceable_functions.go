@@ -0,0 +1,339 @@
+package helpers
+
+import (
+	"bufio"
+	"fmt"
+	"os"
+	"sort"
+	"strings"
+	"sync"
+)
+
+/*
+ * The helpers in this file index the kernel functions that can be traced
+ * (through kprobes or fentry), so attach targets can be checked before going
+ * through tracefs and perf_event_open.
+ */
+
+var (
+	availableFilterFunctionsPaths = []string{
+		"/sys/kernel/tracing/available_filter_functions",
+		"/sys/kernel/debug/tracing/available_filter_functions",
+	}
+	kprobeBlacklistPath = "/sys/kernel/debug/kprobes/blacklist"
+	modulesPath         = "/proc/modules"
+)
+
+type traceableFunction struct {
+	name  string
+	owner string
+}
+
+// TraceableFunctions indexes the kernel functions listed in
+// available_filter_functions, with their owner ("system" for vmlinux or the
+// module name), minus the functions of the kprobe blacklist. It is safe for
+// concurrent use.
+type TraceableFunctions struct {
+	filterPath    string
+	blacklistPath string
+	modulesPath   string
+
+	mu        sync.RWMutex
+	functions []traceableFunction // sorted by name then owner, deduplicated
+	blacklist []string            // sorted, deduplicated
+	modules   map[string]bool     // modules indexed
+}
+
+// NewTraceableFunctions indexes the traceable functions of the running
+// kernel.
+func NewTraceableFunctions() (*TraceableFunctions, error) {
+	filterPath := availableFilterFunctionsPaths[0]
+	for _, p := range availableFilterFunctionsPaths {
+		if _, err := os.Stat(p); err == nil {
+			filterPath = p
+			break
+		}
+	}
+
+	return NewTraceableFunctionsFromFiles(filterPath, kprobeBlacklistPath, modulesPath)
+}
+
+// NewTraceableFunctionsFromFiles indexes the traceable functions from the
+// given available_filter_functions, kprobe blacklist and modules list files.
+// The blacklist and modules files are optional.
+func NewTraceableFunctionsFromFiles(filterPath, blacklistPath, modulesPath string) (*TraceableFunctions, error) {
+	t := &TraceableFunctions{
+		filterPath:    filterPath,
+		blacklistPath: blacklistPath,
+		modulesPath:   modulesPath,
+	}
+
+	// the modules are read first: a module loaded meanwhile is then parsed
+	// again by the next refresh, rather than missed
+	t.modules = make(map[string]bool)
+	if modulesPath != "" {
+		modules, err := readModules(modulesPath)
+		if err != nil {
+			return nil, err
+		}
+		t.modules = modules
+	}
+
+	functions, err := readFilterFunctions(filterPath, nil)
+	if err != nil {
+		return nil, err
+	}
+	blacklist, err := readKprobeBlacklist(blacklistPath)
+	if err != nil {
+		return nil, err
+	}
+
+	t.functions = sortTraceableFunctions(functions)
+	t.blacklist = blacklist
+
+	return t, nil
+}
+
+// IsTraceable tells whether the function can be traced.
+func (t *TraceableFunctions) IsTraceable(name string) bool {
+	t.mu.RLock()
+	defer t.mu.RUnlock()
+
+	return t.indexOf(name) >= 0 && !t.isBlacklisted(name)
+}
+
+// Owners returns the owners of the functions with the given name, since
+// modules can have functions with the same name as others.
+func (t *TraceableFunctions) Owners(name string) []string {
+	t.mu.RLock()
+	defer t.mu.RUnlock()
+
+	var owners []string
+	for i := t.indexOf(name); i >= 0 && i < len(t.functions) && t.functions[i].name == name; i++ {
+		owners = append(owners, t.functions[i].owner)
+	}
+
+	return owners
+}
+
+// Check splits the given functions into the traceable and untraceable ones,
+// keeping their order.
+func (t *TraceableFunctions) Check(names []string) ([]string, []string) {
+	t.mu.RLock()
+	defer t.mu.RUnlock()
+
+	var traceable, untraceable []string
+	for _, name := range names {
+		if t.indexOf(name) >= 0 && !t.isBlacklisted(name) {
+			traceable = append(traceable, name)
+		} else {
+			untraceable = append(untraceable, name)
+		}
+	}
+
+	return traceable, untraceable
+}
+
+// Len returns the number of indexed functions.
+func (t *TraceableFunctions) Len() int {
+	t.mu.RLock()
+	defer t.mu.RUnlock()
+
+	return len(t.functions)
+}
+
+// Refresh updates the index when modules were loaded or unloaded since the
+// last refresh: the functions of the unloaded modules are dropped, and only
+// the functions of the loaded ones are parsed. The blacklist is read again.
+func (t *TraceableFunctions) Refresh() error {
+	if t.modulesPath == "" {
+		return nil
+	}
+	loaded, err := readModules(t.modulesPath)
+	if err != nil {
+		return err
+	}
+
+	t.mu.RLock()
+	added := make(map[string]bool)
+	for module := range loaded {
+		if !t.modules[module] {
+			added[module] = true
+		}
+	}
+	removed := 0
+	for module := range t.modules {
+		if !loaded[module] {
+			removed++
+		}
+	}
+	t.mu.RUnlock()
+	if len(added) == 0 && removed == 0 {
+		return nil
+	}
+
+	var newFunctions []traceableFunction
+	if len(added) > 0 {
+		newFunctions, err = readFilterFunctions(t.filterPath, added)
+		if err != nil {
+			return err
+		}
+	}
+	blacklist, err := readKprobeBlacklist(t.blacklistPath)
+	if err != nil {
+		return err
+	}
+
+	t.mu.Lock()
+	defer t.mu.Unlock()
+
+	functions := make([]traceableFunction, 0, len(t.functions)+len(newFunctions))
+	for _, f := range t.functions {
+		if f.owner == "system" || loaded[f.owner] {
+			functions = append(functions, f)
+		}
+	}
+	functions = append(functions, newFunctions...)
+	t.functions = sortTraceableFunctions(functions)
+	t.blacklist = blacklist
+	t.modules = loaded
+
+	return nil
+}
+
+// indexOf returns the index of the first function with the given name, or -1.
+func (t *TraceableFunctions) indexOf(name string) int {
+	i := sort.Search(len(t.functions), func(i int) bool {
+		return t.functions[i].name >= name
+	})
+	if i == len(t.functions) || t.functions[i].name != name {
+		return -1
+	}
+
+	return i
+}
+
+func (t *TraceableFunctions) isBlacklisted(name string) bool {
+	i := sort.SearchStrings(t.blacklist, name)
+	return i < len(t.blacklist) && t.blacklist[i] == name
+}
+
+func sortTraceableFunctions(functions []traceableFunction) []traceableFunction {
+	sort.Slice(functions, func(i, j int) bool {
+		if functions[i].name != functions[j].name {
+			return functions[i].name < functions[j].name
+		}
+		return functions[i].owner < functions[j].owner
+	})
+
+	// deduplicate in place
+	out := functions[:0]
+	for i, f := range functions {
+		if i > 0 && f == functions[i-1] {
+			continue
+		}
+		out = append(out, f)
+	}
+
+	return out
+}
+
+// readFilterFunctions parses an available_filter_functions file, with lines
+// "name" or "name [module]". If modules isn't nil, only the functions of
+// those modules are returned.
+func readFilterFunctions(path string, modules map[string]bool) ([]traceableFunction, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("could not open available filter functions: %w", err)
+	}
+	defer f.Close()
+
+	owners := make(map[string]string) // interned module names
+	var functions []traceableFunction
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		line := scanner.Text()
+		name, rest, hasOwner := strings.Cut(line, " ")
+		owner := "system"
+		if hasOwner {
+			owner = strings.Trim(strings.TrimSpace(rest), "[]")
+		}
+		if modules != nil && !modules[owner] {
+			continue
+		}
+		if interned, ok := owners[owner]; ok {
+			owner = interned
+		} else {
+			owners[owner] = owner
+		}
+		functions = append(functions, traceableFunction{name: name, owner: owner})
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, fmt.Errorf("could not read available filter functions: %w", err)
+	}
+
+	return functions, nil
+}
+
+// readKprobeBlacklist parses the kprobe blacklist, with lines
+// "0xstart-0xend	name". A missing blacklist is empty.
+func readKprobeBlacklist(path string) ([]string, error) {
+	if path == "" {
+		return nil, nil
+	}
+	f, err := os.Open(path)
+	if os.IsNotExist(err) {
+		return nil, nil
+	}
+	if err != nil {
+		return nil, fmt.Errorf("could not open kprobe blacklist: %w", err)
+	}
+	defer f.Close()
+
+	var blacklist []string
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		fields := strings.Fields(scanner.Text())
+		if len(fields) < 2 {
+			continue
+		}
+		blacklist = append(blacklist, fields[1])
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, fmt.Errorf("could not read kprobe blacklist: %w", err)
+	}
+
+	sort.Strings(blacklist)
+	out := blacklist[:0]
+	for i, name := range blacklist {
+		if i > 0 && name == blacklist[i-1] {
+			continue
+		}
+		out = append(out, name)
+	}
+
+	return out, nil
+}
+
+// readModules returns the names of the loaded modules.
+func readModules(path string) (map[string]bool, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("could not open modules: %w", err)
+	}
+	defer f.Close()
+
+	modules := make(map[string]bool)
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		name, _, _ := strings.Cut(scanner.Text(), " ")
+		if name != "" {
+			modules[name] = true
+		}
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, fmt.Errorf("could not read modules: %w", err)
+	}
+
+	return modules, nil
+}
@@ -0,0 +1,80 @@
+package helpers
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func writeTestFile(t *testing.T, dir, name, content string) string {
+	path := filepath.Join(dir, name)
+	require.NoError(t, os.WriteFile(path, []byte(content), 0o644))
+	return path
+}
+
+func TestTraceableFunctions(t *testing.T) {
+	dir := t.TempDir()
+	filter := writeTestFile(t, dir, "available_filter_functions", `do_sys_openat2
+vfs_read
+vfs_read
+do_int3
+ext4_file_open [ext4]
+init_module [ext4]
+init_module [xfs]
+`)
+	blacklist := writeTestFile(t, dir, "blacklist", "0xffffffff81000000-0xffffffff81000010\tdo_int3\n")
+	modules := writeTestFile(t, dir, "modules", "ext4 1 0 - Live 0x0\nxfs 1 0 - Live 0x0\nloop 1 0 - Live 0x0\n")
+
+	fns, err := NewTraceableFunctionsFromFiles(filter, blacklist, modules)
+	require.NoError(t, err)
+	assert.Equal(t, 6, fns.Len())
+
+	assert.True(t, fns.IsTraceable("vfs_read"))
+	assert.True(t, fns.IsTraceable("ext4_file_open"))
+	assert.False(t, fns.IsTraceable("do_int3"))
+	assert.False(t, fns.IsTraceable("not_a_function"))
+	assert.Equal(t, []string{"ext4", "xfs"}, fns.Owners("init_module"))
+	assert.Equal(t, []string{"system"}, fns.Owners("vfs_read"))
+	assert.Empty(t, fns.Owners("not_a_function"))
+
+	traceable, untraceable := fns.Check([]string{"vfs_read", "do_int3", "ext4_file_open", "nope"})
+	assert.Equal(t, []string{"vfs_read", "ext4_file_open"}, traceable)
+	assert.Equal(t, []string{"do_int3", "nope"}, untraceable)
+
+	// unchanged modules, including loop without traceable functions: the
+	// index is kept and the functions aren't parsed again
+	writeTestFile(t, dir, "available_filter_functions", "loop_probe [loop]\n")
+	require.NoError(t, fns.Refresh())
+	assert.Equal(t, 6, fns.Len())
+	assert.False(t, fns.IsTraceable("loop_probe"))
+
+	// xfs unloaded, btrfs loaded
+	writeTestFile(t, dir, "available_filter_functions", `do_sys_openat2
+vfs_read
+do_int3
+ext4_file_open [ext4]
+init_module [ext4]
+btrfs_file_open [btrfs]
+`)
+	writeTestFile(t, dir, "modules", "ext4 1 0 - Live 0x0\nbtrfs 1 0 - Live 0x0\n")
+	require.NoError(t, fns.Refresh())
+	assert.Equal(t, 6, fns.Len())
+	assert.True(t, fns.IsTraceable("btrfs_file_open"))
+	assert.Equal(t, []string{"ext4"}, fns.Owners("init_module"))
+}
+
+func TestTraceableFunctionsMissingBlacklist(t *testing.T) {
+	dir := t.TempDir()
+	filter := writeTestFile(t, dir, "available_filter_functions", "vfs_read\n")
+
+	fns, err := NewTraceableFunctionsFromFiles(filter, filepath.Join(dir, "missing"), "")
+	require.NoError(t, err)
+	assert.True(t, fns.IsTraceable("vfs_read"))
+	require.NoError(t, fns.Refresh())
+
+	_, err = NewTraceableFunctionsFromFiles(filepath.Join(dir, "missing"), "", "")
+	assert.Error(t, err)
+}
@@ -0,0 +1,155 @@
+package helpers
+
+import (
+	"bytes"
+	"debug/elf"
+	"encoding/binary"
+	"errors"
+	"fmt"
+)
+
+//
+// USDT probes
+//
+
+// USDTProbe is a USDT probe of a binary, as described by its .note.stapsdt
+// ELF section.
+type USDTProbe struct {
+	Provider string
+	Name     string
+	// Address is the address of the probe, adjusted for prelinking.
+	Address uint64
+	// Offset is the file offset of the probe, as uprobes take.
+	Offset uint64
+	// Semaphore is the address of the probe semaphore, zero if none.
+	Semaphore uint64
+	// Args describes the probe arguments (e.g. "-4@%edi 8@%rsi").
+	Args string
+}
+
+var usdtProbeCache = newFileCache(64, func(path string) (interface{}, error) {
+	return readUSDTProbes(path)
+})
+
+// USDTProbes returns the USDT probes of the binary or library at path. The
+// probes of a binary are parsed once and cached (the most recently used
+// binaries are kept), so attaching the same probes to many processes doesn't
+// parse the notes again. Binaries are identified by device, inode,
+// modification time and size, so a replaced binary is parsed again.
+func USDTProbes(path string) ([]USDTProbe, error) {
+	probes, err := usdtProbeCache.get(path)
+	if err != nil {
+		return nil, err
+	}
+
+	return probes.([]USDTProbe), nil
+}
+
+// ntStapsdt is the type of the USDT probe notes.
+const ntStapsdt = 3
+
+func readUSDTProbes(path string) ([]USDTProbe, error) {
+	f, err := elf.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("could not open elf file to read USDT probes: %w", err)
+	}
+	defer f.Close()
+
+	notes := f.Section(".note.stapsdt")
+	if notes == nil {
+		return nil, nil
+	}
+	data, err := notes.Data()
+	if err != nil {
+		return nil, fmt.Errorf("could not read USDT notes of %s: %w", path, err)
+	}
+
+	addrSize := 8
+	if f.Class == elf.ELFCLASS32 {
+		addrSize = 4
+	}
+	var stapsdtBase uint64
+	if base := f.Section(".stapsdt.base"); base != nil {
+		stapsdtBase = base.Addr
+	}
+
+	probes, err := parseStapsdtNotes(data, f.ByteOrder, addrSize, stapsdtBase)
+	if err != nil {
+		return nil, fmt.Errorf("could not parse USDT notes of %s: %w", path, err)
+	}
+	for i := range probes {
+		probes[i].Offset = elfAddrToOffset(f, probes[i].Address)
+	}
+
+	return probes, nil
+}
+
+// parseStapsdtNotes parses the notes of a .note.stapsdt section. Each note
+// describes a probe: its address, the link time address of .stapsdt.base,
+// the semaphore address and then the provider, name and arguments strings.
+// stapsdtBase is the address of the .stapsdt.base section, zero if none.
+func parseStapsdtNotes(data []byte, order binary.ByteOrder, addrSize int, stapsdtBase uint64) ([]USDTProbe, error) {
+	readAddr := func(b []byte) uint64 {
+		if addrSize == 4 {
+			return uint64(order.Uint32(b))
+		}
+		return order.Uint64(b)
+	}
+
+	var probes []USDTProbe
+	var probeErr error
+	err := forEachELFNote(data, order, func(name string, noteType uint32, desc []byte) bool {
+		if noteType != ntStapsdt || name != "stapsdt" {
+			return true
+		}
+		if len(desc) < 3*addrSize {
+			probeErr = errors.New("truncated USDT note")
+			return false
+		}
+
+		probe := USDTProbe{
+			Address:   readAddr(desc),
+			Semaphore: readAddr(desc[2*addrSize:]),
+		}
+		if stapsdtBase != 0 {
+			// the binary was prelinked: adjust the address by how much
+			// .stapsdt.base moved
+			probe.Address += stapsdtBase - readAddr(desc[addrSize:])
+		}
+
+		strs := bytes.SplitN(desc[3*addrSize:], []byte{0}, 4)
+		if len(strs) < 3 {
+			probeErr = errors.New("truncated USDT note strings")
+			return false
+		}
+		probe.Provider = string(strs[0])
+		probe.Name = string(strs[1])
+		probe.Args = string(strs[2])
+
+		probes = append(probes, probe)
+		return true
+	})
+	if err != nil {
+		return nil, err
+	}
+	if probeErr != nil {
+		return nil, probeErr
+	}
+
+	return probes, nil
+}
+
+// elfAddrToOffset converts an address to a file offset through the
+// executable segment containing it, or returns the address if none does.
+func elfAddrToOffset(f *elf.File, addr uint64) uint64 {
+	for _, prog := range f.Progs {
+		if prog.Type != elf.PT_LOAD || prog.Flags&elf.PF_X == 0 {
+			continue
+		}
+		if addr >= prog.Vaddr && addr < prog.Vaddr+prog.Memsz {
+			return addr - prog.Vaddr + prog.Off
+		}
+	}
+
+	return addr
+}
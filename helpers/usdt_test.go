@@ -0,0 +1,64 @@
+package helpers
+
+import (
+	"bytes"
+	"encoding/binary"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func stapsdtNote(pc, base, sema uint64, provider, name, args string) []byte {
+	desc := make([]byte, 24)
+	binary.LittleEndian.PutUint64(desc[0:], pc)
+	binary.LittleEndian.PutUint64(desc[8:], base)
+	binary.LittleEndian.PutUint64(desc[16:], sema)
+	desc = append(desc, provider+"\x00"+name+"\x00"+args+"\x00"...)
+
+	var note bytes.Buffer
+	header := make([]byte, 12)
+	binary.LittleEndian.PutUint32(header[0:], 8) // "stapsdt\x00"
+	binary.LittleEndian.PutUint32(header[4:], uint32(len(desc)))
+	binary.LittleEndian.PutUint32(header[8:], ntStapsdt)
+	note.Write(header)
+	note.WriteString("stapsdt\x00")
+	note.Write(desc)
+	for note.Len()%4 != 0 {
+		note.WriteByte(0)
+	}
+
+	return note.Bytes()
+}
+
+func TestParseStapsdtNotes(t *testing.T) {
+	data := append(
+		stapsdtNote(0x1000, 0x2000, 0, "libbpfgo", "start", "-4@%edi"),
+		stapsdtNote(0x1100, 0x2000, 0x3000, "libbpfgo", "stop", "")...,
+	)
+
+	probes, err := parseStapsdtNotes(data, binary.LittleEndian, 8, 0)
+	require.NoError(t, err)
+	require.Len(t, probes, 2)
+	assert.Equal(t, USDTProbe{Provider: "libbpfgo", Name: "start", Address: 0x1000, Args: "-4@%edi"}, probes[0])
+	assert.Equal(t, USDTProbe{Provider: "libbpfgo", Name: "stop", Address: 0x1100, Semaphore: 0x3000}, probes[1])
+
+	// prelinked: .stapsdt.base moved from 0x2000 to 0x2400
+	probes, err = parseStapsdtNotes(data, binary.LittleEndian, 8, 0x2400)
+	require.NoError(t, err)
+	assert.Equal(t, uint64(0x1400), probes[0].Address)
+
+	_, err = parseStapsdtNotes(data[:len(data)-8], binary.LittleEndian, 8, 0)
+	assert.Error(t, err)
+}
+
+func TestUSDTProbes(t *testing.T) {
+	// the test binary has no USDT probes
+	probes, err := USDTProbes("/proc/self/exe")
+	require.NoError(t, err)
+	assert.Empty(t, probes)
+	assert.Equal(t, 1, usdtProbeCache.len())
+
+	_, err = USDTProbes("/nonexistent")
+	assert.Error(t, err)
+}
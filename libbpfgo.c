@@ -1,5 +1,7 @@
 #include "libbpfgo.h"
 
+#include <bpf/skel_internal.h> // light skeleton loader
+
 extern void loggerCallback(enum libbpf_print_level level, char *output);
 extern void perfCallback(void *ctx, int cpu, void *data, __u32 size);
 extern void perfLostCallback(void *ctx, int cpu, __u64 cnt);
@@ -117,6 +119,117 @@ int cgo_bpf_prog_detach_cgroup_legacy(int prog_fd,   // eBPF program file descri
     return syscall(__NR_bpf, BPF_PROG_DETACH, &attr, sizeof(attr));
 }
 
+int cgo_perf_event_open_sampling(__u32 type,        // PERF_TYPE_{SOFTWARE,HARDWARE}
+                                 __u64 config,      // PERF_COUNT_SW_CPU_CLOCK, PERF_COUNT_HW_CPU_CYCLES, ...
+                                 __u64 sample_freq, // samples per second
+                                 int cpu)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.freq = 1;
+    attr.sample_freq = sample_freq;
+
+    // all the processes of the cpu
+    return syscall(__NR_perf_event_open, &attr, -1, cpu, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+int cgo_perf_event_open_counter(__u32 type,   // PERF_TYPE_{SOFTWARE,HARDWARE}
+                                __u64 config, // PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, ...
+                                int cpu,
+                                int group_fd) // group leader, or -1
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // for bpf_perf_event_read_value() to scale multiplexed counters
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // all the processes of the cpu
+    return syscall(__NR_perf_event_open, &attr, -1, cpu, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+//
+// light skeleton loader
+//
+
+// The loader program context is laid out as the one of bpftool light
+// skeletons: struct bpf_loader_ctx followed by the map and program descs.
+
+static struct bpf_map_desc *loader_ctx_maps(void *ctx)
+{
+    return (struct bpf_map_desc *) ((struct bpf_loader_ctx *) ctx + 1);
+}
+
+void *cgo_bpf_loader_ctx_new(__u32 nr_maps, __u32 nr_progs)
+{
+    struct bpf_loader_ctx *ctx;
+    size_t sz;
+
+    sz = sizeof(*ctx) + nr_maps * sizeof(struct bpf_map_desc) +
+         nr_progs * sizeof(struct bpf_prog_desc);
+    sz = (sz + 7) & ~7;
+
+    ctx = calloc(1, sz);
+    if (!ctx)
+        return NULL;
+
+    ctx->sz = sz;
+
+    return ctx;
+}
+
+void cgo_bpf_loader_ctx_free(void *ctx)
+{
+    free(ctx);
+}
+
+void cgo_bpf_loader_ctx_set_map(void *ctx, __u32 idx, __u32 max_entries, const void *initial_value)
+{
+    struct bpf_map_desc *map = &loader_ctx_maps(ctx)[idx];
+
+    map->max_entries = max_entries;
+    map->initial_value = (__u64) (unsigned long) initial_value;
+}
+
+int cgo_bpf_loader_ctx_map_fd(void *ctx, __u32 idx)
+{
+    return loader_ctx_maps(ctx)[idx].map_fd;
+}
+
+int cgo_bpf_loader_ctx_prog_fd(void *ctx, __u32 nr_maps, __u32 idx)
+{
+    struct bpf_prog_desc *progs = (struct bpf_prog_desc *) (loader_ctx_maps(ctx) + nr_maps);
+
+    return progs[idx].prog_fd;
+}
+
+int cgo_bpf_load_and_run(void *ctx,
+                         const void *data,
+                         __u32 data_sz,
+                         const void *insns,
+                         __u32 insns_sz,
+                         const char **errstr)
+{
+    struct bpf_load_and_run_opts opts = {};
+    int err;
+
+    opts.ctx = ctx;
+    opts.data = data;
+    opts.data_sz = data_sz;
+    opts.insns = insns;
+    opts.insns_sz = insns_sz;
+
+    err = bpf_load_and_run(&opts);
+    *errstr = opts.errstr;
+
+    return err;
+}
+
 //
 // struct handlers
 //
@@ -260,6 +373,26 @@ void cgo_bpf_map_info_free(struct bpf_map_info *info)
     free(info);
 }
 
+struct bpf_prog_info *cgo_bpf_prog_info_new()
+{
+    struct bpf_prog_info *info;
+    info = calloc(1, sizeof(*info));
+    if (!info)
+        return NULL;
+
+    return info;
+}
+
+__u32 cgo_bpf_prog_info_size()
+{
+    return sizeof(struct bpf_prog_info);
+}
+
+void cgo_bpf_prog_info_free(struct bpf_prog_info *info)
+{
+    free(info);
+}
+
 struct bpf_tc_opts *cgo_bpf_tc_opts_new(
     int prog_fd, __u32 flags, __u32 prog_id, __u32 handle, __u32 priority)
 {
@@ -300,170 +433,923 @@ void cgo_bpf_tc_hook_free(struct bpf_tc_hook *hook)
     free(hook);
 }
 
-//
-// struct getters
-//
+struct gen_loader_opts *cgo_gen_loader_opts_new()
+{
+    struct gen_loader_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-// bpf_map_info
+    opts->sz = sizeof(*opts);
 
-__u32 cgo_bpf_map_info_type(struct bpf_map_info *info)
-{
-    if (!info)
-        return 0;
+    return opts;
+}
 
-    return info->type;
+void cgo_gen_loader_opts_free(struct gen_loader_opts *opts)
+{
+    free(opts);
 }
 
-__u32 cgo_bpf_map_info_id(struct bpf_map_info *info)
+struct bpf_test_run_opts *cgo_bpf_test_run_opts_new(const void *data_in,
+                                                    void *data_out,
+                                                    __u32 data_size_in,
+                                                    __u32 data_size_out,
+                                                    const void *ctx_in,
+                                                    void *ctx_out,
+                                                    __u32 ctx_size_in,
+                                                    __u32 ctx_size_out,
+                                                    int repeat,
+                                                    __u32 flags,
+                                                    __u32 cpu,
+                                                    __u32 batch_size)
 {
-    if (!info)
-        return 0;
+    struct bpf_test_run_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-    return info->id;
+    opts->sz = sizeof(*opts);
+    opts->data_in = data_in;
+    opts->data_out = data_out;
+    opts->data_size_in = data_size_in;
+    opts->data_size_out = data_size_out;
+    opts->ctx_in = ctx_in;
+    opts->ctx_out = ctx_out;
+    opts->ctx_size_in = ctx_size_in;
+    opts->ctx_size_out = ctx_size_out;
+    opts->repeat = repeat;
+    opts->flags = flags;
+    opts->cpu = cpu;
+    opts->batch_size = batch_size;
+
+    return opts;
 }
 
-__u32 cgo_bpf_map_info_key_size(struct bpf_map_info *info)
+void cgo_bpf_test_run_opts_free(struct bpf_test_run_opts *opts)
 {
-    if (!info)
-        return 0;
-
-    return info->key_size;
+    free(opts);
 }
 
-__u32 cgo_bpf_map_info_value_size(struct bpf_map_info *info)
+struct bpf_kprobe_opts *cgo_bpf_kprobe_opts_new(__u64 bpf_cookie, size_t offset, bool retprobe)
 {
-    if (!info)
-        return 0;
+    struct bpf_kprobe_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-    return info->value_size;
+    opts->sz = sizeof(*opts);
+    opts->bpf_cookie = bpf_cookie;
+    opts->offset = offset;
+    opts->retprobe = retprobe;
+
+    return opts;
 }
 
-__u32 cgo_bpf_map_info_max_entries(struct bpf_map_info *info)
+void cgo_bpf_kprobe_opts_free(struct bpf_kprobe_opts *opts)
 {
-    if (!info)
-        return 0;
-
-    return info->max_entries;
+    free(opts);
 }
 
-__u32 cgo_bpf_map_info_map_flags(struct bpf_map_info *info)
+struct bpf_uprobe_opts *cgo_bpf_uprobe_opts_new(const char *func_name,
+                                                __u64 bpf_cookie,
+                                                bool retprobe)
 {
-    if (!info)
-        return 0;
+    struct bpf_uprobe_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-    return info->map_flags;
+    opts->sz = sizeof(*opts);
+    opts->func_name = func_name;
+    opts->bpf_cookie = bpf_cookie;
+    opts->retprobe = retprobe;
+
+    return opts;
 }
 
-char *cgo_bpf_map_info_name(struct bpf_map_info *info)
+void cgo_bpf_uprobe_opts_free(struct bpf_uprobe_opts *opts)
 {
-    if (!info)
+    free(opts);
+}
+
+struct bpf_tracepoint_opts *cgo_bpf_tracepoint_opts_new(__u64 bpf_cookie)
+{
+    struct bpf_tracepoint_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
         return NULL;
 
-    return info->name;
+    opts->sz = sizeof(*opts);
+    opts->bpf_cookie = bpf_cookie;
+
+    return opts;
 }
 
-__u32 cgo_bpf_map_info_ifindex(struct bpf_map_info *info)
+void cgo_bpf_tracepoint_opts_free(struct bpf_tracepoint_opts *opts)
 {
-    if (!info)
-        return 0;
+    free(opts);
+}
 
-    return info->ifindex;
+struct bpf_raw_tracepoint_opts *cgo_bpf_raw_tracepoint_opts_new(__u64 cookie)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 5)
+    struct bpf_raw_tracepoint_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
+
+    opts->sz = sizeof(*opts);
+    opts->cookie = cookie;
+
+    return opts;
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u32 cgo_bpf_map_info_btf_vmlinux_value_type_id(struct bpf_map_info *info)
+void cgo_bpf_raw_tracepoint_opts_free(struct bpf_raw_tracepoint_opts *opts)
 {
-    if (!info)
-        return 0;
+    free(opts);
+}
 
-    return info->btf_vmlinux_value_type_id;
+struct bpf_link *cgo_bpf_program__attach_raw_tracepoint_opts(const struct bpf_program *prog,
+                                                             const char *tp_name,
+                                                             struct bpf_raw_tracepoint_opts *opts)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 5)
+    return bpf_program__attach_raw_tracepoint_opts(prog, tp_name, opts);
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u64 cgo_bpf_map_info_netns_dev(struct bpf_map_info *info)
+struct bpf_perf_event_opts *cgo_bpf_perf_event_opts_new(__u64 bpf_cookie)
 {
-    if (!info)
-        return 0;
+    struct bpf_perf_event_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-    return info->netns_dev;
+    opts->sz = sizeof(*opts);
+    opts->bpf_cookie = bpf_cookie;
+
+    return opts;
 }
 
-__u64 cgo_bpf_map_info_netns_ino(struct bpf_map_info *info)
+void cgo_bpf_perf_event_opts_free(struct bpf_perf_event_opts *opts)
 {
-    if (!info)
-        return 0;
+    free(opts);
+}
 
-    return info->netns_ino;
+struct bpf_tcx_opts *cgo_bpf_tcx_opts_new(__u32 flags,
+                                          __u32 relative_fd,
+                                          __u32 relative_id,
+                                          __u64 expected_revision)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 3)
+    struct bpf_tcx_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
+
+    opts->sz = sizeof(*opts);
+    opts->flags = flags;
+    opts->relative_fd = relative_fd;
+    opts->relative_id = relative_id;
+    opts->expected_revision = expected_revision;
+
+    return opts;
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u32 cgo_bpf_map_info_btf_id(struct bpf_map_info *info)
+void cgo_bpf_tcx_opts_free(struct bpf_tcx_opts *opts)
 {
-    if (!info)
-        return 0;
+    free(opts);
+}
 
-    return info->btf_id;
+struct bpf_link *cgo_bpf_program__attach_tcx(const struct bpf_program *prog,
+                                          int ifindex,
+                                          const struct bpf_tcx_opts *opts)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 3)
+    return bpf_program__attach_tcx(prog, ifindex, opts);
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u32 cgo_bpf_map_info_btf_key_type_id(struct bpf_map_info *info)
+struct bpf_netkit_opts *cgo_bpf_netkit_opts_new(__u32 flags,
+                                                __u32 relative_fd,
+                                                __u32 relative_id,
+                                                __u64 expected_revision)
 {
-    if (!info)
-        return 0;
+#if LIBBPFGO_LIBBPF_GE(1, 4)
+    struct bpf_netkit_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-    return info->btf_key_type_id;
+    opts->sz = sizeof(*opts);
+    opts->flags = flags;
+    opts->relative_fd = relative_fd;
+    opts->relative_id = relative_id;
+    opts->expected_revision = expected_revision;
+
+    return opts;
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u32 cgo_bpf_map_info_btf_value_type_id(struct bpf_map_info *info)
+void cgo_bpf_netkit_opts_free(struct bpf_netkit_opts *opts)
 {
-    if (!info)
-        return 0;
+    free(opts);
+}
 
-    return info->btf_value_type_id;
+struct bpf_link *cgo_bpf_program__attach_netkit(const struct bpf_program *prog,
+                                          int ifindex,
+                                          const struct bpf_netkit_opts *opts)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 4)
+    return bpf_program__attach_netkit(prog, ifindex, opts);
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u64 cgo_bpf_map_info_map_extra(struct bpf_map_info *info)
+struct bpf_prog_query_opts *cgo_bpf_prog_query_opts_new(__u32 *prog_ids, __u32 *link_ids, __u32 count)
 {
-    if (!info)
-        return 0;
+#if LIBBPFGO_LIBBPF_GE(1, 3) // link_ids and revision
+    struct bpf_prog_query_opts *opts;
+    opts = calloc(1, sizeof(*opts));
+    if (!opts)
+        return NULL;
 
-    return info->map_extra;
+    opts->sz = sizeof(*opts);
+    opts->prog_ids = prog_ids;
+    opts->link_ids = link_ids;
+    opts->count = count;
+
+    return opts;
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-// bpf_tc_opts
+void cgo_bpf_prog_query_opts_free(struct bpf_prog_query_opts *opts)
+{
+    free(opts);
+}
 
-int cgo_bpf_tc_opts_prog_fd(struct bpf_tc_opts *opts)
+struct bpf_kprobe_multi_opts *cgo_bpf_kprobe_multi_opts_new(const char **syms,
+                                                            const __u64 *cookies,
+                                                            size_t cnt,
+                                                            bool retprobe)
 {
+    struct bpf_kprobe_multi_opts *opts;
+    opts = calloc(1, sizeof(*opts));
     if (!opts)
-        return 0;
+        return NULL;
 
-    return opts->prog_fd;
+    opts->sz = sizeof(*opts);
+    opts->syms = syms;
+    opts->cookies = cookies;
+    opts->cnt = cnt;
+    opts->retprobe = retprobe;
+
+    return opts;
 }
 
-__u32 cgo_bpf_tc_opts_flags(struct bpf_tc_opts *opts)
+void cgo_bpf_kprobe_multi_opts_free(struct bpf_kprobe_multi_opts *opts)
 {
-    if (!opts)
-        return 0;
+    free(opts);
+}
 
-    return opts->flags;
+int cgo_probe_kprobe_multi_link(void)
+{
+    // r0 = 0; exit
+    struct bpf_insn insns[] = {
+        {.code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_0, .imm = 0},
+        {.code = BPF_JMP | BPF_EXIT},
+    };
+    const char *syms[] = {"vprintk"};
+    int prog_fd, link_fd;
+
+    LIBBPF_OPTS(bpf_prog_load_opts, load_opts, .expected_attach_type = BPF_TRACE_KPROBE_MULTI);
+    prog_fd = bpf_prog_load(BPF_PROG_TYPE_KPROBE, NULL, "GPL", insns, 2, &load_opts);
+    if (prog_fd < 0)
+        return prog_fd;
+
+    LIBBPF_OPTS(bpf_link_create_opts, link_opts, .kprobe_multi.syms = syms, .kprobe_multi.cnt = 1);
+    link_fd = bpf_link_create(prog_fd, 0, BPF_TRACE_KPROBE_MULTI, &link_opts);
+    close(prog_fd);
+    if (link_fd < 0) {
+        // older kernels reject the attach type, and kernels without
+        // CONFIG_FPROBE the link type
+        if (link_fd == -EINVAL || link_fd == -EOPNOTSUPP || link_fd == -524 /* ENOTSUPP */)
+            return 0;
+        return link_fd;
+    }
+    close(link_fd);
+
+    return 1;
 }
 
-__u32 cgo_bpf_tc_opts_prog_id(struct bpf_tc_opts *opts)
+struct bpf_uprobe_multi_opts *cgo_bpf_uprobe_multi_opts_new(const char **syms,
+                                                            const unsigned long *offsets,
+                                                            const unsigned long *ref_ctr_offsets,
+                                                            const __u64 *cookies,
+                                                            size_t cnt,
+                                                            bool retprobe)
 {
+#if LIBBPFGO_LIBBPF_GE(1, 3)
+    struct bpf_uprobe_multi_opts *opts;
+    opts = calloc(1, sizeof(*opts));
     if (!opts)
-        return 0;
+        return NULL;
 
-    return opts->prog_id;
+    opts->sz = sizeof(*opts);
+    opts->syms = syms;
+    opts->offsets = offsets;
+    opts->ref_ctr_offsets = ref_ctr_offsets;
+    opts->cookies = cookies;
+    opts->cnt = cnt;
+    opts->retprobe = retprobe;
+
+    return opts;
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u32 cgo_bpf_tc_opts_handle(struct bpf_tc_opts *opts)
+void cgo_bpf_uprobe_multi_opts_free(struct bpf_uprobe_multi_opts *opts)
 {
-    if (!opts)
-        return 0;
+    free(opts);
+}
 
-    return opts->handle;
+struct bpf_link *cgo_bpf_program__attach_uprobe_multi(const struct bpf_program *prog,
+                                                      pid_t pid,
+                                                      const char *binary_path,
+                                                      const char *func_pattern,
+                                                      const struct bpf_uprobe_multi_opts *opts)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 3)
+    return bpf_program__attach_uprobe_multi(prog, pid, binary_path, func_pattern, opts);
+#else
+    errno = EOPNOTSUPP;
+    return NULL;
+#endif
 }
 
-__u32 cgo_bpf_tc_opts_priority(struct bpf_tc_opts *opts)
+struct bpf_usdt_opts *cgo_bpf_usdt_opts_new(__u64 usdt_cookie)
 {
+    struct bpf_usdt_opts *opts;
+    opts = calloc(1, sizeof(*opts));
     if (!opts)
-        return 0;
+        return NULL;
 
-    return opts->priority;
+    opts->sz = sizeof(*opts);
+    opts->usdt_cookie = usdt_cookie;
+
+    return opts;
+}
+
+void cgo_bpf_usdt_opts_free(struct bpf_usdt_opts *opts)
+{
+    free(opts);
+}
+
+//
+// struct getters
+//
+
+// bpf_map_info
+
+__u32 cgo_bpf_map_info_type(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->type;
+}
+
+__u32 cgo_bpf_map_info_id(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->id;
+}
+
+__u32 cgo_bpf_map_info_key_size(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->key_size;
+}
+
+__u32 cgo_bpf_map_info_value_size(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->value_size;
+}
+
+__u32 cgo_bpf_map_info_max_entries(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->max_entries;
+}
+
+__u32 cgo_bpf_map_info_map_flags(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->map_flags;
+}
+
+char *cgo_bpf_map_info_name(struct bpf_map_info *info)
+{
+    if (!info)
+        return NULL;
+
+    return info->name;
+}
+
+__u32 cgo_bpf_map_info_ifindex(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->ifindex;
+}
+
+__u32 cgo_bpf_map_info_btf_vmlinux_value_type_id(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->btf_vmlinux_value_type_id;
+}
+
+__u64 cgo_bpf_map_info_netns_dev(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->netns_dev;
+}
+
+__u64 cgo_bpf_map_info_netns_ino(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->netns_ino;
+}
+
+__u32 cgo_bpf_map_info_btf_id(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->btf_id;
+}
+
+__u32 cgo_bpf_map_info_btf_key_type_id(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->btf_key_type_id;
+}
+
+__u32 cgo_bpf_map_info_btf_value_type_id(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->btf_value_type_id;
+}
+
+__u64 cgo_bpf_map_info_map_extra(struct bpf_map_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->map_extra;
+}
+
+// bpf_prog_info
+
+__u32 cgo_bpf_prog_info_id(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->id;
+}
+
+char *cgo_bpf_prog_info_name(struct bpf_prog_info *info)
+{
+    if (!info)
+        return NULL;
+
+    return info->name;
+}
+
+__u64 cgo_bpf_prog_info_run_time_ns(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->run_time_ns;
+}
+
+__u64 cgo_bpf_prog_info_run_cnt(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->run_cnt;
+}
+
+__u64 cgo_bpf_prog_info_recursion_misses(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->recursion_misses;
+}
+
+__u32 cgo_bpf_prog_info_type(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->type;
+}
+
+__u32 cgo_bpf_prog_info_jited_prog_len(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->jited_prog_len;
+}
+
+__u32 cgo_bpf_prog_info_xlated_prog_len(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->xlated_prog_len;
+}
+
+__u64 cgo_bpf_prog_info_load_time(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->load_time;
+}
+
+__u32 cgo_bpf_prog_info_created_by_uid(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->created_by_uid;
+}
+
+__u32 cgo_bpf_prog_info_nr_map_ids(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->nr_map_ids;
+}
+
+__u32 cgo_bpf_prog_info_btf_id(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->btf_id;
+}
+
+__u32 cgo_bpf_prog_info_gpl_compatible(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->gpl_compatible;
+}
+
+__u32 cgo_bpf_prog_info_verified_insns(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->verified_insns;
+}
+
+__u32 cgo_bpf_prog_info_nr_jited_ksyms(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->nr_jited_ksyms;
+}
+
+__u32 cgo_bpf_prog_info_nr_jited_func_lens(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->nr_jited_func_lens;
+}
+
+__u32 cgo_bpf_prog_info_nr_func_info(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->nr_func_info;
+}
+
+__u32 cgo_bpf_prog_info_func_info_rec_size(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->func_info_rec_size;
+}
+
+__u32 cgo_bpf_prog_info_nr_line_info(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->nr_line_info;
+}
+
+__u32 cgo_bpf_prog_info_line_info_rec_size(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->line_info_rec_size;
+}
+
+__u32 cgo_bpf_prog_info_nr_jited_line_info(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->nr_jited_line_info;
+}
+
+__u32 cgo_bpf_prog_info_jited_line_info_rec_size(struct bpf_prog_info *info)
+{
+    if (!info)
+        return 0;
+
+    return info->jited_line_info_rec_size;
+}
+
+__u8 *cgo_bpf_prog_info_tag(struct bpf_prog_info *info)
+{
+    if (!info)
+        return NULL;
+
+    return info->tag;
+}
+
+// bpf_tc_opts
+
+int cgo_bpf_tc_opts_prog_fd(struct bpf_tc_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->prog_fd;
+}
+
+__u32 cgo_bpf_tc_opts_flags(struct bpf_tc_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->flags;
+}
+
+__u32 cgo_bpf_tc_opts_prog_id(struct bpf_tc_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->prog_id;
+}
+
+__u32 cgo_bpf_tc_opts_handle(struct bpf_tc_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->handle;
+}
+
+__u32 cgo_bpf_tc_opts_priority(struct bpf_tc_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->priority;
+}
+
+// gen_loader_opts
+
+const char *cgo_gen_loader_opts_data(struct gen_loader_opts *opts)
+{
+    if (!opts)
+        return NULL;
+
+    return opts->data;
+}
+
+__u32 cgo_gen_loader_opts_data_sz(struct gen_loader_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->data_sz;
+}
+
+const char *cgo_gen_loader_opts_insns(struct gen_loader_opts *opts)
+{
+    if (!opts)
+        return NULL;
+
+    return opts->insns;
+}
+
+__u32 cgo_gen_loader_opts_insns_sz(struct gen_loader_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->insns_sz;
+}
+
+// bpf_test_run_opts
+
+__u32 cgo_bpf_test_run_opts_data_size_out(struct bpf_test_run_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->data_size_out;
+}
+
+__u32 cgo_bpf_test_run_opts_ctx_size_out(struct bpf_test_run_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->ctx_size_out;
+}
+
+__u32 cgo_bpf_test_run_opts_retval(struct bpf_test_run_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->retval;
+}
+
+__u32 cgo_bpf_test_run_opts_duration(struct bpf_test_run_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->duration;
+}
+
+// bpf_prog_query_opts
+
+__u32 cgo_bpf_prog_query_opts_count(struct bpf_prog_query_opts *opts)
+{
+    if (!opts)
+        return 0;
+
+    return opts->count;
+}
+
+__u64 cgo_bpf_prog_query_opts_revision(struct bpf_prog_query_opts *opts)
+{
+#if LIBBPFGO_LIBBPF_GE(1, 3)
+    if (!opts)
+        return 0;
+
+    return opts->revision;
+#else
+    return 0;
+#endif
+}
+
+//
+// struct setters
+//
+
+// bpf_prog_info (arrays filled by bpf_prog_get_info_by_fd)
+
+void cgo_bpf_prog_info_set_xlated_prog_insns(struct bpf_prog_info *info, void *insns, __u32 len)
+{
+    if (!info)
+        return;
+
+    info->xlated_prog_insns = (__u64) (unsigned long) insns;
+    info->xlated_prog_len = len;
+}
+
+void cgo_bpf_prog_info_set_jited_prog_insns(struct bpf_prog_info *info, void *insns, __u32 len)
+{
+    if (!info)
+        return;
+
+    info->jited_prog_insns = (__u64) (unsigned long) insns;
+    info->jited_prog_len = len;
+}
+
+void cgo_bpf_prog_info_set_map_ids(struct bpf_prog_info *info, __u32 *ids, __u32 nr)
+{
+    if (!info)
+        return;
+
+    info->map_ids = (__u64) (unsigned long) ids;
+    info->nr_map_ids = nr;
+}
+
+void cgo_bpf_prog_info_set_jited_ksyms(struct bpf_prog_info *info, __u64 *ksyms, __u32 nr)
+{
+    if (!info)
+        return;
+
+    info->jited_ksyms = (__u64) (unsigned long) ksyms;
+    info->nr_jited_ksyms = nr;
+}
+
+void cgo_bpf_prog_info_set_jited_func_lens(struct bpf_prog_info *info, __u32 *lens, __u32 nr)
+{
+    if (!info)
+        return;
+
+    info->jited_func_lens = (__u64) (unsigned long) lens;
+    info->nr_jited_func_lens = nr;
+}
+
+void cgo_bpf_prog_info_set_func_info(struct bpf_prog_info *info, void *func_info, __u32 nr, __u32 rec_size)
+{
+    if (!info)
+        return;
+
+    info->func_info = (__u64) (unsigned long) func_info;
+    info->nr_func_info = nr;
+    info->func_info_rec_size = rec_size;
+}
+
+void cgo_bpf_prog_info_set_line_info(struct bpf_prog_info *info, void *line_info, __u32 nr, __u32 rec_size)
+{
+    if (!info)
+        return;
+
+    info->line_info = (__u64) (unsigned long) line_info;
+    info->nr_line_info = nr;
+    info->line_info_rec_size = rec_size;
+}
+
+void cgo_bpf_prog_info_set_jited_line_info(struct bpf_prog_info *info, __u64 *addrs, __u32 nr, __u32 rec_size)
+{
+    if (!info)
+        return;
+
+    info->jited_line_info = (__u64) (unsigned long) addrs;
+    info->nr_jited_line_info = nr;
+    info->jited_line_info_rec_size = rec_size;
 }
@@ -78,22 +78,25 @@ func SetStrictMode(mode LibbpfStrictMode) {
 // Support
 //
 
+// BPFProgramTypeIsSupported probes whether programs of type progType can be
+// loaded. It returns false without error when they can't, and an error only
+// if the probe itself fails. Use a ProbeCache to avoid probing the kernel on
+// every call.
 func BPFProgramTypeIsSupported(progType BPFProgType) (bool, error) {
-	supportedC := C.libbpf_probe_bpf_prog_type(C.enum_bpf_prog_type(int(progType)), nil)
-	if supportedC < 1 {
-		return false, syscall.Errno(-supportedC)
-	}
-
-	return supportedC == 1, nil
+	return probeProgType(progType)
 }
 
+// BPFMapTypeIsSupported probes whether maps of type mapType can be created,
+// with the same semantics as BPFProgramTypeIsSupported.
 func BPFMapTypeIsSupported(mapType MapType) (bool, error) {
-	supportedC := C.libbpf_probe_bpf_map_type(C.enum_bpf_map_type(int(mapType)), nil)
-	if supportedC < 1 {
-		return false, syscall.Errno(-supportedC)
-	}
+	return probeMapType(mapType)
+}
 
-	return supportedC == 1, nil
+// BPFHelperIsSupported probes whether the helper funcID can be called from
+// programs of type progType. Use a ProbeCache to avoid probing the kernel
+// on every call.
+func BPFHelperIsSupported(progType BPFProgType, funcID BPFFunc) (bool, error) {
+	return probeHelper(progType, funcID)
 }
 
 //
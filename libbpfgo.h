@@ -15,8 +15,31 @@
 #include <unistd.h>
 
 #include <bpf/bpf.h>
+#include <bpf/btf.h>
 #include <bpf/libbpf.h>
 #include <linux/bpf.h> // uapi
+#include <linux/perf_event.h>
+
+// LIBBPFGO_LIBBPF_GE tells whether libbpf is at least major.minor. The
+// wrappers of newer libbpf APIs fail with EOPNOTSUPP on older versions.
+#define LIBBPFGO_LIBBPF_GE(major, minor) \
+    (LIBBPF_MAJOR_VERSION > (major) || (LIBBPF_MAJOR_VERSION == (major) && LIBBPF_MINOR_VERSION >= (minor)))
+
+// attach types and flags of the multi-program attach points, missing from
+// the uapi headers of older libbpf versions
+#if !LIBBPFGO_LIBBPF_GE(1, 3)
+    #define BPF_TCX_INGRESS 46
+    #define BPF_TCX_EGRESS  47
+#endif
+#if !LIBBPFGO_LIBBPF_GE(1, 4)
+    #define BPF_NETKIT_PRIMARY 54
+    #define BPF_NETKIT_PEER    55
+#endif
+#ifndef BPF_F_BEFORE
+    #define BPF_F_BEFORE (1U << 3)
+    #define BPF_F_AFTER  (1U << 4)
+    #define BPF_F_ID     (1U << 5)
+#endif
 
 void cgo_libbpf_set_print_fn();
 
@@ -28,6 +51,21 @@ void cgo_bpf_map__initial_value(struct bpf_map *map, void *value);
 int cgo_bpf_prog_attach_cgroup_legacy(int prog_fd, int target_fd, int type);
 int cgo_bpf_prog_detach_cgroup_legacy(int prog_fd, int target_fd, int type);
 
+int cgo_perf_event_open_sampling(__u32 type, __u64 config, __u64 sample_freq, int cpu);
+int cgo_perf_event_open_counter(__u32 type, __u64 config, int cpu, int group_fd);
+
+void *cgo_bpf_loader_ctx_new(__u32 nr_maps, __u32 nr_progs);
+void cgo_bpf_loader_ctx_free(void *ctx);
+void cgo_bpf_loader_ctx_set_map(void *ctx, __u32 idx, __u32 max_entries, const void *initial_value);
+int cgo_bpf_loader_ctx_map_fd(void *ctx, __u32 idx);
+int cgo_bpf_loader_ctx_prog_fd(void *ctx, __u32 nr_maps, __u32 idx);
+int cgo_bpf_load_and_run(void *ctx,
+                         const void *data,
+                         __u32 data_sz,
+                         const void *insns,
+                         __u32 insns_sz,
+                         const char **errstr);
+
 //
 // struct handlers
 //
@@ -64,6 +102,10 @@ struct bpf_map_info *cgo_bpf_map_info_new();
 __u32 cgo_bpf_map_info_size();
 void cgo_bpf_map_info_free(struct bpf_map_info *info);
 
+struct bpf_prog_info *cgo_bpf_prog_info_new();
+__u32 cgo_bpf_prog_info_size();
+void cgo_bpf_prog_info_free(struct bpf_prog_info *info);
+
 struct bpf_tc_opts *cgo_bpf_tc_opts_new(
     int prog_fd, __u32 flags, __u32 prog_id, __u32 handle, __u32 priority);
 void cgo_bpf_tc_opts_free(struct bpf_tc_opts *opts);
@@ -71,6 +113,87 @@ void cgo_bpf_tc_opts_free(struct bpf_tc_opts *opts);
 struct bpf_tc_hook *cgo_bpf_tc_hook_new();
 void cgo_bpf_tc_hook_free(struct bpf_tc_hook *hook);
 
+struct gen_loader_opts *cgo_gen_loader_opts_new();
+void cgo_gen_loader_opts_free(struct gen_loader_opts *opts);
+
+struct bpf_test_run_opts *cgo_bpf_test_run_opts_new(const void *data_in,
+                                                    void *data_out,
+                                                    __u32 data_size_in,
+                                                    __u32 data_size_out,
+                                                    const void *ctx_in,
+                                                    void *ctx_out,
+                                                    __u32 ctx_size_in,
+                                                    __u32 ctx_size_out,
+                                                    int repeat,
+                                                    __u32 flags,
+                                                    __u32 cpu,
+                                                    __u32 batch_size);
+void cgo_bpf_test_run_opts_free(struct bpf_test_run_opts *opts);
+
+struct bpf_kprobe_opts *cgo_bpf_kprobe_opts_new(__u64 bpf_cookie, size_t offset, bool retprobe);
+void cgo_bpf_kprobe_opts_free(struct bpf_kprobe_opts *opts);
+
+struct bpf_uprobe_opts *cgo_bpf_uprobe_opts_new(const char *func_name,
+                                                __u64 bpf_cookie,
+                                                bool retprobe);
+void cgo_bpf_uprobe_opts_free(struct bpf_uprobe_opts *opts);
+
+struct bpf_tracepoint_opts *cgo_bpf_tracepoint_opts_new(__u64 bpf_cookie);
+void cgo_bpf_tracepoint_opts_free(struct bpf_tracepoint_opts *opts);
+
+struct bpf_raw_tracepoint_opts *cgo_bpf_raw_tracepoint_opts_new(__u64 cookie);
+void cgo_bpf_raw_tracepoint_opts_free(struct bpf_raw_tracepoint_opts *opts);
+struct bpf_link *cgo_bpf_program__attach_raw_tracepoint_opts(const struct bpf_program *prog,
+                                                             const char *tp_name,
+                                                             struct bpf_raw_tracepoint_opts *opts);
+
+struct bpf_perf_event_opts *cgo_bpf_perf_event_opts_new(__u64 bpf_cookie);
+void cgo_bpf_perf_event_opts_free(struct bpf_perf_event_opts *opts);
+
+struct bpf_tcx_opts *cgo_bpf_tcx_opts_new(__u32 flags,
+                                          __u32 relative_fd,
+                                          __u32 relative_id,
+                                          __u64 expected_revision);
+void cgo_bpf_tcx_opts_free(struct bpf_tcx_opts *opts);
+struct bpf_link *cgo_bpf_program__attach_tcx(const struct bpf_program *prog,
+                                          int ifindex,
+                                          const struct bpf_tcx_opts *opts);
+
+struct bpf_netkit_opts *cgo_bpf_netkit_opts_new(__u32 flags,
+                                                __u32 relative_fd,
+                                                __u32 relative_id,
+                                                __u64 expected_revision);
+void cgo_bpf_netkit_opts_free(struct bpf_netkit_opts *opts);
+struct bpf_link *cgo_bpf_program__attach_netkit(const struct bpf_program *prog,
+                                          int ifindex,
+                                          const struct bpf_netkit_opts *opts);
+
+struct bpf_prog_query_opts *cgo_bpf_prog_query_opts_new(__u32 *prog_ids, __u32 *link_ids, __u32 count);
+void cgo_bpf_prog_query_opts_free(struct bpf_prog_query_opts *opts);
+
+struct bpf_kprobe_multi_opts *cgo_bpf_kprobe_multi_opts_new(const char **syms,
+                                                            const __u64 *cookies,
+                                                            size_t cnt,
+                                                            bool retprobe);
+void cgo_bpf_kprobe_multi_opts_free(struct bpf_kprobe_multi_opts *opts);
+int cgo_probe_kprobe_multi_link(void);
+
+struct bpf_uprobe_multi_opts *cgo_bpf_uprobe_multi_opts_new(const char **syms,
+                                                            const unsigned long *offsets,
+                                                            const unsigned long *ref_ctr_offsets,
+                                                            const __u64 *cookies,
+                                                            size_t cnt,
+                                                            bool retprobe);
+void cgo_bpf_uprobe_multi_opts_free(struct bpf_uprobe_multi_opts *opts);
+struct bpf_link *cgo_bpf_program__attach_uprobe_multi(const struct bpf_program *prog,
+                                                      pid_t pid,
+                                                      const char *binary_path,
+                                                      const char *func_pattern,
+                                                      const struct bpf_uprobe_multi_opts *opts);
+
+struct bpf_usdt_opts *cgo_bpf_usdt_opts_new(__u64 usdt_cookie);
+void cgo_bpf_usdt_opts_free(struct bpf_usdt_opts *opts);
+
 //
 // struct getters
 //
@@ -93,6 +216,32 @@ __u32 cgo_bpf_map_info_btf_key_type_id(struct bpf_map_info *info);
 __u32 cgo_bpf_map_info_btf_value_type_id(struct bpf_map_info *info);
 __u64 cgo_bpf_map_info_map_extra(struct bpf_map_info *info);
 
+// bpf_prog_info
+
+__u32 cgo_bpf_prog_info_id(struct bpf_prog_info *info);
+char *cgo_bpf_prog_info_name(struct bpf_prog_info *info);
+__u64 cgo_bpf_prog_info_run_time_ns(struct bpf_prog_info *info);
+__u64 cgo_bpf_prog_info_run_cnt(struct bpf_prog_info *info);
+__u64 cgo_bpf_prog_info_recursion_misses(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_type(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_jited_prog_len(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_xlated_prog_len(struct bpf_prog_info *info);
+__u64 cgo_bpf_prog_info_load_time(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_created_by_uid(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_nr_map_ids(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_btf_id(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_gpl_compatible(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_verified_insns(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_nr_jited_ksyms(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_nr_jited_func_lens(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_nr_func_info(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_func_info_rec_size(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_nr_line_info(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_line_info_rec_size(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_nr_jited_line_info(struct bpf_prog_info *info);
+__u32 cgo_bpf_prog_info_jited_line_info_rec_size(struct bpf_prog_info *info);
+__u8 *cgo_bpf_prog_info_tag(struct bpf_prog_info *info);
+
 // bpf_tc_opts
 
 int cgo_bpf_tc_opts_prog_fd(struct bpf_tc_opts *opts);
@@ -101,4 +250,38 @@ __u32 cgo_bpf_tc_opts_prog_id(struct bpf_tc_opts *opts);
 __u32 cgo_bpf_tc_opts_handle(struct bpf_tc_opts *opts);
 __u32 cgo_bpf_tc_opts_priority(struct bpf_tc_opts *opts);
 
+// gen_loader_opts
+
+const char *cgo_gen_loader_opts_data(struct gen_loader_opts *opts);
+__u32 cgo_gen_loader_opts_data_sz(struct gen_loader_opts *opts);
+const char *cgo_gen_loader_opts_insns(struct gen_loader_opts *opts);
+__u32 cgo_gen_loader_opts_insns_sz(struct gen_loader_opts *opts);
+
+// bpf_test_run_opts
+
+__u32 cgo_bpf_test_run_opts_data_size_out(struct bpf_test_run_opts *opts);
+__u32 cgo_bpf_test_run_opts_ctx_size_out(struct bpf_test_run_opts *opts);
+__u32 cgo_bpf_test_run_opts_retval(struct bpf_test_run_opts *opts);
+__u32 cgo_bpf_test_run_opts_duration(struct bpf_test_run_opts *opts);
+
+// bpf_prog_query_opts
+
+__u32 cgo_bpf_prog_query_opts_count(struct bpf_prog_query_opts *opts);
+__u64 cgo_bpf_prog_query_opts_revision(struct bpf_prog_query_opts *opts);
+
+//
+// struct setters
+//
+
+// bpf_prog_info (arrays filled by bpf_prog_get_info_by_fd)
+
+void cgo_bpf_prog_info_set_xlated_prog_insns(struct bpf_prog_info *info, void *insns, __u32 len);
+void cgo_bpf_prog_info_set_jited_prog_insns(struct bpf_prog_info *info, void *insns, __u32 len);
+void cgo_bpf_prog_info_set_map_ids(struct bpf_prog_info *info, __u32 *ids, __u32 nr);
+void cgo_bpf_prog_info_set_jited_ksyms(struct bpf_prog_info *info, __u64 *ksyms, __u32 nr);
+void cgo_bpf_prog_info_set_jited_func_lens(struct bpf_prog_info *info, __u32 *lens, __u32 nr);
+void cgo_bpf_prog_info_set_func_info(struct bpf_prog_info *info, void *func_info, __u32 nr, __u32 rec_size);
+void cgo_bpf_prog_info_set_line_info(struct bpf_prog_info *info, void *line_info, __u32 nr, __u32 rec_size);
+void cgo_bpf_prog_info_set_jited_line_info(struct bpf_prog_info *info, __u64 *addrs, __u32 nr, __u32 rec_size);
+
 #endif
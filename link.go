@@ -33,6 +33,13 @@ const (
 	CgroupLegacy
 	Netns
 	Iter
+	KprobeMulti
+	KretprobeMulti
+	UprobeMulti
+	UretprobeMulti
+	USDT
+	TCX
+	Netkit
 )
 
 //
@@ -50,6 +57,10 @@ type BPFLink struct {
 	linkType  LinkType
 	eventName string
 	legacy    *bpfLinkLegacy // if set, this is a fake BPFLink
+	// reattach attaches another program to the same target (used when the
+	// link program cannot be updated in place)
+	reattach func(prog *BPFProg) (*BPFLink, error)
+	pinPath  string
 }
 
 func (l *BPFLink) DestroyLegacy(linkType LinkType) error {
@@ -77,6 +88,27 @@ func (l *BPFLink) Destroy() error {
 	return nil
 }
 
+// UpdateProgram atomically replaces the program attached through the link
+// with newProg, so no events are missed. newProg must be loaded and have the
+// same type and expected attach type as the program being replaced.
+//
+// Legacy links and links backed by perf events (e.g. tracepoints and
+// k(ret)probes) can't be updated by the kernel and return an error.
+func (l *BPFLink) UpdateProgram(newProg *BPFProg) error {
+	if l.legacy != nil || l.link == nil {
+		return fmt.Errorf("failed to update link %s: not a bpf link", l.eventName)
+	}
+
+	retC := C.bpf_link__update_program(l.link, newProg.prog)
+	if retC < 0 {
+		return fmt.Errorf("failed to update link %s to program %s: %w", l.eventName, newProg.Name(), syscall.Errno(-retC))
+	}
+
+	l.prog = newProg
+
+	return nil
+}
+
 func (l *BPFLink) FileDescriptor() int {
 	return int(C.bpf_link__fd(l.link))
 }
@@ -95,6 +127,8 @@ func (l *BPFLink) Pin(pinPath string) error {
 		return fmt.Errorf("failed to pin link %s to path %s: %w", l.eventName, pinPath, syscall.Errno(-retC))
 	}
 
+	l.pinPath = pinPath
+
 	return nil
 }
 
@@ -104,6 +138,8 @@ func (l *BPFLink) Unpin() error {
 		return fmt.Errorf("failed to unpin link %s: %w", l.eventName, syscall.Errno(-retC))
 	}
 
+	l.pinPath = ""
+
 	return nil
 }
 
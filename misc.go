@@ -6,6 +6,12 @@ package libbpfgo
 */
 import "C"
 
+import (
+	"errors"
+	"sync"
+	"time"
+)
+
 //
 // Misc generic helpers
 //
@@ -14,3 +20,103 @@ import "C"
 func roundUp(x, y uint64) uint64 {
 	return ((x + (y - 1)) / y) * y
 }
+
+// runConcurrently runs the given jobs with at most concurrency of them in
+// flight.
+func runConcurrently(jobs []func(), concurrency int) {
+	var wg sync.WaitGroup
+	sem := make(chan struct{}, concurrency)
+
+	for _, job := range jobs {
+		wg.Add(1)
+		sem <- struct{}{}
+		go func(job func()) {
+			defer wg.Done()
+			job()
+			<-sem
+		}(job)
+	}
+
+	wg.Wait()
+}
+
+// periodicTask runs a task every interval in its own goroutine, until it is
+// stopped or the task fails. It is safe for concurrent use.
+type periodicTask struct {
+	mu   sync.Mutex
+	stop chan struct{}
+	done chan struct{} // closed when the goroutine returns
+
+	errMu sync.Mutex // protects err, set by the goroutine
+	err   error
+}
+
+// start runs task every interval. The task gets the stop channel, to give up
+// blocking sends when stopped, and returns an error to stop. finish, if not
+// nil, is called when the goroutine returns. It fails if the task is already
+// running.
+func (t *periodicTask) start(interval time.Duration, task func(stop <-chan struct{}) error, finish func()) error {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+
+	if t.done != nil {
+		select {
+		case <-t.done: // stopped on its own
+		default:
+			return errors.New("already started")
+		}
+	}
+
+	t.setErr(nil)
+	stop := make(chan struct{})
+	done := make(chan struct{})
+	t.stop, t.done = stop, done
+	go func() {
+		defer close(done)
+		if finish != nil {
+			defer finish()
+		}
+		ticker := time.NewTicker(interval)
+		defer ticker.Stop()
+		for {
+			select {
+			case <-stop:
+				return
+			case <-ticker.C:
+				if err := task(stop); err != nil {
+					t.setErr(err)
+					return
+				}
+			}
+		}
+	}()
+
+	return nil
+}
+
+// stopAndWait stops the task and waits for its goroutine to return.
+func (t *periodicTask) stopAndWait() {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+
+	if t.stop == nil {
+		return
+	}
+	close(t.stop)
+	<-t.done
+	t.stop, t.done = nil, nil
+}
+
+func (t *periodicTask) setErr(err error) {
+	t.errMu.Lock()
+	t.err = err
+	t.errMu.Unlock()
+}
+
+// lastErr returns the error that stopped the last run of the task, or nil.
+func (t *periodicTask) lastErr() error {
+	t.errMu.Lock()
+	defer t.errMu.Unlock()
+
+	return t.err
+}
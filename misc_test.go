@@ -0,0 +1,60 @@
+package libbpfgo
+
+import (
+	"errors"
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func TestPeriodicTask(t *testing.T) {
+	var task periodicTask
+	var runs int32
+	run := func(stop <-chan struct{}) error {
+		atomic.AddInt32(&runs, 1)
+		return nil
+	}
+
+	if err := task.start(time.Millisecond, run, nil); err != nil {
+		t.Fatalf("unexpected start error: %v", err)
+	}
+	if err := task.start(time.Millisecond, run, nil); err == nil {
+		t.Fatal("expected the second start to fail")
+	}
+	time.Sleep(10 * time.Millisecond)
+	task.stopAndWait()
+	stopped := atomic.LoadInt32(&runs)
+	if stopped == 0 {
+		t.Fatal("expected the task to run")
+	}
+	time.Sleep(10 * time.Millisecond)
+	if atomic.LoadInt32(&runs) != stopped {
+		t.Fatal("expected the task not to run after stop")
+	}
+	task.stopAndWait() // no-op
+
+	if err := task.lastErr(); err != nil {
+		t.Fatalf("unexpected error after stop: %v", err)
+	}
+
+	// a task that fails stops on its own, keeps its error and can be started
+	// again
+	errFailed := errors.New("failed")
+	finished := make(chan struct{})
+	fail := func(<-chan struct{}) error { return errFailed }
+	if err := task.start(time.Millisecond, fail, func() { close(finished) }); err != nil {
+		t.Fatalf("unexpected start error: %v", err)
+	}
+	<-finished
+	task.stopAndWait()
+	if err := task.lastErr(); !errors.Is(err, errFailed) {
+		t.Fatalf("expected the task error, got %v", err)
+	}
+	if err := task.start(time.Millisecond, run, nil); err != nil {
+		t.Fatalf("unexpected restart error: %v", err)
+	}
+	if err := task.lastErr(); err != nil {
+		t.Fatalf("expected the error to be reset, got %v", err)
+	}
+	task.stopAndWait()
+}
@@ -0,0 +1,138 @@
+package libbpfgo
+
+import (
+	"errors"
+	"fmt"
+	"runtime"
+	"strings"
+	"time"
+)
+
+//
+// Bulk attach
+//
+
+// AttachSpec describes one attachment of Module.AttachAll. The meaning of
+// Target depends on Type:
+//
+//   - Kprobe, Kretprobe: kernel symbol
+//   - Tracepoint: "category:name"
+//   - RawTracepoint: tracepoint name
+//   - Uprobe, Uretprobe: binary path (with Offset and Pid)
+//   - XDP: network device name
+//   - Cgroup: cgroup v2 directory
+//   - Netns: network namespace path
+//   - PerfEvent: unused, FD is the perf event file descriptor
+//   - LSM, Tracing: unused, the target comes from the program section
+type AttachSpec struct {
+	Prog   *BPFProg
+	Type   LinkType
+	Target string
+	Offset uint32
+	Pid    int
+	FD     int
+}
+
+// AttachResult is the outcome of an AttachSpec.
+type AttachResult struct {
+	Link    *BPFLink
+	Latency time.Duration
+	Err     error
+}
+
+// AttachAll attaches the programs described by specs concurrently, with at
+// most concurrency attachments in flight (the number of CPUs if not positive),
+// since each one does its own perf_event_open and tracefs work. The results
+// are in the order of specs and report the latency of each attachment.
+//
+// It is all or nothing: if any attachment fails, the ones that succeeded are
+// destroyed and the error of the first failed spec is returned.
+func (m *Module) AttachAll(specs []AttachSpec, concurrency int) ([]AttachResult, error) {
+	if !m.loaded {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+	if concurrency <= 0 {
+		concurrency = runtime.NumCPU()
+	}
+
+	results := make([]AttachResult, len(specs))
+	jobs := make([]func(), len(specs))
+	for i := range specs {
+		i := i
+		jobs[i] = func() {
+			start := time.Now()
+			results[i].Link, results[i].Err = m.attachSpec(&specs[i])
+			results[i].Latency = time.Since(start)
+		}
+	}
+	runConcurrently(jobs, concurrency)
+
+	var firstErr error
+	failed := 0
+	for _, result := range results {
+		if result.Err != nil {
+			if firstErr == nil {
+				firstErr = result.Err
+			}
+			failed++
+		}
+	}
+	if firstErr == nil {
+		return results, nil
+	}
+
+	// roll back, so the caller never ends up with a partial set of links
+	for i := range results {
+		link := results[i].Link
+		if link == nil {
+			continue
+		}
+		if err := link.Destroy(); err != nil && results[i].Err == nil {
+			results[i].Err = fmt.Errorf("failed to roll back link %s: %w", link.eventName, err)
+		}
+		m.removeLink(link)
+		results[i].Link = nil
+	}
+
+	return results, fmt.Errorf("failed to attach %d of %d programs: %w", failed, len(specs), firstErr)
+}
+
+func (m *Module) attachSpec(spec *AttachSpec) (*BPFLink, error) {
+	prog := spec.Prog
+	if prog == nil || prog.module != m {
+		return nil, errors.New("attach spec program is not part of the module")
+	}
+
+	switch spec.Type {
+	case Kprobe:
+		return prog.AttachKprobe(spec.Target)
+	case Kretprobe:
+		return prog.AttachKretprobe(spec.Target)
+	case Tracepoint:
+		category, name, found := strings.Cut(spec.Target, ":")
+		if !found {
+			return nil, fmt.Errorf("invalid tracepoint %s: expected category:name", spec.Target)
+		}
+		return prog.AttachTracepoint(category, name)
+	case RawTracepoint:
+		return prog.AttachRawTracepoint(spec.Target)
+	case LSM:
+		return prog.AttachLSM()
+	case PerfEvent:
+		return prog.AttachPerfEvent(spec.FD)
+	case XDP:
+		return prog.AttachXDP(spec.Target)
+	case Cgroup:
+		return prog.AttachCgroup(spec.Target)
+	case Netns:
+		return prog.AttachNetns(spec.Target)
+	case Tracing:
+		return prog.AttachGeneric()
+	case Uprobe:
+		return prog.AttachUprobe(spec.Pid, spec.Target, spec.Offset)
+	case Uretprobe:
+		return prog.AttachURetprobe(spec.Pid, spec.Target, spec.Offset)
+	}
+
+	return nil, fmt.Errorf("failed to attach program %s: link type %d not supported", prog.Name(), spec.Type)
+}
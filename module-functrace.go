@@ -0,0 +1,264 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"syscall"
+	"unsafe"
+)
+
+//
+// Kernel function tracing
+//
+
+// FunctionAttachMechanism is how a kernel function is traced.
+type FunctionAttachMechanism int
+
+const (
+	FunctionAttachFentry FunctionAttachMechanism = iota
+	FunctionAttachKprobeMulti
+	FunctionAttachKprobe
+)
+
+func (m FunctionAttachMechanism) String() string {
+	switch m {
+	case FunctionAttachFentry:
+		return "fentry"
+	case FunctionAttachKprobeMulti:
+		return "kprobe_multi"
+	case FunctionAttachKprobe:
+		return "kprobe"
+	default:
+		return fmt.Sprintf("FunctionAttachMechanism(%d)", int(m))
+	}
+}
+
+// FunctionTracerOpts configures a FunctionTracer.
+type FunctionTracerOpts struct {
+	// Functions are the kernel functions to trace.
+	Functions []string
+	// FentryProgs are fentry (or fexit) programs, each tracing one function.
+	// Since a tracing program is loaded for a given target, the number of
+	// functions traced through fentry is bounded by the number of programs.
+	FentryProgs []string
+	// KprobeProg is the program tracing the other functions, defined with
+	// SEC("kprobe.multi") (or SEC("kretprobe.multi")).
+	KprobeProg string
+	// Retprobe traces the function returns through KprobeProg (FentryProgs
+	// should then be fexit programs).
+	Retprobe bool
+}
+
+// FunctionAttachment is how a function was traced by FunctionTracer.Attach.
+type FunctionAttachment struct {
+	Function  string
+	Mechanism FunctionAttachMechanism
+	// Link is shared by the functions traced by the same kprobe_multi link.
+	Link *BPFLink
+}
+
+// FunctionTracer traces kernel functions through the cheapest mechanism the
+// kernel supports for each: fentry (a BPF trampoline), then a kprobe_multi
+// link, then a kprobe per function.
+type FunctionTracer struct {
+	module  *Module
+	opts    FunctionTracerOpts
+	fentry  map[string]*BPFProg // function to its fentry program
+	kprobes []string
+}
+
+// NewFunctionTracer assigns the functions that can be traced through fentry
+// (described by the vmlinux BTF and traceable by ftrace) to the fentry
+// programs, setting their attach targets, and disables the autoload of the
+// fentry programs left unused. It must be called before the
+// BPF object is loaded, and the functions are attached by Attach after.
+func (m *Module) NewFunctionTracer(opts FunctionTracerOpts) (*FunctionTracer, error) {
+	if m.loaded {
+		return nil, errors.New("must be called before the BPF object is loaded")
+	}
+	if len(opts.Functions) == 0 {
+		return nil, errors.New("function tracer needs functions to trace")
+	}
+	if _, err := m.GetProgram(opts.KprobeProg); err != nil {
+		return nil, err
+	}
+
+	fentryProgs := make([]*BPFProg, 0, len(opts.FentryProgs))
+	for _, name := range opts.FentryProgs {
+		prog, err := m.GetProgram(name)
+		if err != nil {
+			return nil, err
+		}
+		fentryProgs = append(fentryProgs, prog)
+	}
+
+	t := &FunctionTracer{
+		module: m,
+		opts:   opts,
+		fentry: make(map[string]*BPFProg),
+	}
+
+	// the vmlinux BTF is loaded once for all the functions, nil without
+	// fentry support
+	var vmlinuxBTF *C.struct_btf
+	var traceable map[string]bool
+	if len(fentryProgs) > 0 {
+		if supported, _ := m.probes().ProgramTypeIsSupported(BPFProgTypeTracing); supported {
+			vmlinuxBTF = C.btf__load_vmlinux_btf()
+			if vmlinuxBTF != nil {
+				defer C.btf__free(vmlinuxBTF)
+				traceable = ftraceFunctions(opts.Functions)
+			}
+		}
+	}
+	seen := make(map[string]bool, len(opts.Functions))
+	for _, fn := range opts.Functions {
+		if seen[fn] {
+			continue
+		}
+		seen[fn] = true
+		if vmlinuxBTF != nil && len(fentryProgs) > 0 && kernelFunctionHasBTF(vmlinuxBTF, fn) &&
+			(traceable == nil || traceable[fn]) {
+			prog := fentryProgs[0]
+			if err := prog.SetAttachTarget(0, fn); err != nil {
+				return nil, err
+			}
+			t.fentry[fn] = prog
+			fentryProgs = fentryProgs[1:]
+			continue
+		}
+		t.kprobes = append(t.kprobes, fn)
+	}
+	for _, prog := range fentryProgs {
+		if err := prog.SetAutoload(false); err != nil {
+			return nil, err
+		}
+	}
+
+	return t, nil
+}
+
+// kernelFunctionHasBTF tells whether the kernel function is described by the
+// vmlinux BTF, as fentry requires.
+func kernelFunctionHasBTF(vmlinuxBTF *C.struct_btf, fn string) bool {
+	fnC := C.CString(fn)
+	defer C.free(unsafe.Pointer(fnC))
+
+	return C.btf__find_by_name_kind(vmlinuxBTF, fnC, C.BTF_KIND_FUNC) > 0
+}
+
+// ftraceFunctions returns which of the functions ftrace can trace, as fentry
+// requires: notrace and inlined functions can be described by the BTF and
+// still not be attachable. It returns nil if available_filter_functions
+// can't be read, leaving the attachment to tell.
+func ftraceFunctions(functions []string) map[string]bool {
+	wanted := make(map[string]bool, len(functions))
+	for _, fn := range functions {
+		wanted[fn] = true
+	}
+
+	traceable := make(map[string]bool, len(functions))
+	err := scanAvailableFilterFunctions(func(name string) {
+		if wanted[name] {
+			traceable[name] = true
+		}
+	})
+	if err != nil {
+		return nil
+	}
+
+	return traceable
+}
+
+// Attach attaches the functions and returns how each was traced, in the
+// order of the functions. Functions whose fentry attachment isn't supported
+// (e.g. no BPF trampolines on the architecture) are traced through kprobes
+// instead. The attachment is all or nothing.
+func (t *FunctionTracer) Attach() ([]FunctionAttachment, error) {
+	if !t.module.loaded {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+
+	var attachments []FunctionAttachment
+	rollback := func() {
+		for _, a := range attachments {
+			if a.Link.link != nil {
+				_ = a.Link.Destroy()
+				t.module.removeLink(a.Link)
+			}
+		}
+	}
+
+	kprobes := t.kprobes
+	for _, fn := range t.opts.Functions {
+		prog, ok := t.fentry[fn]
+		if !ok {
+			continue
+		}
+		link, err := prog.AttachGeneric()
+		if err != nil {
+			if errors.Is(err, syscall.EOPNOTSUPP) || errors.Is(err, errnoNotSupported) {
+				kprobes = append(kprobes, fn)
+				continue
+			}
+			rollback()
+			return nil, fmt.Errorf("failed to attach fentry to %s: %w", fn, err)
+		}
+		link.eventName = fn
+		attachments = append(attachments, FunctionAttachment{
+			Function:  fn,
+			Mechanism: FunctionAttachFentry,
+			Link:      link,
+		})
+	}
+
+	if len(kprobes) > 0 {
+		prog, err := t.module.GetProgram(t.opts.KprobeProg)
+		if err != nil {
+			rollback()
+			return nil, err
+		}
+		links, err := prog.AttachKprobeMulti(KprobeMultiOpts{
+			Symbols:  kprobes,
+			Retprobe: t.opts.Retprobe,
+		})
+		if err != nil {
+			rollback()
+			return nil, err
+		}
+		for i, fn := range kprobes {
+			a := FunctionAttachment{
+				Function:  fn,
+				Mechanism: FunctionAttachKprobe,
+			}
+			if len(links) == 1 && (links[0].linkType == KprobeMulti || links[0].linkType == KretprobeMulti) {
+				a.Mechanism = FunctionAttachKprobeMulti
+				a.Link = links[0]
+			} else {
+				a.Link = links[i]
+			}
+			attachments = append(attachments, a)
+		}
+	}
+
+	// in the order of the functions
+	byFunction := make(map[string]FunctionAttachment, len(attachments))
+	for _, a := range attachments {
+		byFunction[a.Function] = a
+	}
+	ordered := make([]FunctionAttachment, 0, len(byFunction))
+	for _, fn := range t.opts.Functions {
+		if a, ok := byFunction[fn]; ok {
+			ordered = append(ordered, a)
+			delete(byFunction, fn)
+		}
+	}
+
+	return ordered, nil
+}
@@ -0,0 +1,497 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"encoding/binary"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"strings"
+	"syscall"
+	"unsafe"
+)
+
+//
+// Loader blobs (libbpf gen_loader)
+//
+
+// A loader blob holds a BPF program, generated by libbpf gen_loader, that
+// creates the maps and loads the programs of a BPF object from within the
+// kernel, so no ELF or BTF parsing nor CO-RE relocation happens at runtime
+// (the kernel does the CO-RE relocations). Blobs are self-describing:
+//
+//	magic | meta size | data size | insns size | meta (json) | data | insns
+//
+// where data and insns are the loader program data and instructions.
+
+const (
+	lightBlobMagic      = "LBPFGOL1"
+	lightBlobHeaderSize = len(lightBlobMagic) + 3*4
+)
+
+type lightBlobMeta struct {
+	Maps  []lightMapMeta  `json:"maps"`
+	Progs []lightProgMeta `json:"progs"`
+	// NrProgs counts all the object programs, including the ones not loaded.
+	NrProgs int `json:"nrProgs"`
+}
+
+type lightMapMeta struct {
+	Name      string  `json:"name"`
+	Type      MapType `json:"type"`
+	ValueSize int     `json:"valueSize"`
+	Internal  bool    `json:"internal"`
+}
+
+type lightProgMeta struct {
+	Name        string        `json:"name"`
+	SectionName string        `json:"sectionName"`
+	Type        BPFProgType   `json:"type"`
+	AttachType  BPFAttachType `json:"attachType"`
+}
+
+type lightBlob struct {
+	meta  lightBlobMeta
+	data  []byte
+	insns []byte
+}
+
+// GenerateLoaderBlob records the loading of the BPF object, instead of
+// performing it, and returns a loader blob to be loaded with
+// NewModuleFromLoaderBlob. It replaces BPFLoadObject: maps and programs can be
+// configured before (e.g. initial values, max entries and autoload) and the
+// module can only be closed afterwards.
+//
+// Recording doesn't load anything into the kernel, so it can be done as a
+// build step (see cmd/libbpfgo-loader).
+func (m *Module) GenerateLoaderBlob() ([]byte, error) {
+	if m.loaded {
+		return nil, errors.New("must be called before the BPF object is loaded")
+	}
+
+	optsC, errno := C.cgo_gen_loader_opts_new()
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create gen_loader_opts: %w", errno)
+	}
+	defer C.cgo_gen_loader_opts_free(optsC)
+
+	retC := C.bpf_object__gen_loader(m.obj, optsC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to enable loader generation: %w", syscall.Errno(-retC))
+	}
+	retC = C.bpf_object__load(m.obj)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to generate loader: %w", syscall.Errno(-retC))
+	}
+
+	// the loader map and program descs follow the object order, and only
+	// programs set to autoload are recorded
+	blob := lightBlob{}
+	for mapC := C.bpf_object__next_map(m.obj, nil); mapC != nil; mapC = C.bpf_object__next_map(m.obj, mapC) {
+		blob.meta.Maps = append(blob.meta.Maps, lightMapMeta{
+			Name:      C.GoString(C.bpf_map__name(mapC)),
+			Type:      MapType(C.bpf_map__type(mapC)),
+			ValueSize: int(C.bpf_map__value_size(mapC)),
+			Internal:  bool(C.bpf_map__is_internal(mapC)),
+		})
+	}
+	for progC := C.bpf_object__next_program(m.obj, nil); progC != nil; progC = C.bpf_object__next_program(m.obj, progC) {
+		blob.meta.NrProgs++
+		if !bool(C.bpf_program__autoload(progC)) {
+			continue
+		}
+		blob.meta.Progs = append(blob.meta.Progs, lightProgMeta{
+			Name:        C.GoString(C.bpf_program__name(progC)),
+			SectionName: C.GoString(C.bpf_program__section_name(progC)),
+			Type:        BPFProgType(C.bpf_program__type(progC)),
+			AttachType:  BPFAttachType(C.bpf_program__expected_attach_type(progC)),
+		})
+	}
+
+	blob.data = C.GoBytes(
+		unsafe.Pointer(C.cgo_gen_loader_opts_data(optsC)),
+		C.int(C.cgo_gen_loader_opts_data_sz(optsC)),
+	)
+	blob.insns = C.GoBytes(
+		unsafe.Pointer(C.cgo_gen_loader_opts_insns(optsC)),
+		C.int(C.cgo_gen_loader_opts_insns_sz(optsC)),
+	)
+
+	return blob.encode()
+}
+
+func (b *lightBlob) encode() ([]byte, error) {
+	meta, err := json.Marshal(&b.meta)
+	if err != nil {
+		return nil, fmt.Errorf("failed to encode loader blob: %w", err)
+	}
+
+	out := make([]byte, lightBlobHeaderSize, lightBlobHeaderSize+len(meta)+len(b.data)+len(b.insns))
+	copy(out, lightBlobMagic)
+	binary.LittleEndian.PutUint32(out[len(lightBlobMagic):], uint32(len(meta)))
+	binary.LittleEndian.PutUint32(out[len(lightBlobMagic)+4:], uint32(len(b.data)))
+	binary.LittleEndian.PutUint32(out[len(lightBlobMagic)+8:], uint32(len(b.insns)))
+	out = append(out, meta...)
+	out = append(out, b.data...)
+	out = append(out, b.insns...)
+
+	return out, nil
+}
+
+// decodeLightBlob decodes a loader blob, without copying its data and insns.
+func decodeLightBlob(blob []byte) (*lightBlob, error) {
+	if len(blob) < lightBlobHeaderSize || string(blob[:len(lightBlobMagic)]) != lightBlobMagic {
+		return nil, errors.New("invalid loader blob")
+	}
+
+	metaSize := uint64(binary.LittleEndian.Uint32(blob[len(lightBlobMagic):]))
+	dataSize := uint64(binary.LittleEndian.Uint32(blob[len(lightBlobMagic)+4:]))
+	insnsSize := uint64(binary.LittleEndian.Uint32(blob[len(lightBlobMagic)+8:]))
+	if uint64(lightBlobHeaderSize)+metaSize+dataSize+insnsSize != uint64(len(blob)) {
+		return nil, errors.New("invalid loader blob: truncated")
+	}
+
+	b := &lightBlob{}
+	off := uint64(lightBlobHeaderSize)
+	if err := json.Unmarshal(blob[off:off+metaSize], &b.meta); err != nil {
+		return nil, fmt.Errorf("invalid loader blob: %w", err)
+	}
+	off += metaSize
+	b.data = blob[off : off+dataSize]
+	off += dataSize
+	b.insns = blob[off : off+insnsSize]
+
+	if len(b.insns) == 0 || len(b.meta.Progs) > b.meta.NrProgs {
+		return nil, errors.New("invalid loader blob: no loader program")
+	}
+
+	return b, nil
+}
+
+// mapIndex returns the index of the map with the given name, which can also
+// be the section name of an internal map (e.g. ".rodata"), or -1.
+func (b *lightBlob) mapIndex(name string) int {
+	for i, m := range b.meta.Maps {
+		if m.Name == name {
+			return i
+		}
+	}
+	// internal maps are named <object prefix><section name>
+	if strings.HasPrefix(name, ".") {
+		for i, m := range b.meta.Maps {
+			if m.Internal && strings.HasSuffix(m.Name, name) {
+				return i
+			}
+		}
+	}
+
+	return -1
+}
+
+//
+// LightModule
+//
+
+// LightModule holds the maps and programs created by a loader blob. Unlike a
+// Module, it has no libbpf object behind it: maps are accessed through the
+// low-level API and programs attached by file descriptor.
+type LightModule struct {
+	blob  *lightBlob
+	maps  []*BPFMapLow // nil if not created
+	progs []*LightProg
+	links []*LightLink
+}
+
+// NewLightModuleArgs configures NewModuleFromLoaderBlobArgs.
+type NewLightModuleArgs struct {
+	LoaderBlob []byte
+	// InitialValues overrides, by map name, the initial value of maps (e.g.
+	// ".rodata"). Values must have the map value size.
+	InitialValues map[string][]byte
+	// MaxEntries overrides, by map name, the max entries of maps.
+	MaxEntries map[string]uint32
+}
+
+// NewModuleFromLoaderBlob creates the maps and loads the programs recorded in
+// a loader blob (see Module.GenerateLoaderBlob). It requires a kernel with
+// BPF_PROG_TYPE_SYSCALL programs and in-kernel CO-RE relocations (v5.17+),
+// which also accounts BPF memory to cgroups, so RLIMIT_MEMLOCK isn't bumped.
+func NewModuleFromLoaderBlob(loaderBlob []byte) (*LightModule, error) {
+	return NewModuleFromLoaderBlobArgs(NewLightModuleArgs{
+		LoaderBlob: loaderBlob,
+	})
+}
+
+func NewModuleFromLoaderBlobArgs(args NewLightModuleArgs) (*LightModule, error) {
+	blob, err := decodeLightBlob(args.LoaderBlob)
+	if err != nil {
+		return nil, err
+	}
+
+	nrMaps := len(blob.meta.Maps)
+	ctxC, errno := C.cgo_bpf_loader_ctx_new(C.uint(nrMaps), C.uint(blob.meta.NrProgs))
+	if ctxC == nil {
+		return nil, fmt.Errorf("failed to create loader context: %w", errno)
+	}
+	defer C.cgo_bpf_loader_ctx_free(ctxC)
+
+	// the loader copies the initial values from user memory while it runs
+	var valuesC []unsafe.Pointer
+	defer func() {
+		for _, valueC := range valuesC {
+			C.free(valueC)
+		}
+	}()
+
+	maxEntries := make([]uint32, nrMaps)
+	initialValues := make([]unsafe.Pointer, nrMaps)
+	for name, entries := range args.MaxEntries {
+		i := blob.mapIndex(name)
+		if i < 0 {
+			return nil, fmt.Errorf("failed to set max entries of map %s: no such map", name)
+		}
+		maxEntries[i] = entries
+	}
+	for name, value := range args.InitialValues {
+		i := blob.mapIndex(name)
+		if i < 0 {
+			return nil, fmt.Errorf("failed to set initial value of map %s: no such map", name)
+		}
+		if len(value) != blob.meta.Maps[i].ValueSize {
+			return nil, fmt.Errorf("failed to set initial value of map %s: size %d, expected %d", name, len(value), blob.meta.Maps[i].ValueSize)
+		}
+		initialValues[i] = C.CBytes(value)
+		valuesC = append(valuesC, initialValues[i])
+	}
+	for i := 0; i < nrMaps; i++ {
+		C.cgo_bpf_loader_ctx_set_map(ctxC, C.uint(i), C.uint(maxEntries[i]), initialValues[i])
+	}
+
+	var dataC unsafe.Pointer
+	if len(blob.data) > 0 {
+		dataC = unsafe.Pointer(&blob.data[0])
+	}
+	var errstrC *C.char
+	retC := C.cgo_bpf_load_and_run(
+		ctxC,
+		dataC,
+		C.uint(len(blob.data)),
+		unsafe.Pointer(&blob.insns[0]),
+		C.uint(len(blob.insns)),
+		&errstrC,
+	)
+	if retC < 0 {
+		errstr := "failed to run loader"
+		if errstrC != nil {
+			errstr = C.GoString(errstrC)
+		}
+		return nil, fmt.Errorf("failed to load BPF object from loader blob: %s: %w", errstr, syscall.Errno(-retC))
+	}
+
+	m := &LightModule{
+		blob:  blob,
+		maps:  make([]*BPFMapLow, nrMaps),
+		progs: make([]*LightProg, len(blob.meta.Progs)),
+	}
+	for i := range blob.meta.Progs {
+		m.progs[i] = &LightProg{
+			fd:     int(C.cgo_bpf_loader_ctx_prog_fd(ctxC, C.uint(nrMaps), C.uint(i))),
+			meta:   &blob.meta.Progs[i],
+			module: m,
+		}
+	}
+	for i := range blob.meta.Maps {
+		fd := int(C.cgo_bpf_loader_ctx_map_fd(ctxC, C.uint(i)))
+		if fd <= 0 {
+			continue // not created (autocreate disabled)
+		}
+		m.maps[i] = &BPFMapLow{fd: fd, info: &BPFMapInfo{}}
+	}
+	for i, bpfMap := range m.maps {
+		if bpfMap == nil {
+			continue
+		}
+		info, err := GetMapInfoByFD(bpfMap.fd)
+		if err != nil {
+			m.Close()
+			return nil, fmt.Errorf("failed to get info of map %s: %w", blob.meta.Maps[i].Name, err)
+		}
+		bpfMap.info = info
+	}
+
+	return m, nil
+}
+
+// Close destroys the links and releases the maps and programs of the module.
+func (m *LightModule) Close() {
+	for _, link := range m.links {
+		_ = link.Destroy()
+	}
+	for _, prog := range m.progs {
+		if prog.fd > 0 {
+			syscall.Close(prog.fd)
+			prog.fd = -1
+		}
+	}
+	for _, bpfMap := range m.maps {
+		if bpfMap != nil && bpfMap.fd > 0 {
+			syscall.Close(bpfMap.fd)
+			bpfMap.fd = -1
+		}
+	}
+}
+
+// GetMap returns the map with the given name, which can also be the section
+// name of an internal map (e.g. ".bss").
+func (m *LightModule) GetMap(mapName string) (*BPFMapLow, error) {
+	i := m.blob.mapIndex(mapName)
+	if i < 0 || m.maps[i] == nil {
+		return nil, fmt.Errorf("failed to find BPF map %s: %w", mapName, syscall.ENOENT)
+	}
+
+	return m.maps[i], nil
+}
+
+func (m *LightModule) GetProgram(progName string) (*LightProg, error) {
+	for _, prog := range m.progs {
+		if prog.Name() == progName {
+			return prog, nil
+		}
+	}
+
+	return nil, fmt.Errorf("failed to find BPF program %s: %w", progName, syscall.ENOENT)
+}
+
+//
+// LightProg
+//
+
+// LightProg is a program loaded by a loader blob.
+type LightProg struct {
+	fd     int
+	meta   *lightProgMeta
+	module *LightModule
+}
+
+func (p *LightProg) FileDescriptor() int {
+	return p.fd
+}
+
+func (p *LightProg) Name() string {
+	return p.meta.Name
+}
+
+func (p *LightProg) SectionName() string {
+	return p.meta.SectionName
+}
+
+func (p *LightProg) GetType() BPFProgType {
+	return p.meta.Type
+}
+
+func (p *LightProg) ExpectedAttachType() BPFAttachType {
+	return p.meta.AttachType
+}
+
+// Attach attaches the program to the target recorded at build time, which is
+// possible for fentry/fexit/fmod_ret, tp_btf, LSM and raw tracepoint programs.
+// Other programs must be attached with AttachLink.
+func (p *LightProg) Attach() (*LightLink, error) {
+	switch p.meta.Type {
+	case BPFProgTypeTracing, BPFProgTypeLsm, BPFProgTypeExt:
+		if p.meta.AttachType != BPFAttachTypeTraceIter {
+			return p.attachRawTracepoint("")
+		}
+	case BPFProgTypeRawTracepoint, BPFProgTypeRawTracepointWritable:
+		if i := strings.IndexByte(p.meta.SectionName, '/'); i >= 0 {
+			return p.attachRawTracepoint(p.meta.SectionName[i+1:])
+		}
+	}
+
+	return nil, fmt.Errorf("failed to attach program %s: section %s can't be attached automatically", p.Name(), p.SectionName())
+}
+
+func (p *LightProg) AttachRawTracepoint(tpEvent string) (*LightLink, error) {
+	return p.attachRawTracepoint(tpEvent)
+}
+
+func (p *LightProg) attachRawTracepoint(tpEvent string) (*LightLink, error) {
+	var tpEventC *C.char
+	if tpEvent != "" {
+		tpEventC = C.CString(tpEvent)
+		defer C.free(unsafe.Pointer(tpEventC))
+	}
+
+	fdC := C.bpf_raw_tracepoint_open(tpEventC, C.int(p.fd))
+	if fdC < 0 {
+		return nil, fmt.Errorf("failed to attach program %s: %w", p.Name(), syscall.Errno(-fdC))
+	}
+
+	return p.newLink(int(fdC)), nil
+}
+
+// AttachLink attaches the program to targetFd through a BPF link, e.g. to a
+// network interface index with BPFAttachTypeXDP, a cgroup directory fd with
+// a cgroup attach type or a perf event fd with BPFAttachTypePerfEvent.
+func (p *LightProg) AttachLink(targetFd int, attachType BPFAttachType) (*LightLink, error) {
+	fdC := C.bpf_link_create(C.int(p.fd), C.int(targetFd), uint32(attachType), nil)
+	if fdC < 0 {
+		return nil, fmt.Errorf("failed to attach program %s to fd %d: %w", p.Name(), targetFd, syscall.Errno(-fdC))
+	}
+
+	return p.newLink(int(fdC)), nil
+}
+
+func (p *LightProg) newLink(fd int) *LightLink {
+	link := &LightLink{
+		fd:   fd,
+		prog: p,
+	}
+	p.module.links = append(p.module.links, link)
+
+	return link
+}
+
+//
+// LightLink
+//
+
+// LightLink is a BPF link of a LightProg, destroyed when its module is closed.
+type LightLink struct {
+	fd   int
+	prog *LightProg
+}
+
+func (l *LightLink) FileDescriptor() int {
+	return l.fd
+}
+
+func (l *LightLink) Pin(pinPath string) error {
+	pathC := C.CString(pinPath)
+	defer C.free(unsafe.Pointer(pathC))
+
+	retC := C.bpf_obj_pin(C.int(l.fd), pathC)
+	if retC < 0 {
+		return fmt.Errorf("failed to pin link of program %s to path %s: %w", l.prog.Name(), pinPath, syscall.Errno(-retC))
+	}
+
+	return nil
+}
+
+// Destroy detaches the program, unless the link is pinned.
+func (l *LightLink) Destroy() error {
+	if l.fd < 0 {
+		return nil
+	}
+	if err := syscall.Close(l.fd); err != nil {
+		return err
+	}
+	l.fd = -1
+
+	return nil
+}
@@ -0,0 +1,50 @@
+package libbpfgo
+
+import (
+	"bytes"
+	"testing"
+)
+
+func TestLightBlobEncoding(t *testing.T) {
+	blob := &lightBlob{
+		meta: lightBlobMeta{
+			Maps: []lightMapMeta{
+				{Name: "events", Type: MapTypeRingbuf},
+				{Name: "main_bpf.rodata", Type: MapTypeArray, ValueSize: 8, Internal: true},
+			},
+			Progs: []lightProgMeta{
+				{Name: "handler", SectionName: "fentry/do_exit", Type: BPFProgTypeTracing},
+			},
+			NrProgs: 2,
+		},
+		data:  []byte{1, 2, 3},
+		insns: []byte{4, 5, 6, 7, 8, 9, 10, 11},
+	}
+
+	encoded, err := blob.encode()
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	decoded, err := decodeLightBlob(encoded)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Equal(decoded.data, blob.data) || !bytes.Equal(decoded.insns, blob.insns) {
+		t.Fatalf("loader program mismatch: got data=%v insns=%v", decoded.data, decoded.insns)
+	}
+	if len(decoded.meta.Maps) != 2 || decoded.meta.Progs[0] != blob.meta.Progs[0] || decoded.meta.NrProgs != 2 {
+		t.Fatalf("meta mismatch: got %+v", decoded.meta)
+	}
+
+	if i := decoded.mapIndex(".rodata"); i != 1 {
+		t.Errorf("expected .rodata at index 1, got %d", i)
+	}
+	if i := decoded.mapIndex(".data"); i != -1 {
+		t.Errorf("expected no .data map, got index %d", i)
+	}
+
+	if _, err := decodeLightBlob(encoded[:len(encoded)-1]); err == nil {
+		t.Errorf("expected an error decoding a truncated blob")
+	}
+}
@@ -0,0 +1,317 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"math"
+	"math/bits"
+	"os"
+)
+
+//
+// Map memory planning
+//
+
+// MapMemory is the estimated kernel memory footprint of a map.
+type MapMemory struct {
+	Name       string
+	Type       MapType
+	MaxEntries uint32
+	// Bytes is charged when the map is created: everything, unless the map
+	// elements are allocated on demand (e.g. BPF_F_NO_PREALLOC hash maps).
+	Bytes uint64
+	// MaxBytes is charged once the map is full.
+	MaxBytes uint64
+}
+
+// mapMemorySpec is what the footprint of a map depends on.
+type mapMemorySpec struct {
+	mapType    MapType
+	keySize    uint64
+	valueSize  uint64
+	maxEntries uint64
+	flags      uint32
+	extra      uint64
+}
+
+const (
+	mapFlagNoPrealloc = uint32(C.BPF_F_NO_PREALLOC)
+
+	// approximate sizes of the kernel structures backing the map elements
+	htabElemOverhead  = 48 // struct htab_elem
+	htabBucketSize    = 16 // struct bucket
+	stackBucketSize   = 16 // struct stack_map_bucket
+	lpmNodeOverhead   = 40 // struct lpm_trie_node
+	mapStructOverhead = 512
+)
+
+// MapsMemory estimates the kernel memory footprint of the maps created by
+// the module, from their type, key and value sizes, max entries and flags.
+// Per-CPU maps are accounted for all possible CPUs. Maps whose size doesn't
+// depend on their definition (e.g. task storage) are estimated as empty.
+//
+// It must be called before the BPF object is loaded, so the result reflects
+// the SetMaxEntries (and similar) calls made meanwhile.
+func (m *Module) MapsMemory() ([]MapMemory, error) {
+	if m.loaded {
+		return nil, errors.New("must be called before the BPF object is loaded")
+	}
+
+	numCPU, err := NumPossibleCPUs()
+	if err != nil {
+		return nil, err
+	}
+	pageSize := uint64(os.Getpagesize())
+
+	var mems []MapMemory
+	it := m.Iterator()
+	for bpfMap := it.NextMap(); bpfMap != nil; bpfMap = it.NextMap() {
+		if !bpfMap.Autocreate() {
+			continue
+		}
+		spec := bpfMap.memorySpec()
+		bytes, maxBytes := spec.footprint(numCPU, pageSize)
+		mems = append(mems, MapMemory{
+			Name:       bpfMap.Name(),
+			Type:       bpfMap.Type(),
+			MaxEntries: bpfMap.MaxEntries(),
+			Bytes:      bytes,
+			MaxBytes:   maxBytes,
+		})
+	}
+
+	return mems, nil
+}
+
+// FitMapsMemory scales down the max entries of the scalable maps (by name),
+// proportionally, so the full footprint of all the maps, as estimated by
+// MapsMemory, fits the budget (in bytes). Nothing changes if it already fits.
+// It returns the resulting footprint.
+//
+// Ring buffer sizes are kept a power of two multiple of the page size, and
+// every scaled map keeps at least one entry. It fails, changing nothing, if
+// the maps can't fit the budget.
+//
+// It must be called before the BPF object is loaded.
+func (m *Module) FitMapsMemory(budget uint64, scalable []string) ([]MapMemory, error) {
+	if m.loaded {
+		return nil, errors.New("must be called before the BPF object is loaded")
+	}
+
+	numCPU, err := NumPossibleCPUs()
+	if err != nil {
+		return nil, err
+	}
+	pageSize := uint64(os.Getpagesize())
+
+	specs := make(map[string]mapMemorySpec, len(scalable))
+	maps := make(map[string]*BPFMap, len(scalable))
+	for _, name := range scalable {
+		bpfMap, err := m.GetMap(name)
+		if err != nil {
+			return nil, err
+		}
+		maps[name] = bpfMap
+		specs[name] = bpfMap.memorySpec()
+	}
+
+	var fixed uint64
+	it := m.Iterator()
+	for bpfMap := it.NextMap(); bpfMap != nil; bpfMap = it.NextMap() {
+		if _, ok := specs[bpfMap.Name()]; ok || !bpfMap.Autocreate() {
+			continue
+		}
+		spec := bpfMap.memorySpec()
+		_, maxBytes := spec.footprint(numCPU, pageSize)
+		fixed += maxBytes
+	}
+
+	entries, err := fitMapEntries(specs, budget, fixed, numCPU, pageSize)
+	if err != nil {
+		return nil, err
+	}
+	for name, maxEntries := range entries {
+		if err := maps[name].SetMaxEntries(maxEntries); err != nil {
+			return nil, err
+		}
+	}
+
+	return m.MapsMemory()
+}
+
+func (m *BPFMap) memorySpec() mapMemorySpec {
+	return mapMemorySpec{
+		mapType:    m.Type(),
+		keySize:    uint64(m.KeySize()),
+		valueSize:  uint64(m.ValueSize()),
+		maxEntries: uint64(m.MaxEntries()),
+		flags:      uint32(C.bpf_map__map_flags(m.bpfMap)),
+		extra:      m.MapExtra(),
+	}
+}
+
+// fitMapEntries returns the max entries of the scalable maps that fit them in
+// the budget, next to maps of a fixed footprint, or none if they already fit.
+func fitMapEntries(specs map[string]mapMemorySpec, budget, fixed uint64, numCPU int, pageSize uint64) (map[string]uint32, error) {
+	if fixed > budget {
+		return nil, fmt.Errorf("maps that can't be scaled need %d bytes, over the %d bytes budget", fixed, budget)
+	}
+
+	total := func(scale float64) (uint64, map[string]uint32) {
+		sum := fixed
+		entries := make(map[string]uint32, len(specs))
+		for name, spec := range specs {
+			spec.maxEntries = spec.scaledEntries(scale, pageSize)
+			entries[name] = uint32(spec.maxEntries)
+			_, maxBytes := spec.footprint(numCPU, pageSize)
+			sum += maxBytes
+		}
+		return sum, entries
+	}
+
+	sum, _ := total(1)
+	if sum <= budget {
+		return map[string]uint32{}, nil
+	}
+
+	minSum, minEntries := total(0)
+	if minSum > budget {
+		return nil, fmt.Errorf("maps need at least %d bytes, over the %d bytes budget", minSum, budget)
+	}
+
+	// the footprint isn't linear in max entries (hash buckets and ring
+	// buffers are powers of two, and there are fixed overheads), so try the
+	// proportional scale, then binary search the largest scale that fits
+	// below it, the footprint growing with the scale
+	scale := float64(budget-fixed) / float64(sum-fixed)
+	if sum, entries := total(scale); sum <= budget {
+		return entries, nil
+	}
+	low, high := 0.0, scale
+	entries := minEntries
+	for i := 0; i < 64; i++ {
+		mid := (low + high) / 2
+		if sum, midEntries := total(mid); sum <= budget {
+			low, entries = mid, midEntries
+		} else {
+			high = mid
+		}
+	}
+
+	return entries, nil
+}
+
+// scaledEntries returns the max entries scaled down, respecting the
+// constraints of the map type.
+func (s mapMemorySpec) scaledEntries(scale float64, pageSize uint64) uint64 {
+	entries := uint64(math.Floor(float64(s.maxEntries) * scale))
+
+	switch s.mapType {
+	case MapTypeRingbuf:
+		// a power of two multiple of the page size
+		if entries < pageSize {
+			return pageSize
+		}
+		return 1 << (bits.Len64(entries) - 1)
+	default:
+		if entries < 1 {
+			return 1
+		}
+		return entries
+	}
+}
+
+// footprint estimates the memory charged for the map when it is created and
+// once it is full, following the kernel allocations of each map type.
+func (s mapMemorySpec) footprint(numCPU int, pageSize uint64) (uint64, uint64) {
+	ncpu := uint64(numCPU)
+	key := roundUp(s.keySize, 8)
+	value := roundUp(s.valueSize, 8)
+	entries := s.maxEntries
+	area := func(size uint64) uint64 {
+		return mapStructOverhead + roundUp(size, pageSize)
+	}
+
+	switch s.mapType {
+	case MapTypeArray, MapTypeCgroupArray, MapTypeProgArray, MapTypePerfEventArray,
+		MapTypeArrayOfMaps, MapTypeDevMap, MapTypeCPUMap, MapTypeXSKMap,
+		MapTypeSockMap, MapTypeReusePortSockArray:
+		size := area(entries * value)
+		return size, size
+
+	case MapTypePerCPUArray:
+		// an array of pointers to per-CPU values
+		size := area(entries*8) + entries*value*ncpu
+		return size, size
+
+	case MapTypeHash, MapTypeLRUHash, MapTypePerCPUHash, MapTypeLRUPerCPUHash,
+		MapTypeHashOfMaps, MapTypeDevmapHash, MapTypeSockHash:
+		buckets := area(nextPowerOfTwo(entries) * htabBucketSize)
+		elem := htabElemOverhead + key
+		var perElem uint64
+		percpu := s.mapType == MapTypePerCPUHash || s.mapType == MapTypeLRUPerCPUHash
+		if percpu {
+			elem += 8 // pointer to the per-CPU value
+			perElem = value * ncpu
+		} else {
+			elem += value
+		}
+		lru := s.mapType == MapTypeLRUHash || s.mapType == MapTypeLRUPerCPUHash
+		prealloc := entries
+		if !percpu && !lru {
+			prealloc += ncpu // extra elements kept for updates
+		}
+		full := buckets + entries*(elem+perElem)
+		if s.flags&mapFlagNoPrealloc != 0 && !lru {
+			return buckets, full
+		}
+		size := buckets + prealloc*(elem+perElem)
+		return size, size
+
+	case MapTypeStackTrace:
+		n := nextPowerOfTwo(entries)
+		size := area(n*8) + n*(stackBucketSize+s.valueSize)
+		return size, size
+
+	case MapTypeLPMTrie:
+		// nodes are allocated on demand, up to one intermediate node per entry
+		node := lpmNodeOverhead + s.keySize + s.valueSize
+		return mapStructOverhead, mapStructOverhead + 2*entries*node
+
+	case MapTypeQueue, MapTypeStack:
+		size := area((entries + 1) * s.valueSize)
+		return size, size
+
+	case MapTypeRingbuf:
+		// the data pages plus the consumer and producer pages
+		size := mapStructOverhead + roundUp(entries, pageSize) + 2*pageSize
+		return size, size
+
+	case MapTypeBloomFilter:
+		hashes := s.extra & 0xf
+		if hashes == 0 {
+			hashes = 5
+		}
+		bitsCount := nextPowerOfTwo(uint64(math.Ceil(float64(entries*hashes) / math.Ln2)))
+		size := area(roundUp(bitsCount, 64) / 8)
+		return size, size
+
+	default:
+		// local storages are sized by their owners and struct_ops by the
+		// kernel structure
+		return mapStructOverhead, mapStructOverhead
+	}
+}
+
+func nextPowerOfTwo(x uint64) uint64 {
+	if x <= 1 {
+		return 1
+	}
+	return 1 << bits.Len64(x-1)
+}
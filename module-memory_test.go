@@ -0,0 +1,112 @@
+package libbpfgo
+
+import "testing"
+
+func TestMapFootprint(t *testing.T) {
+	const pageSize = 4096
+	testCases := []struct {
+		name     string
+		spec     mapMemorySpec
+		bytes    uint64
+		maxBytes uint64
+	}{
+		{
+			name:     "array",
+			spec:     mapMemorySpec{mapType: MapTypeArray, keySize: 4, valueSize: 12, maxEntries: 1024},
+			bytes:    mapStructOverhead + 4*pageSize,
+			maxBytes: mapStructOverhead + 4*pageSize,
+		},
+		{
+			name:     "percpu array",
+			spec:     mapMemorySpec{mapType: MapTypePerCPUArray, keySize: 4, valueSize: 8, maxEntries: 512},
+			bytes:    mapStructOverhead + pageSize + 512*8*4,
+			maxBytes: mapStructOverhead + pageSize + 512*8*4,
+		},
+		{
+			name:     "hash",
+			spec:     mapMemorySpec{mapType: MapTypeHash, keySize: 4, valueSize: 8, maxEntries: 1000},
+			bytes:    mapStructOverhead + 4*pageSize + 1004*(htabElemOverhead+16),
+			maxBytes: mapStructOverhead + 4*pageSize + 1004*(htabElemOverhead+16),
+		},
+		{
+			name:     "hash without prealloc",
+			spec:     mapMemorySpec{mapType: MapTypeHash, keySize: 4, valueSize: 8, maxEntries: 1000, flags: mapFlagNoPrealloc},
+			bytes:    mapStructOverhead + 4*pageSize,
+			maxBytes: mapStructOverhead + 4*pageSize + 1000*(htabElemOverhead+16),
+		},
+		{
+			name:     "ringbuf",
+			spec:     mapMemorySpec{mapType: MapTypeRingbuf, maxEntries: 1 << 20},
+			bytes:    mapStructOverhead + 1<<20 + 2*pageSize,
+			maxBytes: mapStructOverhead + 1<<20 + 2*pageSize,
+		},
+	}
+
+	for _, tc := range testCases {
+		t.Run(tc.name, func(t *testing.T) {
+			bytes, maxBytes := tc.spec.footprint(4, pageSize)
+			if bytes != tc.bytes || maxBytes != tc.maxBytes {
+				t.Fatalf("got %d/%d bytes, expected %d/%d", bytes, maxBytes, tc.bytes, tc.maxBytes)
+			}
+		})
+	}
+}
+
+func TestFitMapEntries(t *testing.T) {
+	const pageSize = 4096
+	specs := map[string]mapMemorySpec{
+		"events": {mapType: MapTypeRingbuf, maxEntries: 16 << 20},
+		"procs":  {mapType: MapTypeHash, keySize: 4, valueSize: 64, maxEntries: 65536},
+	}
+
+	entries, err := fitMapEntries(specs, 64<<20, 1<<20, 4, pageSize)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(entries) != 0 {
+		t.Fatalf("expected no change, got %v", entries)
+	}
+
+	budget := uint64(8 << 20)
+	entries, err = fitMapEntries(specs, budget, 1<<20, 4, pageSize)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sum := uint64(1 << 20)
+	for name, spec := range specs {
+		if uint64(entries[name]) >= spec.maxEntries {
+			t.Fatalf("map %s not scaled: %d entries", name, entries[name])
+		}
+		spec.maxEntries = uint64(entries[name])
+		_, maxBytes := spec.footprint(4, pageSize)
+		sum += maxBytes
+	}
+	if sum > budget {
+		t.Fatalf("maps need %d bytes, over the %d bytes budget", sum, budget)
+	}
+	if e := entries["events"]; e&(e-1) != 0 || e%pageSize != 0 {
+		t.Fatalf("ring buffer size %d is not a power of two multiple of the page size", e)
+	}
+
+	if _, err := fitMapEntries(specs, 1<<20, 2<<20, 4, pageSize); err == nil {
+		t.Fatal("expected an error for fixed maps over the budget")
+	}
+
+	// a scale way below the proportional one
+	huge := map[string]mapMemorySpec{
+		"procs": {mapType: MapTypeHash, keySize: 4, valueSize: 64, maxEntries: 1 << 30},
+	}
+	entries, err = fitMapEntries(huge, budget, 1<<20, 4, pageSize)
+	if err != nil {
+		t.Fatal(err)
+	}
+	spec := huge["procs"]
+	spec.maxEntries = uint64(entries["procs"])
+	if _, maxBytes := spec.footprint(4, pageSize); maxBytes+1<<20 > budget || entries["procs"] < 1024 {
+		t.Fatalf("got %d entries of %d bytes for a %d bytes budget", entries["procs"], maxBytes, budget)
+	}
+
+	if _, err := fitMapEntries(huge, 1<<20+1024, 1<<20, 4, pageSize); err == nil {
+		t.Fatal("expected an error for maps over the budget at their minimum")
+	}
+}
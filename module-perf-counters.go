@@ -0,0 +1,225 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"sync"
+	"syscall"
+	"unsafe"
+)
+
+//
+// Hardware counters
+//
+
+// PerfCounterEvent is a counter read by bpf_perf_event_read_value().
+type PerfCounterEvent int
+
+const (
+	PerfCounterCycles PerfCounterEvent = iota
+	PerfCounterInstructions
+	// PerfCounterCacheMisses counts the last level cache misses.
+	PerfCounterCacheMisses
+	PerfCounterBranchMisses
+	// PerfCounterCPUClock is a software counter, also available in virtual
+	// machines.
+	PerfCounterCPUClock
+)
+
+func (e PerfCounterEvent) String() string {
+	switch e {
+	case PerfCounterCycles:
+		return "cycles"
+	case PerfCounterInstructions:
+		return "instructions"
+	case PerfCounterCacheMisses:
+		return "cache-misses"
+	case PerfCounterBranchMisses:
+		return "branch-misses"
+	case PerfCounterCPUClock:
+		return "cpu-clock"
+	default:
+		return fmt.Sprintf("PerfCounterEvent(%d)", int(e))
+	}
+}
+
+func (e PerfCounterEvent) typeConfig() (uint32, uint64, error) {
+	switch e {
+	case PerfCounterCycles:
+		return C.PERF_TYPE_HARDWARE, C.PERF_COUNT_HW_CPU_CYCLES, nil
+	case PerfCounterInstructions:
+		return C.PERF_TYPE_HARDWARE, C.PERF_COUNT_HW_INSTRUCTIONS, nil
+	case PerfCounterCacheMisses:
+		return C.PERF_TYPE_HARDWARE, C.PERF_COUNT_HW_CACHE_MISSES, nil
+	case PerfCounterBranchMisses:
+		return C.PERF_TYPE_HARDWARE, C.PERF_COUNT_HW_BRANCH_MISSES, nil
+	case PerfCounterCPUClock:
+		return C.PERF_TYPE_SOFTWARE, C.PERF_COUNT_SW_CPU_CLOCK, nil
+	default:
+		return 0, 0, fmt.Errorf("unknown perf counter event %d", int(e))
+	}
+}
+
+// PerfCounter is a counter and the BPF_MAP_TYPE_PERF_EVENT_ARRAY map, indexed
+// by CPU, the programs read it from (e.g. with
+// bpf_perf_event_read_value(&map, BPF_F_CURRENT_CPU, ...)).
+type PerfCounter struct {
+	Map   string
+	Event PerfCounterEvent
+}
+
+// PerfCounters opens counters on every online CPU and puts them in their
+// perf event array maps. The counters of a CPU form a group, the first one
+// leading, so they are scheduled together and their ratios are meaningful
+// (e.g. instructions per cycle). It is safe for concurrent use.
+type PerfCounters struct {
+	module   *Module
+	counters []PerfCounter
+	maps     []*BPFMap
+	mu       sync.Mutex
+	fds      map[int][]int // cpu to the fds of its counters
+	closed   bool
+}
+
+// NewPerfCounters opens the counters on every online CPU. It must be called
+// after the BPF object is loaded. The counters are closed with the module.
+func (m *Module) NewPerfCounters(counters []PerfCounter) (*PerfCounters, error) {
+	if !m.loaded {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+	if len(counters) == 0 {
+		return nil, errors.New("perf counters need at least one counter")
+	}
+
+	p := &PerfCounters{
+		module:   m,
+		counters: counters,
+		fds:      make(map[int][]int),
+	}
+	for _, counter := range counters {
+		if _, _, err := counter.Event.typeConfig(); err != nil {
+			return nil, err
+		}
+		bpfMap, err := m.GetMap(counter.Map)
+		if err != nil {
+			return nil, err
+		}
+		if bpfMap.Type() != MapTypePerfEventArray {
+			return nil, fmt.Errorf("map %s must be a perf event array", counter.Map)
+		}
+		p.maps = append(p.maps, bpfMap)
+	}
+
+	if err := p.Refresh(); err != nil {
+		p.Close()
+		return nil, err
+	}
+	m.counters = append(m.counters, p)
+
+	return p, nil
+}
+
+// Refresh opens the counters of the CPUs which came online and closes the
+// ones of the CPUs which went offline since the previous refresh, to follow
+// CPU hotplug.
+func (p *PerfCounters) Refresh() error {
+	cpus, err := onlineCPUs()
+	if err != nil {
+		return err
+	}
+
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.closed {
+		return errors.New("perf counters are closed")
+	}
+
+	online := make(map[int]bool, len(cpus))
+	for _, cpu := range cpus {
+		online[cpu] = true
+	}
+	for cpu := range p.fds {
+		if !online[cpu] {
+			p.closeCPU(cpu)
+		}
+	}
+	for _, cpu := range cpus {
+		if _, ok := p.fds[cpu]; ok {
+			continue
+		}
+		if err := p.openCPU(cpu); err != nil {
+			return err
+		}
+	}
+
+	return nil
+}
+
+func (p *PerfCounters) openCPU(cpu int) error {
+	fds := make([]int, 0, len(p.counters))
+	leader := -1
+	for i, counter := range p.counters {
+		eventType, eventConfig, _ := counter.Event.typeConfig()
+		fdC, errno := C.cgo_perf_event_open_counter(C.__u32(eventType), C.__u64(eventConfig), C.int(cpu), C.int(leader))
+		if fdC < 0 {
+			p.fds[cpu] = fds
+			p.closeCPU(cpu)
+			return fmt.Errorf("failed to open %s counter on cpu %d: %w", counter.Event, cpu, errno)
+		}
+		fd := int(fdC)
+		fds = append(fds, fd)
+		if i == 0 {
+			leader = fd
+		}
+
+		key := uint32(cpu)
+		value := uint32(fd)
+		if err := p.maps[i].Update(unsafe.Pointer(&key), unsafe.Pointer(&value)); err != nil {
+			p.fds[cpu] = fds
+			p.closeCPU(cpu)
+			return err
+		}
+	}
+	p.fds[cpu] = fds
+
+	return nil
+}
+
+func (p *PerfCounters) closeCPU(cpu int) {
+	key := uint32(cpu)
+	fds := p.fds[cpu]
+	for i := len(fds) - 1; i >= 0; i-- { // the group leader last
+		_ = p.maps[i].DeleteKey(unsafe.Pointer(&key))
+		_ = syscall.Close(fds[i])
+	}
+	delete(p.fds, cpu)
+}
+
+// CPUs returns the number of CPUs the counters are open on.
+func (p *PerfCounters) CPUs() int {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	return len(p.fds)
+}
+
+// Close removes the counters from their maps and closes them.
+func (p *PerfCounters) Close() {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.closed {
+		return
+	}
+	for cpu := range p.fds {
+		p.closeCPU(cpu)
+	}
+	p.closed = true
+}
@@ -0,0 +1,508 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"syscall"
+	"unsafe"
+)
+
+//
+// Module persistence (pin and restore)
+//
+
+const persistManifestName = "manifest.json"
+
+// persistManifest records the objects pinned by Module.Persist, with paths
+// relative to the persistence directory.
+type persistManifest struct {
+	Hash  string            `json:"hash"`
+	Maps  map[string]string `json:"maps"`
+	Progs map[string]string `json:"progs"`
+	Links []persistLink     `json:"links"`
+}
+
+type persistLink struct {
+	Prog      string   `json:"prog"`
+	LinkType  LinkType `json:"linkType"`
+	EventName string   `json:"eventName"`
+	Path      string   `json:"path"`
+}
+
+type modulePersistence struct {
+	dir      string
+	hash     string
+	restored bool
+	progFDs  map[*C.struct_bpf_program]int // restored programs
+}
+
+// BPFLoadObjectPersistent loads the BPF object or, if the same object was
+// persisted to pinDir (a bpffs directory) by Module.Persist, restores it: its
+// maps and programs are reopened from their pins and its links from theirs,
+// so restarts skip the program verification and map creation and the
+// programs keep running meanwhile. It returns whether the object was restored.
+//
+// The object is fully loaded when it, or its configuration (e.g. map initial
+// values and max entries), differs from the persisted one, or when the pins
+// are incomplete.
+//
+// Restored programs aren't loaded by libbpf, so they can only be attached
+// through their file descriptor (e.g. AttachGenericFD).
+func (m *Module) BPFLoadObjectPersistent(pinDir string) (bool, error) {
+	if m.loaded {
+		return false, errors.New("must be called before the BPF object is loaded")
+	}
+
+	m.persistence = &modulePersistence{
+		dir:  pinDir,
+		hash: m.objectHash(),
+	}
+
+	manifest, err := readPersistManifest(pinDir)
+	if err != nil || manifest.Hash != m.persistence.hash {
+		return false, m.BPFLoadObject()
+	}
+
+	restored, err := m.restore(manifest)
+	if err != nil {
+		return false, err
+	}
+	if !restored {
+		return false, m.BPFLoadObject()
+	}
+
+	return true, nil
+}
+
+// restore reopens the pinned maps, programs and links and loads the object
+// reusing them. It returns false, leaving the object untouched, if a pin is
+// missing.
+func (m *Module) restore(manifest *persistManifest) (bool, error) {
+	dir := m.persistence.dir
+	mapFDs := make(map[string]int, len(manifest.Maps))
+	progFDs := make(map[string]int, len(manifest.Progs))
+	closeFDs := func(fds map[string]int) {
+		for _, fd := range fds {
+			_ = syscall.Close(fd)
+		}
+	}
+	defer closeFDs(mapFDs) // maps reuse a duplicate
+
+	for name, path := range manifest.Maps {
+		fd, err := objGet(filepath.Join(dir, path))
+		if err != nil {
+			return false, nil
+		}
+		mapFDs[name] = fd
+	}
+	for name, path := range manifest.Progs {
+		fd, err := objGet(filepath.Join(dir, path))
+		if err != nil {
+			closeFDs(progFDs)
+			return false, nil
+		}
+		progFDs[name] = fd
+	}
+
+	// open the links before loading, which can't be undone, so that missing
+	// pins still fall back to a fresh load
+	type restoredLink struct {
+		persistLink
+		prog *BPFProg
+		link *C.struct_bpf_link
+		path string
+	}
+	links := make([]restoredLink, 0, len(manifest.Links))
+	linksRestored := false
+	defer func() {
+		if linksRestored {
+			return
+		}
+		for _, l := range links {
+			C.bpf_link__destroy(l.link) // only closes the fd, the pin holds the link
+		}
+	}()
+	for _, l := range manifest.Links {
+		prog, err := m.GetProgram(l.Prog)
+		if err != nil {
+			closeFDs(progFDs)
+			return false, fmt.Errorf("failed to restore link %s: %w", l.EventName, err)
+		}
+
+		path := filepath.Join(dir, l.Path)
+		pathC := C.CString(path)
+		linkC := C.bpf_link__open(pathC)
+		C.free(unsafe.Pointer(pathC))
+		if linkC == nil {
+			closeFDs(progFDs)
+			return false, nil
+		}
+		links = append(links, restoredLink{persistLink: l, prog: prog, link: linkC, path: path})
+	}
+
+	m.persistence.progFDs = make(map[*C.struct_bpf_program]int, len(progFDs))
+	for name, fd := range progFDs {
+		prog, err := m.GetProgram(name)
+		if err == nil {
+			err = prog.SetAutoload(false)
+		}
+		if err != nil {
+			closeFDs(progFDs)
+			return false, fmt.Errorf("failed to restore program %s: %w", name, err)
+		}
+		m.persistence.progFDs[prog.prog] = fd
+	}
+	for name, fd := range mapFDs {
+		bpfMap, err := m.GetMap(name)
+		if err == nil {
+			err = bpfMap.ReuseFD(fd)
+		}
+		if err != nil {
+			return false, fmt.Errorf("failed to restore map %s: %w", name, err)
+		}
+	}
+
+	if err := m.BPFLoadObject(); err != nil {
+		return false, err
+	}
+
+	for _, l := range links {
+		m.addLink(&BPFLink{
+			link:      l.link,
+			prog:      l.prog,
+			linkType:  l.LinkType,
+			eventName: l.EventName,
+			pinPath:   l.path,
+		})
+	}
+	linksRestored = true
+	m.persistence.restored = true
+
+	return true, nil
+}
+
+// Persist pins the maps, programs and links of a module loaded with
+// BPFLoadObjectPersistent and records them in a manifest, so the next
+// instance of the object restores them. It should be called once all the
+// links are attached. Pinned links stay attached when the module is closed.
+//
+// The pins of a different object persisted to the same directory are
+// replaced, detaching its links only then, so there is no gap in between.
+// Only the pins listed in the manifest are removed, and a non-empty directory
+// without a manifest is refused, so pinDir can't be shared by mistake.
+func (m *Module) Persist() error {
+	p := m.persistence
+	if p == nil || !m.loaded {
+		return errors.New("must be called after the BPF object is loaded with BPFLoadObjectPersistent")
+	}
+
+	if !p.restored {
+		if err := removePersistedPins(p.dir); err != nil {
+			return fmt.Errorf("failed to remove stale pins from %s: %w", p.dir, err)
+		}
+	}
+	for _, sub := range persistSubdirs {
+		if err := os.MkdirAll(filepath.Join(p.dir, sub), 0700); err != nil {
+			return fmt.Errorf("failed to create pin directory: %w", err)
+		}
+	}
+
+	manifest := persistManifest{
+		Hash:  p.hash,
+		Maps:  make(map[string]string),
+		Progs: make(map[string]string),
+	}
+
+	it := m.Iterator()
+	for bpfMap := it.NextMap(); bpfMap != nil; bpfMap = it.NextMap() {
+		fd := bpfMap.FileDescriptor()
+		if fd < 0 {
+			continue // not created
+		}
+		rel := filepath.Join("maps", bpfMap.Name())
+		if err := pinFD(fd, filepath.Join(p.dir, rel)); err != nil {
+			return fmt.Errorf("failed to pin map %s: %w", bpfMap.Name(), err)
+		}
+		manifest.Maps[bpfMap.Name()] = rel
+	}
+	for prog := it.NextProgram(); prog != nil; prog = it.NextProgram() {
+		fd := prog.FileDescriptor()
+		if fd < 0 {
+			continue // not loaded
+		}
+		rel := filepath.Join("progs", prog.Name())
+		if err := pinFD(fd, filepath.Join(p.dir, rel)); err != nil {
+			return fmt.Errorf("failed to pin program %s: %w", prog.Name(), err)
+		}
+		manifest.Progs[prog.Name()] = rel
+	}
+
+	m.linksMu.Lock()
+	links := make([]*BPFLink, len(m.links))
+	copy(links, m.links)
+	m.linksMu.Unlock()
+
+	for i, link := range links {
+		if link.link == nil && link.legacy == nil {
+			continue // destroyed
+		}
+		if link.legacy != nil {
+			return fmt.Errorf("failed to pin link %s: legacy links can't be pinned", link.eventName)
+		}
+		if link.pinPath == "" {
+			path := filepath.Join(p.dir, "links", fmt.Sprintf("%d-%s", i, link.prog.Name()))
+			for n := 1; fileExists(path); n++ {
+				path = filepath.Join(p.dir, "links", fmt.Sprintf("%d.%d-%s", i, n, link.prog.Name()))
+			}
+			if err := link.Pin(path); err != nil {
+				return err
+			}
+		}
+		rel, err := filepath.Rel(p.dir, link.pinPath)
+		if err != nil {
+			return fmt.Errorf("failed to pin link %s: %w", link.eventName, err)
+		}
+		manifest.Links = append(manifest.Links, persistLink{
+			Prog:      link.prog.Name(),
+			LinkType:  link.linkType,
+			EventName: link.eventName,
+			Path:      rel,
+		})
+	}
+
+	return writePersistManifest(p.dir, &manifest)
+}
+
+// Unpersist removes the pins of the module, so its links are detached when
+// the module is closed and the next instance is fully loaded.
+func (m *Module) Unpersist() error {
+	p := m.persistence
+	if p == nil {
+		return errors.New("must be called after the BPF object is loaded with BPFLoadObjectPersistent")
+	}
+	m.linksMu.Lock()
+	for _, link := range m.links {
+		link.pinPath = ""
+	}
+	m.linksMu.Unlock()
+	if err := removePersistedPins(p.dir); err != nil {
+		return fmt.Errorf("failed to remove pins from %s: %w", p.dir, err)
+	}
+
+	return nil
+}
+
+// persistSubdirs are the directories of the pins, relative to the
+// persistence directory.
+var persistSubdirs = []string{"maps", "progs", "links"}
+
+// removePersistedPins removes the pins listed in the manifest of dir, then
+// the manifest. The other entries of dir are left alone: a non-empty
+// directory without a manifest isn't ours, and is refused.
+func removePersistedPins(dir string) error {
+	manifest, err := readPersistManifest(dir)
+	if errors.Is(err, os.ErrNotExist) {
+		empty, err := persistDirIsEmpty(dir)
+		if err != nil {
+			return err
+		}
+		if !empty {
+			return fmt.Errorf("%s is not empty and has no %s", dir, persistManifestName)
+		}
+		return nil
+	}
+	if err != nil {
+		return fmt.Errorf("failed to read %s: %w", persistManifestName, err)
+	}
+
+	paths := make([]string, 0, len(manifest.Maps)+len(manifest.Progs)+len(manifest.Links))
+	for _, path := range manifest.Maps {
+		paths = append(paths, path)
+	}
+	for _, path := range manifest.Progs {
+		paths = append(paths, path)
+	}
+	for _, l := range manifest.Links {
+		paths = append(paths, l.Path)
+	}
+	for _, path := range paths {
+		if !isPersistPath(path) {
+			return fmt.Errorf("invalid pin path %s in %s", path, persistManifestName)
+		}
+		if err := os.Remove(filepath.Join(dir, path)); err != nil && !errors.Is(err, os.ErrNotExist) {
+			return err
+		}
+	}
+	if err := os.Remove(filepath.Join(dir, persistManifestName)); err != nil && !errors.Is(err, os.ErrNotExist) {
+		return err
+	}
+	for _, sub := range persistSubdirs {
+		_ = os.Remove(filepath.Join(dir, sub)) // only if empty
+	}
+
+	return nil
+}
+
+// isPersistPath tells whether the manifest path is a pin of the persistence
+// subdirectories.
+func isPersistPath(path string) bool {
+	sub, name := filepath.Split(filepath.Clean(path))
+	if name == "" || name == "." || name == ".." {
+		return false
+	}
+	for _, s := range persistSubdirs {
+		if sub == s+"/" {
+			return true
+		}
+	}
+
+	return false
+}
+
+// persistDirIsEmpty tells whether dir is missing or has nothing but empty
+// persistence subdirectories.
+func persistDirIsEmpty(dir string) (bool, error) {
+	entries, err := os.ReadDir(dir)
+	if errors.Is(err, os.ErrNotExist) {
+		return true, nil
+	}
+	if err != nil {
+		return false, err
+	}
+	for _, entry := range entries {
+		isSubdir := false
+		for _, s := range persistSubdirs {
+			isSubdir = isSubdir || (entry.IsDir() && entry.Name() == s)
+		}
+		if !isSubdir {
+			return false, nil
+		}
+		subEntries, err := os.ReadDir(filepath.Join(dir, entry.Name()))
+		if err != nil {
+			return false, err
+		}
+		if len(subEntries) > 0 {
+			return false, nil
+		}
+	}
+
+	return true, nil
+}
+
+// objectHash identifies the object together with its load configuration,
+// which must both match for pinned objects to be reused.
+func (m *Module) objectHash() string {
+	h := sha256.New()
+	fmt.Fprintf(h, "libbpf %s\n", LibbpfVersionString())
+
+	for mapC := C.bpf_object__next_map(m.obj, nil); mapC != nil; mapC = C.bpf_object__next_map(m.obj, mapC) {
+		fmt.Fprintf(h, "map %s %d %d %d %d %d %t\n",
+			C.GoString(C.bpf_map__name(mapC)),
+			C.bpf_map__type(mapC),
+			C.bpf_map__key_size(mapC),
+			C.bpf_map__value_size(mapC),
+			C.bpf_map__max_entries(mapC),
+			C.bpf_map__map_flags(mapC),
+			bool(C.bpf_map__autocreate(mapC)),
+		)
+		var sizeC C.size_t
+		if dataC := C.bpf_map__initial_value(mapC, &sizeC); dataC != nil {
+			h.Write(C.GoBytes(dataC, C.int(sizeC)))
+		}
+	}
+
+	for progC := C.bpf_object__next_program(m.obj, nil); progC != nil; progC = C.bpf_object__next_program(m.obj, progC) {
+		fmt.Fprintf(h, "prog %s %s %d %d %t\n",
+			C.GoString(C.bpf_program__name(progC)),
+			C.GoString(C.bpf_program__section_name(progC)),
+			C.bpf_program__type(progC),
+			C.bpf_program__expected_attach_type(progC),
+			bool(C.bpf_program__autoload(progC)),
+		)
+		insnsC := C.bpf_program__insns(progC)
+		insnCnt := C.bpf_program__insn_cnt(progC)
+		if insnsC != nil {
+			h.Write(C.GoBytes(unsafe.Pointer(insnsC), C.int(insnCnt*8)))
+		}
+	}
+
+	return hex.EncodeToString(h.Sum(nil))
+}
+
+func readPersistManifest(dir string) (*persistManifest, error) {
+	content, err := os.ReadFile(filepath.Join(dir, persistManifestName))
+	if err != nil {
+		return nil, err
+	}
+
+	manifest := &persistManifest{}
+	if err := json.Unmarshal(content, manifest); err != nil {
+		return nil, err
+	}
+
+	return manifest, nil
+}
+
+func writePersistManifest(dir string, manifest *persistManifest) error {
+	content, err := json.Marshal(manifest)
+	if err != nil {
+		return fmt.Errorf("failed to encode manifest: %w", err)
+	}
+
+	// write and rename so a crash never leaves a partial manifest
+	path := filepath.Join(dir, persistManifestName)
+	if err := os.WriteFile(path+".tmp", content, 0600); err != nil {
+		return fmt.Errorf("failed to write manifest: %w", err)
+	}
+	if err := os.Rename(path+".tmp", path); err != nil {
+		return fmt.Errorf("failed to write manifest: %w", err)
+	}
+
+	return nil
+}
+
+func objGet(path string) (int, error) {
+	pathC := C.CString(path)
+	defer C.free(unsafe.Pointer(pathC))
+
+	fdC := C.bpf_obj_get(pathC)
+	if fdC < 0 {
+		return -1, syscall.Errno(-fdC)
+	}
+
+	return int(fdC), nil
+}
+
+// pinFD pins fd to path, unless something (e.g. the same object, when
+// restored) is already pinned there.
+func pinFD(fd int, path string) error {
+	if fileExists(path) {
+		return nil
+	}
+
+	pathC := C.CString(path)
+	defer C.free(unsafe.Pointer(pathC))
+
+	retC := C.bpf_obj_pin(C.int(fd), pathC)
+	if retC < 0 {
+		return syscall.Errno(-retC)
+	}
+
+	return nil
+}
+
+func fileExists(path string) bool {
+	_, err := os.Stat(path)
+	return err == nil
+}
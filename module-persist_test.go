@@ -0,0 +1,82 @@
+package libbpfgo
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestRemovePersistedPins(t *testing.T) {
+	dir := t.TempDir()
+	for _, path := range []string{"maps/m", "progs/p", "links/0-p", "maps/foreign", "other"} {
+		if err := os.MkdirAll(filepath.Join(dir, filepath.Dir(path)), 0700); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(filepath.Join(dir, path), nil, 0600); err != nil {
+			t.Fatal(err)
+		}
+	}
+
+	// not ours without a manifest
+	if err := removePersistedPins(dir); err == nil {
+		t.Fatal("expected a non-empty directory without manifest to be refused")
+	}
+
+	err := writePersistManifest(dir, &persistManifest{
+		Maps:  map[string]string{"m": "maps/m"},
+		Progs: map[string]string{"p": "progs/p"},
+		Links: []persistLink{{Path: "links/0-p"}, {Path: "links/missing"}},
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := removePersistedPins(dir); err != nil {
+		t.Fatal(err)
+	}
+	for _, path := range []string{"maps/m", "progs/p", "links/0-p", "progs", "links", persistManifestName} {
+		if fileExists(filepath.Join(dir, path)) {
+			t.Fatalf("expected %s to be removed", path)
+		}
+	}
+	for _, path := range []string{"maps/foreign", "other"} {
+		if !fileExists(filepath.Join(dir, path)) {
+			t.Fatalf("expected %s to be kept", path)
+		}
+	}
+
+	// paths out of the pin directories are rejected
+	err = writePersistManifest(dir, &persistManifest{Maps: map[string]string{"m": "../other"}})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := removePersistedPins(dir); err == nil {
+		t.Fatal("expected a path out of the pin directories to be rejected")
+	}
+}
+
+func TestPersistDirIsEmpty(t *testing.T) {
+	dir := t.TempDir()
+	for _, tc := range []struct {
+		setup func(dir string) error
+		empty bool
+	}{
+		{func(dir string) error { return nil }, true},
+		{func(dir string) error { return os.Mkdir(filepath.Join(dir, "maps"), 0700) }, true},
+		{func(dir string) error { return os.WriteFile(filepath.Join(dir, "maps", "m"), nil, 0600) }, false},
+	} {
+		if err := tc.setup(dir); err != nil {
+			t.Fatal(err)
+		}
+		empty, err := persistDirIsEmpty(dir)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if empty != tc.empty {
+			t.Fatalf("expected empty %t, got %t", tc.empty, empty)
+		}
+	}
+
+	if empty, err := persistDirIsEmpty(filepath.Join(dir, "missing")); err != nil || !empty {
+		t.Fatalf("expected a missing directory to be empty, got %t, %v", empty, err)
+	}
+}
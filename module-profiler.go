@@ -0,0 +1,386 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"os"
+	"strconv"
+	"strings"
+	"sync"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+//
+// Sampling CPU profiler
+//
+
+// ProfilerEvent is the perf event sampling the CPUs.
+type ProfilerEvent int
+
+const (
+	// ProfilerEventCPUClock samples the CPU clock, a software event which is
+	// also available in virtual machines.
+	ProfilerEventCPUClock ProfilerEvent = iota
+	// ProfilerEventCycles samples the CPU cycles, a hardware event.
+	ProfilerEventCycles
+)
+
+// defaultProfilerFrequency is a prime frequency, so sampling doesn't run in
+// lockstep with periodic activity, low enough to cost well under 1% of a CPU.
+const defaultProfilerFrequency = 49
+
+// profilerDrainBatch is the number of counts drained by a batch operation.
+const profilerDrainBatch = 1024
+
+// profilerStacksFull is the fraction of the stack trace map in use, in
+// percent, past which the map is cleared: bpf_get_stackid fails with EEXIST
+// on hash collisions well before the map is full.
+const profilerStacksFull = 75
+
+// ProfilerOpts configures a Profiler.
+type ProfilerOpts struct {
+	// Prog is the SEC("perf_event") program counting the samples.
+	Prog string
+	// CountsMap is a hash map counting the samples (__u64 values) by
+	//
+	//	struct {
+	//		__u32 pid;
+	//		__s32 user_stack_id;   // bpf_get_stackid(ctx, &stacks, BPF_F_USER_STACK)
+	//		__s32 kernel_stack_id; // bpf_get_stackid(ctx, &stacks, 0)
+	//	};
+	CountsMap string
+	// StacksMap is the BPF_MAP_TYPE_STACK_TRACE map of the stack ids.
+	StacksMap string
+	Event     ProfilerEvent
+	// Frequency is the number of samples per second per CPU, 49 if zero.
+	Frequency uint64
+}
+
+// ProfileSample is the number of samples of a stack.
+type ProfileSample struct {
+	Pid uint32
+	// UserStack and KernelStack are the instruction pointers of the stacks,
+	// innermost first, nil if the stack couldn't be collected.
+	UserStack   []uint64
+	KernelStack []uint64
+	Count       uint64
+}
+
+type profileKey struct {
+	Pid           uint32
+	UserStackID   int32
+	KernelStackID int32
+}
+
+// Profiler samples every online CPU through a perf event running a program,
+// which counts the stacks in kernel, so that only the aggregated counts are
+// read.
+type Profiler struct {
+	module *Module
+	counts *BPFMap
+	stacks *BPFMap
+	links  []*BPFLink
+	mu     sync.Mutex // serializes the drains, protects cached
+	// cached are the stacks read so far by id, which stay valid until the
+	// stack trace map is cleared.
+	cached map[int32][]uint64
+	task   periodicTask
+}
+
+// NewProfiler opens a sampling perf event on every online CPU and attaches
+// the program to each. It must be called after the BPF object is loaded.
+func (m *Module) NewProfiler(opts ProfilerOpts) (*Profiler, error) {
+	if !m.loaded {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+	prog, err := m.GetProgram(opts.Prog)
+	if err != nil {
+		return nil, err
+	}
+	counts, err := m.GetMap(opts.CountsMap)
+	if err != nil {
+		return nil, err
+	}
+	if counts.KeySize() != int(unsafe.Sizeof(profileKey{})) || counts.ValueSize() != 8 {
+		return nil, fmt.Errorf("map %s must have profile keys and __u64 values", opts.CountsMap)
+	}
+	stacks, err := m.GetMap(opts.StacksMap)
+	if err != nil {
+		return nil, err
+	}
+	if stacks.Type() != MapTypeStackTrace {
+		return nil, fmt.Errorf("map %s must be a stack trace map", opts.StacksMap)
+	}
+
+	var eventType, eventConfig uint64
+	switch opts.Event {
+	case ProfilerEventCPUClock:
+		eventType, eventConfig = C.PERF_TYPE_SOFTWARE, C.PERF_COUNT_SW_CPU_CLOCK
+	case ProfilerEventCycles:
+		eventType, eventConfig = C.PERF_TYPE_HARDWARE, C.PERF_COUNT_HW_CPU_CYCLES
+	default:
+		return nil, fmt.Errorf("unknown profiler event %d", opts.Event)
+	}
+	frequency := opts.Frequency
+	if frequency == 0 {
+		frequency = defaultProfilerFrequency
+	}
+
+	cpus, err := onlineCPUs()
+	if err != nil {
+		return nil, err
+	}
+
+	p := &Profiler{
+		module: m,
+		counts: counts,
+		stacks: stacks,
+		cached: make(map[int32][]uint64),
+	}
+	for _, cpu := range cpus {
+		fdC, errno := C.cgo_perf_event_open_sampling(C.__u32(eventType), C.__u64(eventConfig), C.__u64(frequency), C.int(cpu))
+		if fdC < 0 {
+			p.detach()
+			return nil, fmt.Errorf("failed to open perf event on cpu %d: %w", cpu, errno)
+		}
+		// the link owns the perf event once attached
+		link, err := prog.AttachPerfEvent(int(fdC))
+		if err != nil {
+			syscall.Close(int(fdC))
+			p.detach()
+			return nil, err
+		}
+		p.links = append(p.links, link)
+	}
+
+	return p, nil
+}
+
+func (p *Profiler) detach() error {
+	var firstErr error
+	for _, link := range p.links {
+		if err := link.Destroy(); err != nil && firstErr == nil {
+			firstErr = err
+		}
+		p.module.removeLink(link)
+	}
+	p.links = nil
+
+	return firstErr
+}
+
+// onlineCPUs returns the online CPUs.
+func onlineCPUs() ([]int, error) {
+	data, err := os.ReadFile("/sys/devices/system/cpu/online")
+	if err != nil {
+		return nil, fmt.Errorf("failed to read online cpus: %w", err)
+	}
+
+	return parseCPUList(string(data))
+}
+
+// parseCPUList parses a CPU list, such as "0-3,5,7-8".
+func parseCPUList(list string) ([]int, error) {
+	var cpus []int
+	for _, r := range strings.Split(strings.TrimSpace(list), ",") {
+		if r == "" {
+			continue
+		}
+		first, last, isRange := strings.Cut(r, "-")
+		start, err := strconv.Atoi(first)
+		if err != nil {
+			return nil, fmt.Errorf("invalid cpu list %q", list)
+		}
+		end := start
+		if isRange {
+			if end, err = strconv.Atoi(last); err != nil || end < start {
+				return nil, fmt.Errorf("invalid cpu list %q", list)
+			}
+		}
+		for cpu := start; cpu <= end; cpu++ {
+			cpus = append(cpus, cpu)
+		}
+	}
+
+	return cpus, nil
+}
+
+// Drain reads and resets the counts. The stacks are kept, since the counts
+// of the next drains may still refer to them, until the stack trace map
+// fills up: it is then cleared, and the few samples counted meanwhile may
+// lose their stacks.
+func (p *Profiler) Drain() ([]ProfileSample, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	keys, values, err := p.drainCounts()
+	if err != nil {
+		return nil, err
+	}
+
+	full := false
+	stack := func(id int32) []uint64 {
+		if id < 0 {
+			// e.g. -EFAULT for kernel threads user stacks, or -EEXIST on a
+			// hash collision of the stack trace map
+			full = full || id == -int32(syscall.EEXIST)
+			return nil
+		}
+		s, ok := p.cached[id]
+		if !ok {
+			key := uint32(id)
+			value, err := p.stacks.GetValue(unsafe.Pointer(&key))
+			if err == nil {
+				s = decodeStack(value)
+			}
+			p.cached[id] = s
+		}
+		return s
+	}
+
+	samples := make([]ProfileSample, 0, len(keys))
+	for i, key := range keys {
+		samples = append(samples, ProfileSample{
+			Pid:         key.Pid,
+			UserStack:   stack(key.UserStackID),
+			KernelStack: stack(key.KernelStackID),
+			Count:       values[i],
+		})
+	}
+
+	if full || uint64(len(p.cached))*100 >= uint64(p.stacks.MaxEntries())*profilerStacksFull {
+		p.clearStacks()
+	}
+
+	return samples, nil
+}
+
+// clearStacks deletes every stack of the stack trace map, right after the
+// counts referring to them were drained, since stack ids are reused once
+// deleted.
+func (p *Profiler) clearStacks() {
+	var ids []uint32
+	it := p.stacks.Iterator()
+	for it.Next() {
+		ids = append(ids, *(*uint32)(unsafe.Pointer(&it.Key()[0])))
+	}
+	for _, id := range ids {
+		id := id
+		_ = p.stacks.DeleteKey(unsafe.Pointer(&id))
+	}
+	p.cached = make(map[int32][]uint64)
+}
+
+// drainCounts reads and deletes the counts, through batch operations when
+// the kernel supports them (5.6 and later).
+func (p *Profiler) drainCounts() ([]profileKey, []uint64, error) {
+	var (
+		allKeys   []profileKey
+		allValues []uint64
+		startKey  unsafe.Pointer
+		nextKey   = make([]byte, p.counts.KeySize())
+		keys      = make([]profileKey, profilerDrainBatch)
+	)
+	for {
+		values, err := p.counts.GetValueAndDeleteBatch(unsafe.Pointer(&keys[0]), startKey, unsafe.Pointer(&nextKey[0]), profilerDrainBatch)
+		if err != nil {
+			if len(allKeys) == 0 && (errors.Is(err, syscall.EINVAL) || errors.Is(err, errnoNotSupported)) {
+				return p.drainCountsOneByOne()
+			}
+			return nil, nil, err
+		}
+		for i, value := range values {
+			allKeys = append(allKeys, keys[i])
+			allValues = append(allValues, *(*uint64)(unsafe.Pointer(&value[0])))
+		}
+		if len(values) < profilerDrainBatch {
+			break // partial batch: the map was read
+		}
+		startKey = unsafe.Pointer(&nextKey[0])
+	}
+
+	return allKeys, allValues, nil
+}
+
+func (p *Profiler) drainCountsOneByOne() ([]profileKey, []uint64, error) {
+	var keys []profileKey
+	it := p.counts.Iterator()
+	for it.Next() {
+		keys = append(keys, *(*profileKey)(unsafe.Pointer(&it.Key()[0])))
+	}
+	if err := it.Err(); err != nil {
+		return nil, nil, err
+	}
+
+	values := make([]uint64, 0, len(keys))
+	drained := keys[:0]
+	for _, key := range keys {
+		key := key
+		value, err := p.counts.GetValue(unsafe.Pointer(&key))
+		if err != nil {
+			continue // deleted meanwhile
+		}
+		if err := p.counts.DeleteKey(unsafe.Pointer(&key)); err != nil {
+			continue
+		}
+		drained = append(drained, key)
+		values = append(values, *(*uint64)(unsafe.Pointer(&value[0])))
+	}
+
+	return drained, values, nil
+}
+
+// decodeStack decodes a stack trace map value, zero terminated if not full.
+func decodeStack(value []byte) []uint64 {
+	ips := unsafe.Slice((*uint64)(unsafe.Pointer(&value[0])), len(value)/8)
+	n := 0
+	for n < len(ips) && ips[n] != 0 {
+		n++
+	}
+	stack := make([]uint64, n)
+	copy(stack, ips)
+
+	return stack
+}
+
+// Start drains the counts every interval, sending them to ch, until the
+// profiler is stopped or a drain fails. ch is closed when the draining stops,
+// then Err tells why. It fails if the draining is already started.
+func (p *Profiler) Start(interval time.Duration, ch chan<- []ProfileSample) error {
+	return p.task.start(interval, func(stop <-chan struct{}) error {
+		samples, err := p.Drain()
+		if err != nil {
+			return err
+		}
+		select {
+		case ch <- samples:
+		case <-stop:
+		}
+		return nil
+	}, func() { close(ch) })
+}
+
+// Err returns the error that stopped the last draining started by Start, or
+// nil if it was stopped by Stop or is still running.
+func (p *Profiler) Err() error {
+	return p.task.lastErr()
+}
+
+// Stop stops the draining started by Start.
+func (p *Profiler) Stop() {
+	p.task.stopAndWait()
+}
+
+// Close stops the draining and the sampling.
+func (p *Profiler) Close() error {
+	p.Stop()
+	return p.detach()
+}
@@ -0,0 +1,40 @@
+package libbpfgo
+
+import (
+	"encoding/binary"
+	"reflect"
+	"testing"
+)
+
+func TestParseCPUList(t *testing.T) {
+	cpus, err := parseCPUList("0-3,5,7-8\n")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if expected := []int{0, 1, 2, 3, 5, 7, 8}; !reflect.DeepEqual(cpus, expected) {
+		t.Fatalf("expected %v, got %v", expected, cpus)
+	}
+
+	for _, list := range []string{"a", "3-1", "0-"} {
+		if _, err := parseCPUList(list); err == nil {
+			t.Fatalf("expected an error for %q", list)
+		}
+	}
+}
+
+func TestDecodeStack(t *testing.T) {
+	value := make([]byte, 4*8)
+	binary.LittleEndian.PutUint64(value[0:], 0xffffffff81000010)
+	binary.LittleEndian.PutUint64(value[8:], 0xffffffff81000020)
+
+	stack := decodeStack(value)
+	if expected := []uint64{0xffffffff81000010, 0xffffffff81000020}; !reflect.DeepEqual(stack, expected) {
+		t.Fatalf("expected %x, got %x", expected, stack)
+	}
+
+	binary.LittleEndian.PutUint64(value[16:], 3)
+	binary.LittleEndian.PutUint64(value[24:], 4)
+	if stack := decodeStack(value); len(stack) != 4 {
+		t.Fatalf("expected a full stack, got %x", stack)
+	}
+}
@@ -0,0 +1,93 @@
+package libbpfgo
+
+import (
+	"bytes"
+	"debug/elf"
+	"errors"
+	"fmt"
+	"os"
+)
+
+//
+// ModuleTemplate
+//
+
+// ModuleTemplate holds a BPF object read and indexed once, to create many
+// modules from it, e.g. one per tenant with different .rodata constants.
+// Only opening the object in libbpf and loading it are repeated per module.
+//
+// A ModuleTemplate is safe for concurrent use.
+type ModuleTemplate struct {
+	args    NewModuleArgs
+	symbols map[string]Symbol // global variables, shared read-only by the modules
+}
+
+// ModuleInstanceArgs customizes a module created from a ModuleTemplate.
+type ModuleInstanceArgs struct {
+	// GlobalVariables are the initial values of global variables, by name.
+	GlobalVariables map[string]interface{}
+	// MaxEntries are the max entries of maps, by name.
+	MaxEntries map[string]uint32
+}
+
+// NewModuleTemplate reads the object of args (BPFObjBuff, or else the file at
+// BPFObjPath) and indexes its global variable symbols.
+func NewModuleTemplate(args NewModuleArgs) (*ModuleTemplate, error) {
+	if args.BPFObjBuff == nil {
+		buff, err := os.ReadFile(args.BPFObjPath)
+		if err != nil {
+			return nil, fmt.Errorf("failed to read BPF object %s: %w", args.BPFObjPath, err)
+		}
+		args.BPFObjBuff = buff
+		if args.BPFObjName == "" {
+			args.BPFObjName = args.BPFObjPath
+		}
+	}
+	if len(args.BPFObjBuff) == 0 {
+		return nil, errors.New("empty BPF object")
+	}
+
+	e, err := elf.NewFile(bytes.NewReader(args.BPFObjBuff))
+	if err != nil {
+		return nil, fmt.Errorf("failed to parse BPF object %s: %w", args.BPFObjName, err)
+	}
+	defer e.Close()
+
+	symbols, err := getGlobalVariableSymbols(e)
+	if err != nil {
+		return nil, fmt.Errorf("failed to parse BPF object %s symbols: %w", args.BPFObjName, err)
+	}
+
+	return &ModuleTemplate{
+		args:    args,
+		symbols: symbols,
+	}, nil
+}
+
+// NewModule creates a module from the template, with the global variables
+// and map max entries of args. The module is not loaded yet, so it can still
+// be customized before BPFLoadObject.
+func (t *ModuleTemplate) NewModule(args ModuleInstanceArgs) (*Module, error) {
+	m, err := NewModuleFromBufferArgs(t.args)
+	if err != nil {
+		return nil, err
+	}
+	m.globalSymbols = t.symbols
+
+	if err := m.InitGlobalVariables(args.GlobalVariables); err != nil {
+		m.Close()
+		return nil, err
+	}
+	for name, maxEntries := range args.MaxEntries {
+		bpfMap, err := m.GetMap(name)
+		if err == nil {
+			err = bpfMap.SetMaxEntries(maxEntries)
+		}
+		if err != nil {
+			m.Close()
+			return nil, err
+		}
+	}
+
+	return m, nil
+}
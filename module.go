@@ -8,10 +8,10 @@ import "C"
 
 import (
 	"bytes"
-	"debug/elf"
 	"encoding/binary"
 	"errors"
 	"fmt"
+	"sync"
 	"syscall"
 	"unsafe"
 )
@@ -23,10 +23,20 @@ import (
 type Module struct {
 	obj      *C.struct_bpf_object
 	links    []*BPFLink
+	linksMu  sync.Mutex
 	perfBufs []*PerfBuffer
 	ringBufs []*RingBuffer
-	elf      *elf.File
+	counters []*PerfCounters
 	loaded   bool
+	// object source, parsed on demand for the global variable symbols until
+	// the object is loaded
+	objPath       string
+	objBuff       []byte
+	globalSymbols map[string]Symbol
+	// set when loaded with BPFLoadObjectPersistent
+	persistence *modulePersistence
+	// probeCache decides the attach fallbacks, defaultProbeCache if unset
+	probeCache *ProbeCache
 }
 
 //
@@ -38,8 +48,15 @@ type NewModuleArgs struct {
 	BTFObjPath      string
 	BPFObjName      string
 	BPFObjPath      string
+	// BPFObjBuff is the object to open instead of the file at BPFObjPath. It
+	// is not copied: the global variable lookups parse it lazily until
+	// BPFLoadObject, so it must not be modified before then.
 	BPFObjBuff      []byte
 	SkipMemlockBump bool
+	// ProbeCache caches the kernel feature probes deciding the attach
+	// fallbacks (e.g. of AttachKprobeMulti). A process wide in-memory cache
+	// is used if nil.
+	ProbeCache *ProbeCache
 }
 
 func NewModuleFromFile(bpfObjPath string) (*Module, error) {
@@ -49,10 +66,6 @@ func NewModuleFromFile(bpfObjPath string) (*Module, error) {
 }
 
 func NewModuleFromFileArgs(args NewModuleArgs) (*Module, error) {
-	f, err := elf.Open(args.BPFObjPath)
-	if err != nil {
-		return nil, err
-	}
 	C.cgo_libbpf_set_print_fn()
 
 	// If skipped, we rely on libbpf to do the bumping if deemed necessary
@@ -92,8 +105,9 @@ func NewModuleFromFileArgs(args NewModuleArgs) (*Module, error) {
 	}
 
 	return &Module{
-		obj: objC,
-		elf: f,
+		obj:        objC,
+		objPath:    args.BPFObjPath,
+		probeCache: args.ProbeCache,
 	}, nil
 }
 
@@ -105,9 +119,8 @@ func NewModuleFromBuffer(bpfObjBuff []byte, bpfObjName string) (*Module, error)
 }
 
 func NewModuleFromBufferArgs(args NewModuleArgs) (*Module, error) {
-	f, err := elf.NewFile(bytes.NewReader(args.BPFObjBuff))
-	if err != nil {
-		return nil, err
+	if len(args.BPFObjBuff) == 0 {
+		return nil, fmt.Errorf("failed to open BPF object %s: empty buffer", args.BPFObjName)
 	}
 	C.cgo_libbpf_set_print_fn()
 
@@ -126,8 +139,9 @@ func NewModuleFromBufferArgs(args NewModuleArgs) (*Module, error) {
 	defer C.free(unsafe.Pointer(kConfigPathC))
 	bpfObjNameC := C.CString(args.BPFObjName)
 	defer C.free(unsafe.Pointer(bpfObjNameC))
-	bpfBuffC := unsafe.Pointer(C.CBytes(args.BPFObjBuff))
-	defer C.free(bpfBuffC)
+	// libbpf only reads the buffer while opening the object, so the Go
+	// memory is passed as is instead of being copied to C memory
+	bpfBuffC := unsafe.Pointer(&args.BPFObjBuff[0])
 	bpfBuffSizeC := C.size_t(len(args.BPFObjBuff))
 
 	if len(args.KConfigFilePath) <= 2 {
@@ -146,8 +160,9 @@ func NewModuleFromBufferArgs(args NewModuleArgs) (*Module, error) {
 	}
 
 	return &Module{
-		obj: objC,
-		elf: f,
+		obj:        objC,
+		objBuff:    args.BPFObjBuff,
+		probeCache: args.ProbeCache,
 	}, nil
 }
 
@@ -176,21 +191,140 @@ func (m *Module) Close() {
 	for _, rb := range m.ringBufs {
 		rb.Close()
 	}
+	for _, pc := range m.counters {
+		pc.Close()
+	}
 	for _, link := range m.links {
 		if link.link != nil {
 			link.Destroy()
 		}
 	}
+	if m.persistence != nil {
+		for _, fd := range m.persistence.progFDs {
+			_ = syscall.Close(fd)
+		}
+	}
 	C.bpf_object__close(m.obj)
 }
 
+// UpgradeLinks moves the links of oldModule programs (all the links attached
+// through its programs, uprobes included) to the programs with the same name
+// in m, so a new version of a BPF object can replace a running one
+// without missing events. Links are swapped atomically when the kernel
+// supports it (see BPFLink.UpdateProgram), otherwise the new program is
+// attached before the old link is destroyed. The BPFLink handles stay valid
+// and refer to the new programs.
+//
+// Upgraded links are owned by m afterwards. Links whose program has no
+// counterpart in m are left untouched in oldModule. If a link can't be
+// upgraded, the links upgraded so far are moved back to their old programs.
+func (m *Module) UpgradeLinks(oldModule *Module) error {
+	if !m.loaded {
+		return errors.New("must be called after the BPF object is loaded")
+	}
+
+	oldModule.linksMu.Lock()
+	oldLinks := make([]*BPFLink, len(oldModule.links))
+	copy(oldLinks, oldModule.links)
+	oldModule.linksMu.Unlock()
+
+	type linkUpgrade struct {
+		link    *BPFLink
+		oldProg *BPFProg
+		newLink *BPFLink // nil if the link was updated in place
+	}
+	var upgrades []linkUpgrade
+
+	rollback := func() {
+		for _, u := range upgrades {
+			if u.newLink == nil {
+				_ = u.link.UpdateProgram(u.oldProg)
+				continue
+			}
+			m.removeLink(u.newLink)
+			_ = u.newLink.Destroy()
+		}
+	}
+
+	for _, link := range oldLinks {
+		if link.link == nil && link.legacy == nil {
+			continue // already destroyed
+		}
+
+		newProg, err := m.GetProgram(link.prog.Name())
+		if err != nil {
+			continue
+		}
+
+		oldProg := link.prog
+		if err := link.UpdateProgram(newProg); err == nil {
+			upgrades = append(upgrades, linkUpgrade{link: link, oldProg: oldProg})
+			continue
+		}
+
+		// attach before detach so the target is never left without a program
+		if link.reattach == nil {
+			rollback()
+			return fmt.Errorf("failed to upgrade link %s: link can't be updated nor reattached", link.eventName)
+		}
+		newLink, err := link.reattach(newProg)
+		if err != nil {
+			rollback()
+			return fmt.Errorf("failed to upgrade link %s: %w", link.eventName, err)
+		}
+		upgrades = append(upgrades, linkUpgrade{link: link, oldProg: oldProg, newLink: newLink})
+	}
+
+	// every target has its new program, drop the old links and repoint the
+	// handles to the new ones
+	var destroyErr error
+	for _, u := range upgrades {
+		if u.newLink != nil {
+			if err := u.link.Destroy(); err != nil && destroyErr == nil {
+				destroyErr = fmt.Errorf("failed to destroy upgraded link %s: %w", u.link.eventName, err)
+			}
+			m.removeLink(u.newLink)
+			u.link.link = u.newLink.link
+			u.link.prog = u.newLink.prog
+			u.link.linkType = u.newLink.linkType
+			u.link.eventName = u.newLink.eventName
+			u.link.legacy = u.newLink.legacy
+			u.link.reattach = u.newLink.reattach
+		}
+		oldModule.removeLink(u.link)
+		m.addLink(u.link)
+	}
+
+	return destroyErr
+}
+
+// addLink tracks link so it's destroyed when the module is closed.
+func (m *Module) addLink(link *BPFLink) {
+	m.linksMu.Lock()
+	m.links = append(m.links, link)
+	m.linksMu.Unlock()
+}
+
+func (m *Module) removeLink(link *BPFLink) {
+	m.linksMu.Lock()
+	defer m.linksMu.Unlock()
+
+	for i, l := range m.links {
+		if l == link {
+			m.links = append(m.links[:i], m.links[i+1:]...)
+			return
+		}
+	}
+}
+
 func (m *Module) BPFLoadObject() error {
 	retC := C.bpf_object__load(m.obj)
 	if retC < 0 {
 		return fmt.Errorf("failed to load BPF object: %w", syscall.Errno(-retC))
 	}
 	m.loaded = true
-	m.elf.Close()
+	m.objBuff = nil
+	m.globalSymbols = nil
 
 	return nil
 }
@@ -198,42 +332,72 @@ func (m *Module) BPFLoadObject() error {
 // InitGlobalVariable sets global variables (defined in .data or .rodata)
 // in bpf code. It must be called before the BPF object is loaded.
 func (m *Module) InitGlobalVariable(name string, value interface{}) error {
+	return m.InitGlobalVariables(map[string]interface{}{name: value})
+}
+
+// InitGlobalVariables sets many global variables (defined in .data or
+// .rodata) in bpf code, by name. The initial value of each section is read and
+// set once for all its variables, instead of once per variable, and no section
+// is set if any variable is invalid. It must be called before the BPF object
+// is loaded.
+func (m *Module) InitGlobalVariables(values map[string]interface{}) error {
 	if m.loaded {
 		return errors.New("must be called before the BPF object is loaded")
 	}
-	s, err := getGlobalVariableSymbol(m.elf, name)
-	if err != nil {
-		return err
-	}
-	bpfMap, err := m.GetMap(s.sectionName)
-	if err != nil {
-		return err
-	}
 
-	// get current value
-	currMapValue, err := bpfMap.InitialValue()
-	if err != nil {
-		return err
+	// group the variables by section
+	sections := make(map[string][]*Symbol)
+	for name := range values {
+		s, err := m.globalVariableSymbol(name)
+		if err != nil {
+			return fmt.Errorf("failed to find global variable %s: %w", name, err)
+		}
+		sections[s.sectionName] = append(sections[s.sectionName], s)
 	}
 
-	// generate new value
-	newMapValue := make([]byte, bpfMap.ValueSize())
-	copy(newMapValue, currMapValue)
+	// compute every section value before setting any, so that an invalid
+	// variable leaves all the sections untouched
+	newValues := make(map[*BPFMap][]byte, len(sections))
 	data := bytes.NewBuffer(nil)
-	if err := binary.Write(data, s.byteOrder, value); err != nil {
-		return err
+	for sectionName, symbols := range sections {
+		bpfMap, err := m.GetMap(sectionName)
+		if err != nil {
+			return err
+		}
+
+		// get current value
+		currMapValue, err := bpfMap.InitialValue()
+		if err != nil {
+			return err
+		}
+
+		// generate new value
+		newMapValue := make([]byte, bpfMap.ValueSize())
+		copy(newMapValue, currMapValue)
+		for _, s := range symbols {
+			data.Reset()
+			if err := binary.Write(data, s.byteOrder, values[s.name]); err != nil {
+				return fmt.Errorf("failed to encode global variable %s: %w", s.name, err)
+			}
+			varValue := data.Bytes()
+			start := s.offset
+			end := s.offset + len(varValue)
+			if len(varValue) > s.size || end > len(newMapValue) {
+				return fmt.Errorf("invalid value for global variable %s", s.name)
+			}
+			copy(newMapValue[start:end], varValue)
+		}
+		newValues[bpfMap] = newMapValue
 	}
-	varValue := data.Bytes()
-	start := s.offset
-	end := s.offset + len(varValue)
-	if len(varValue) > s.size || end > bpfMap.ValueSize() {
-		return errors.New("invalid value")
+
+	// save new values
+	for bpfMap, newMapValue := range newValues {
+		if err := bpfMap.SetInitialValue(unsafe.Pointer(&newMapValue[0])); err != nil {
+			return err
+		}
 	}
-	copy(newMapValue[start:end], varValue)
 
-	// save new value
-	err = bpfMap.SetInitialValue(unsafe.Pointer(&newMapValue[0]))
-	return err
+	return nil
 }
 
 func (m *Module) GetMap(mapName string) (*BPFMap, error) {
@@ -0,0 +1,441 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"encoding/json"
+	"fmt"
+	"os"
+	"path/filepath"
+	"runtime"
+	"strings"
+	"sync"
+	"syscall"
+)
+
+//
+// ProbeCache
+//
+
+const bootIDPath = "/proc/sys/kernel/random/boot_id"
+
+// NewProbeCacheArgs configures a ProbeCache.
+type NewProbeCacheArgs struct {
+	// CachePath is the file the probe results are persisted to. Persisted
+	// results are only reused when written on the same kernel release and
+	// boot. An empty path keeps the results in memory only.
+	CachePath string
+	// Helpers lists the BPF helpers, per program type, that are probed
+	// together with the program and map types on first use. Helpers not
+	// listed are probed on demand and then cached.
+	Helpers map[BPFProgType][]BPFFunc
+	// Concurrency bounds the number of probes run in parallel. It defaults
+	// to the number of CPUs.
+	Concurrency int
+}
+
+type probeCacheData struct {
+	KernelRelease string                           `json:"kernelRelease"`
+	BootID        string                           `json:"bootId"`
+	ProgTypes     map[BPFProgType]bool             `json:"progTypes"`
+	MapTypes      map[MapType]bool                 `json:"mapTypes"`
+	Helpers       map[BPFProgType]map[BPFFunc]bool `json:"helpers"`
+	Features      map[probeFeature]bool            `json:"features"`
+}
+
+// probeFeature is a kernel feature probed by attaching, rather than by
+// loading a program, map or helper.
+type probeFeature string
+
+const (
+	probeFeatureKprobeMulti probeFeature = "kprobe_multi"
+)
+
+var probeFeatures = map[probeFeature]func() (bool, error){
+	probeFeatureKprobeMulti: probeKprobeMulti,
+}
+
+// ProbeCache caches the results of the kernel feature probes: program types,
+// map types, helpers and the kprobe_multi link support. On first use it reads
+// the results persisted by a previous run on the same kernel boot or, if
+// there are none, runs all probes in parallel and persists them.
+//
+// Probes that fail (e.g. due to missing privileges) are not cached, so the
+// error is returned and the probe retried on the next query.
+type ProbeCache struct {
+	args NewProbeCacheArgs
+	once sync.Once
+	mu   sync.RWMutex
+	data probeCacheData
+}
+
+// defaultProbeCache is the in-memory ProbeCache of the modules created
+// without one.
+var defaultProbeCache = NewProbeCache(NewProbeCacheArgs{})
+
+// probes returns the ProbeCache of the module.
+func (m *Module) probes() *ProbeCache {
+	if m.probeCache != nil {
+		return m.probeCache
+	}
+
+	return defaultProbeCache
+}
+
+func NewProbeCache(args NewProbeCacheArgs) *ProbeCache {
+	if args.Concurrency <= 0 {
+		args.Concurrency = runtime.NumCPU()
+	}
+
+	return &ProbeCache{
+		args: args,
+	}
+}
+
+// ProgramTypeIsSupported is the cached version of BPFProgramTypeIsSupported.
+func (c *ProbeCache) ProgramTypeIsSupported(progType BPFProgType) (bool, error) {
+	c.init()
+
+	c.mu.RLock()
+	supported, ok := c.data.ProgTypes[progType]
+	c.mu.RUnlock()
+	if ok {
+		return supported, nil
+	}
+
+	supported, err := probeProgType(progType)
+	if err != nil {
+		return false, err
+	}
+	c.mu.Lock()
+	c.data.ProgTypes[progType] = supported
+	c.mu.Unlock()
+	_ = c.Save() // best effort, the result is still cached in memory
+
+	return supported, nil
+}
+
+// MapTypeIsSupported is the cached version of BPFMapTypeIsSupported.
+func (c *ProbeCache) MapTypeIsSupported(mapType MapType) (bool, error) {
+	c.init()
+
+	c.mu.RLock()
+	supported, ok := c.data.MapTypes[mapType]
+	c.mu.RUnlock()
+	if ok {
+		return supported, nil
+	}
+
+	supported, err := probeMapType(mapType)
+	if err != nil {
+		return false, err
+	}
+	c.mu.Lock()
+	c.data.MapTypes[mapType] = supported
+	c.mu.Unlock()
+	_ = c.Save() // best effort, the result is still cached in memory
+
+	return supported, nil
+}
+
+// HelperIsSupported is the cached version of BPFHelperIsSupported.
+func (c *ProbeCache) HelperIsSupported(progType BPFProgType, funcID BPFFunc) (bool, error) {
+	c.init()
+
+	c.mu.RLock()
+	supported, ok := c.data.Helpers[progType][funcID]
+	c.mu.RUnlock()
+	if ok {
+		return supported, nil
+	}
+
+	supported, err := probeHelper(progType, funcID)
+	if err != nil {
+		return false, err
+	}
+	c.storeHelper(progType, funcID, supported)
+	_ = c.Save() // best effort, the result is still cached in memory
+
+	return supported, nil
+}
+
+// KprobeMultiIsSupported probes whether kprobe_multi links can be attached
+// (kernel 5.18 with CONFIG_FPROBE).
+func (c *ProbeCache) KprobeMultiIsSupported() (bool, error) {
+	return c.featureIsSupported(probeFeatureKprobeMulti)
+}
+
+func (c *ProbeCache) featureIsSupported(feature probeFeature) (bool, error) {
+	c.init()
+
+	c.mu.RLock()
+	supported, ok := c.data.Features[feature]
+	c.mu.RUnlock()
+	if ok {
+		return supported, nil
+	}
+
+	supported, err := probeFeatures[feature]()
+	if err != nil {
+		return false, err
+	}
+	c.mu.Lock()
+	c.data.Features[feature] = supported
+	c.mu.Unlock()
+	_ = c.Save() // best effort, the result is still cached in memory
+
+	return supported, nil
+}
+
+// Save persists the cached probe results to the cache path. It is called
+// automatically whenever new results are cached, ignoring errors, so it only
+// needs to be called explicitly to check that the results were persisted.
+func (c *ProbeCache) Save() error {
+	if c.args.CachePath == "" {
+		return nil
+	}
+
+	c.mu.RLock()
+	content, err := json.Marshal(&c.data)
+	c.mu.RUnlock()
+	if err != nil {
+		return fmt.Errorf("failed to encode probe cache: %w", err)
+	}
+
+	dir := filepath.Dir(c.args.CachePath)
+	if err := os.MkdirAll(dir, 0755); err != nil {
+		return fmt.Errorf("failed to create probe cache dir %s: %w", dir, err)
+	}
+
+	// write and rename so concurrent readers never see a partial file
+	tmp, err := os.CreateTemp(dir, filepath.Base(c.args.CachePath)+".*")
+	if err != nil {
+		return fmt.Errorf("failed to create probe cache file: %w", err)
+	}
+	defer os.Remove(tmp.Name())
+
+	if _, err := tmp.Write(content); err != nil {
+		tmp.Close()
+		return fmt.Errorf("failed to write probe cache file: %w", err)
+	}
+	if err := tmp.Close(); err != nil {
+		return fmt.Errorf("failed to write probe cache file: %w", err)
+	}
+	if err := os.Rename(tmp.Name(), c.args.CachePath); err != nil {
+		return fmt.Errorf("failed to save probe cache to %s: %w", c.args.CachePath, err)
+	}
+
+	return nil
+}
+
+func (c *ProbeCache) init() {
+	c.once.Do(func() {
+		release, bootID := currentKernelBoot()
+		if !c.load(release, bootID) {
+			c.data = probeCacheData{
+				KernelRelease: release,
+				BootID:        bootID,
+				ProgTypes:     make(map[BPFProgType]bool),
+				MapTypes:      make(map[MapType]bool),
+				Helpers:       make(map[BPFProgType]map[BPFFunc]bool),
+				Features:      make(map[probeFeature]bool),
+			}
+		}
+
+		jobs := c.missingProbes()
+		if len(jobs) == 0 {
+			return
+		}
+		runConcurrently(jobs, c.args.Concurrency)
+		_ = c.Save() // best effort, the results are still cached in memory
+	})
+}
+
+// load reads the persisted results, which are only valid for the running
+// kernel boot.
+func (c *ProbeCache) load(release, bootID string) bool {
+	if c.args.CachePath == "" || release == "" || bootID == "" {
+		return false
+	}
+
+	content, err := os.ReadFile(c.args.CachePath)
+	if err != nil {
+		return false
+	}
+
+	var data probeCacheData
+	if err := json.Unmarshal(content, &data); err != nil {
+		return false
+	}
+	if data.KernelRelease != release || data.BootID != bootID {
+		return false
+	}
+	if data.ProgTypes == nil {
+		data.ProgTypes = make(map[BPFProgType]bool)
+	}
+	if data.MapTypes == nil {
+		data.MapTypes = make(map[MapType]bool)
+	}
+	if data.Helpers == nil {
+		data.Helpers = make(map[BPFProgType]map[BPFFunc]bool)
+	}
+	if data.Features == nil {
+		data.Features = make(map[probeFeature]bool)
+	}
+	c.data = data
+
+	return true
+}
+
+// missingProbes returns the probes whose results are not cached yet.
+func (c *ProbeCache) missingProbes() []func() {
+	var jobs []func()
+
+	for progType := range bpfProgTypeToString {
+		if _, ok := c.data.ProgTypes[progType]; ok || progType == BPFProgTypeUnspec {
+			continue
+		}
+		progType := progType
+		jobs = append(jobs, func() {
+			supported, err := probeProgType(progType)
+			if err != nil {
+				return
+			}
+			c.mu.Lock()
+			c.data.ProgTypes[progType] = supported
+			c.mu.Unlock()
+		})
+	}
+
+	for mapType := range mapTypeToString {
+		if _, ok := c.data.MapTypes[mapType]; ok || mapType == MapTypeUnspec {
+			continue
+		}
+		mapType := mapType
+		jobs = append(jobs, func() {
+			supported, err := probeMapType(mapType)
+			if err != nil {
+				return
+			}
+			c.mu.Lock()
+			c.data.MapTypes[mapType] = supported
+			c.mu.Unlock()
+		})
+	}
+
+	for progType, funcIDs := range c.args.Helpers {
+		for _, funcID := range funcIDs {
+			if _, ok := c.data.Helpers[progType][funcID]; ok {
+				continue
+			}
+			progType, funcID := progType, funcID
+			jobs = append(jobs, func() {
+				supported, err := probeHelper(progType, funcID)
+				if err != nil {
+					return
+				}
+				c.storeHelper(progType, funcID, supported)
+			})
+		}
+	}
+
+	for feature, probe := range probeFeatures {
+		if _, ok := c.data.Features[feature]; ok {
+			continue
+		}
+		feature, probe := feature, probe
+		jobs = append(jobs, func() {
+			supported, err := probe()
+			if err != nil {
+				return
+			}
+			c.mu.Lock()
+			c.data.Features[feature] = supported
+			c.mu.Unlock()
+		})
+	}
+
+	return jobs
+}
+
+func (c *ProbeCache) storeHelper(progType BPFProgType, funcID BPFFunc, supported bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	helpers, ok := c.data.Helpers[progType]
+	if !ok {
+		helpers = make(map[BPFFunc]bool)
+		c.data.Helpers[progType] = helpers
+	}
+	helpers[funcID] = supported
+}
+
+// currentKernelBoot returns the running kernel release and boot ID, which
+// together identify the kernel the probe results are valid for.
+func currentKernelBoot() (string, string) {
+	var uname syscall.Utsname
+	if err := syscall.Uname(&uname); err != nil {
+		return "", ""
+	}
+
+	var buf [65]byte
+	for i, b := range uname.Release {
+		buf[i] = byte(b)
+	}
+	release := strings.Trim(string(buf[:]), "\x00")
+
+	bootID, err := os.ReadFile(bootIDPath)
+	if err != nil {
+		return release, ""
+	}
+
+	return release, strings.TrimSpace(string(bootID))
+}
+
+//
+// Probes
+//
+
+// The probes are shared by the cached and uncached APIs: they return false
+// without error when the feature is missing, and an error only if the probe
+// itself fails, which is not cached.
+
+func probeProgType(progType BPFProgType) (bool, error) {
+	retC := C.libbpf_probe_bpf_prog_type(C.enum_bpf_prog_type(int(progType)), nil)
+	if retC < 0 {
+		return false, syscall.Errno(-retC)
+	}
+
+	return retC == 1, nil
+}
+
+func probeMapType(mapType MapType) (bool, error) {
+	retC := C.libbpf_probe_bpf_map_type(C.enum_bpf_map_type(int(mapType)), nil)
+	if retC < 0 {
+		return false, syscall.Errno(-retC)
+	}
+
+	return retC == 1, nil
+}
+
+func probeHelper(progType BPFProgType, funcID BPFFunc) (bool, error) {
+	retC := C.libbpf_probe_bpf_helper(C.enum_bpf_prog_type(int(progType)), C.enum_bpf_func_id(int(funcID)), nil)
+	if retC < 0 {
+		return false, syscall.Errno(-retC)
+	}
+
+	return retC == 1, nil
+}
+
+func probeKprobeMulti() (bool, error) {
+	retC := C.cgo_probe_kprobe_multi_link()
+	if retC < 0 {
+		return false, syscall.Errno(-retC)
+	}
+
+	return retC == 1, nil
+}
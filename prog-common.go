@@ -150,6 +150,10 @@ const (
 	BPFAttachTypeSKReusePortSelectorMigrate BPFAttachType = C.BPF_SK_REUSEPORT_SELECT_OR_MIGRATE
 	BPFAttachTypePerfEvent                  BPFAttachType = C.BPF_PERF_EVENT
 	BPFAttachTypeTraceKprobeMulti           BPFAttachType = C.BPF_TRACE_KPROBE_MULTI
+	BPFAttachTypeTCXIngress                 BPFAttachType = C.BPF_TCX_INGRESS
+	BPFAttachTypeTCXEgress                  BPFAttachType = C.BPF_TCX_EGRESS
+	BPFAttachTypeNetkitPrimary              BPFAttachType = C.BPF_NETKIT_PRIMARY
+	BPFAttachTypeNetkitPeer                 BPFAttachType = C.BPF_NETKIT_PEER
 )
 
 var bpfAttachTypeToString = map[BPFAttachType]string{
@@ -196,6 +200,10 @@ var bpfAttachTypeToString = map[BPFAttachType]string{
 	BPFAttachTypeSKReusePortSelectorMigrate: "BPF_SK_REUSEPORT_SELECT_OR_MIGRATE",
 	BPFAttachTypePerfEvent:                  "BPF_PERF_EVENT",
 	BPFAttachTypeTraceKprobeMulti:           "BPF_TRACE_KPROBE_MULTI",
+	BPFAttachTypeTCXIngress:                 "BPF_TCX_INGRESS",
+	BPFAttachTypeTCXEgress:                  "BPF_TCX_EGRESS",
+	BPFAttachTypeNetkitPrimary:              "BPF_NETKIT_PRIMARY",
+	BPFAttachTypeNetkitPeer:                 "BPF_NETKIT_PEER",
 }
 
 func (t BPFAttachType) String() string {
@@ -237,3 +245,223 @@ const (
 	BPFFAllowMulti    AttachFlag = C.BPF_F_ALLOW_MULTI
 	BPFFReplace       AttachFlag = C.BPF_F_REPLACE
 )
+
+//
+// BPFFunc
+//
+
+// BPFFunc is an enum as defined in https://elixir.bootlin.com/linux/latest/source/include/uapi/linux/bpf.h
+type BPFFunc uint32
+
+const (
+	BPFFuncUnspec                     BPFFunc = C.BPF_FUNC_unspec
+	BPFFuncMapLookupElem              BPFFunc = C.BPF_FUNC_map_lookup_elem
+	BPFFuncMapUpdateElem              BPFFunc = C.BPF_FUNC_map_update_elem
+	BPFFuncMapDeleteElem              BPFFunc = C.BPF_FUNC_map_delete_elem
+	BPFFuncProbeRead                  BPFFunc = C.BPF_FUNC_probe_read
+	BPFFuncKtimeGetNs                 BPFFunc = C.BPF_FUNC_ktime_get_ns
+	BPFFuncTracePrintk                BPFFunc = C.BPF_FUNC_trace_printk
+	BPFFuncGetPrandomU32              BPFFunc = C.BPF_FUNC_get_prandom_u32
+	BPFFuncGetSmpProcessorId          BPFFunc = C.BPF_FUNC_get_smp_processor_id
+	BPFFuncSkbStoreBytes              BPFFunc = C.BPF_FUNC_skb_store_bytes
+	BPFFuncL3CsumReplace              BPFFunc = C.BPF_FUNC_l3_csum_replace
+	BPFFuncL4CsumReplace              BPFFunc = C.BPF_FUNC_l4_csum_replace
+	BPFFuncTailCall                   BPFFunc = C.BPF_FUNC_tail_call
+	BPFFuncCloneRedirect              BPFFunc = C.BPF_FUNC_clone_redirect
+	BPFFuncGetCurrentPidTgid          BPFFunc = C.BPF_FUNC_get_current_pid_tgid
+	BPFFuncGetCurrentUidGid           BPFFunc = C.BPF_FUNC_get_current_uid_gid
+	BPFFuncGetCurrentComm             BPFFunc = C.BPF_FUNC_get_current_comm
+	BPFFuncGetCgroupClassid           BPFFunc = C.BPF_FUNC_get_cgroup_classid
+	BPFFuncSkbVlanPush                BPFFunc = C.BPF_FUNC_skb_vlan_push
+	BPFFuncSkbVlanPop                 BPFFunc = C.BPF_FUNC_skb_vlan_pop
+	BPFFuncSkbGetTunnelKey            BPFFunc = C.BPF_FUNC_skb_get_tunnel_key
+	BPFFuncSkbSetTunnelKey            BPFFunc = C.BPF_FUNC_skb_set_tunnel_key
+	BPFFuncPerfEventRead              BPFFunc = C.BPF_FUNC_perf_event_read
+	BPFFuncRedirect                   BPFFunc = C.BPF_FUNC_redirect
+	BPFFuncGetRouteRealm              BPFFunc = C.BPF_FUNC_get_route_realm
+	BPFFuncPerfEventOutput            BPFFunc = C.BPF_FUNC_perf_event_output
+	BPFFuncSkbLoadBytes               BPFFunc = C.BPF_FUNC_skb_load_bytes
+	BPFFuncGetStackid                 BPFFunc = C.BPF_FUNC_get_stackid
+	BPFFuncCsumDiff                   BPFFunc = C.BPF_FUNC_csum_diff
+	BPFFuncSkbGetTunnelOpt            BPFFunc = C.BPF_FUNC_skb_get_tunnel_opt
+	BPFFuncSkbSetTunnelOpt            BPFFunc = C.BPF_FUNC_skb_set_tunnel_opt
+	BPFFuncSkbChangeProto             BPFFunc = C.BPF_FUNC_skb_change_proto
+	BPFFuncSkbChangeType              BPFFunc = C.BPF_FUNC_skb_change_type
+	BPFFuncSkbUnderCgroup             BPFFunc = C.BPF_FUNC_skb_under_cgroup
+	BPFFuncGetHashRecalc              BPFFunc = C.BPF_FUNC_get_hash_recalc
+	BPFFuncGetCurrentTask             BPFFunc = C.BPF_FUNC_get_current_task
+	BPFFuncProbeWriteUser             BPFFunc = C.BPF_FUNC_probe_write_user
+	BPFFuncCurrentTaskUnderCgroup     BPFFunc = C.BPF_FUNC_current_task_under_cgroup
+	BPFFuncSkbChangeTail              BPFFunc = C.BPF_FUNC_skb_change_tail
+	BPFFuncSkbPullData                BPFFunc = C.BPF_FUNC_skb_pull_data
+	BPFFuncCsumUpdate                 BPFFunc = C.BPF_FUNC_csum_update
+	BPFFuncSetHashInvalid             BPFFunc = C.BPF_FUNC_set_hash_invalid
+	BPFFuncGetNumaNodeId              BPFFunc = C.BPF_FUNC_get_numa_node_id
+	BPFFuncSkbChangeHead              BPFFunc = C.BPF_FUNC_skb_change_head
+	BPFFuncXdpAdjustHead              BPFFunc = C.BPF_FUNC_xdp_adjust_head
+	BPFFuncProbeReadStr               BPFFunc = C.BPF_FUNC_probe_read_str
+	BPFFuncGetSocketCookie            BPFFunc = C.BPF_FUNC_get_socket_cookie
+	BPFFuncGetSocketUid               BPFFunc = C.BPF_FUNC_get_socket_uid
+	BPFFuncSetHash                    BPFFunc = C.BPF_FUNC_set_hash
+	BPFFuncSetsockopt                 BPFFunc = C.BPF_FUNC_setsockopt
+	BPFFuncSkbAdjustRoom              BPFFunc = C.BPF_FUNC_skb_adjust_room
+	BPFFuncRedirectMap                BPFFunc = C.BPF_FUNC_redirect_map
+	BPFFuncSkRedirectMap              BPFFunc = C.BPF_FUNC_sk_redirect_map
+	BPFFuncSockMapUpdate              BPFFunc = C.BPF_FUNC_sock_map_update
+	BPFFuncXdpAdjustMeta              BPFFunc = C.BPF_FUNC_xdp_adjust_meta
+	BPFFuncPerfEventReadValue         BPFFunc = C.BPF_FUNC_perf_event_read_value
+	BPFFuncPerfProgReadValue          BPFFunc = C.BPF_FUNC_perf_prog_read_value
+	BPFFuncGetsockopt                 BPFFunc = C.BPF_FUNC_getsockopt
+	BPFFuncOverrideReturn             BPFFunc = C.BPF_FUNC_override_return
+	BPFFuncSockOpsCbFlagsSet          BPFFunc = C.BPF_FUNC_sock_ops_cb_flags_set
+	BPFFuncMsgRedirectMap             BPFFunc = C.BPF_FUNC_msg_redirect_map
+	BPFFuncMsgApplyBytes              BPFFunc = C.BPF_FUNC_msg_apply_bytes
+	BPFFuncMsgCorkBytes               BPFFunc = C.BPF_FUNC_msg_cork_bytes
+	BPFFuncMsgPullData                BPFFunc = C.BPF_FUNC_msg_pull_data
+	BPFFuncBind                       BPFFunc = C.BPF_FUNC_bind
+	BPFFuncXdpAdjustTail              BPFFunc = C.BPF_FUNC_xdp_adjust_tail
+	BPFFuncSkbGetXfrmState            BPFFunc = C.BPF_FUNC_skb_get_xfrm_state
+	BPFFuncGetStack                   BPFFunc = C.BPF_FUNC_get_stack
+	BPFFuncSkbLoadBytesRelative       BPFFunc = C.BPF_FUNC_skb_load_bytes_relative
+	BPFFuncFibLookup                  BPFFunc = C.BPF_FUNC_fib_lookup
+	BPFFuncSockHashUpdate             BPFFunc = C.BPF_FUNC_sock_hash_update
+	BPFFuncMsgRedirectHash            BPFFunc = C.BPF_FUNC_msg_redirect_hash
+	BPFFuncSkRedirectHash             BPFFunc = C.BPF_FUNC_sk_redirect_hash
+	BPFFuncLwtPushEncap               BPFFunc = C.BPF_FUNC_lwt_push_encap
+	BPFFuncLwtSeg6StoreBytes          BPFFunc = C.BPF_FUNC_lwt_seg6_store_bytes
+	BPFFuncLwtSeg6AdjustSrh           BPFFunc = C.BPF_FUNC_lwt_seg6_adjust_srh
+	BPFFuncLwtSeg6Action              BPFFunc = C.BPF_FUNC_lwt_seg6_action
+	BPFFuncRcRepeat                   BPFFunc = C.BPF_FUNC_rc_repeat
+	BPFFuncRcKeydown                  BPFFunc = C.BPF_FUNC_rc_keydown
+	BPFFuncSkbCgroupId                BPFFunc = C.BPF_FUNC_skb_cgroup_id
+	BPFFuncGetCurrentCgroupId         BPFFunc = C.BPF_FUNC_get_current_cgroup_id
+	BPFFuncGetLocalStorage            BPFFunc = C.BPF_FUNC_get_local_storage
+	BPFFuncSkSelectReuseport          BPFFunc = C.BPF_FUNC_sk_select_reuseport
+	BPFFuncSkbAncestorCgroupId        BPFFunc = C.BPF_FUNC_skb_ancestor_cgroup_id
+	BPFFuncSkLookupTcp                BPFFunc = C.BPF_FUNC_sk_lookup_tcp
+	BPFFuncSkLookupUdp                BPFFunc = C.BPF_FUNC_sk_lookup_udp
+	BPFFuncSkRelease                  BPFFunc = C.BPF_FUNC_sk_release
+	BPFFuncMapPushElem                BPFFunc = C.BPF_FUNC_map_push_elem
+	BPFFuncMapPopElem                 BPFFunc = C.BPF_FUNC_map_pop_elem
+	BPFFuncMapPeekElem                BPFFunc = C.BPF_FUNC_map_peek_elem
+	BPFFuncMsgPushData                BPFFunc = C.BPF_FUNC_msg_push_data
+	BPFFuncMsgPopData                 BPFFunc = C.BPF_FUNC_msg_pop_data
+	BPFFuncRcPointerRel               BPFFunc = C.BPF_FUNC_rc_pointer_rel
+	BPFFuncSpinLock                   BPFFunc = C.BPF_FUNC_spin_lock
+	BPFFuncSpinUnlock                 BPFFunc = C.BPF_FUNC_spin_unlock
+	BPFFuncSkFullsock                 BPFFunc = C.BPF_FUNC_sk_fullsock
+	BPFFuncTcpSock                    BPFFunc = C.BPF_FUNC_tcp_sock
+	BPFFuncSkbEcnSetCe                BPFFunc = C.BPF_FUNC_skb_ecn_set_ce
+	BPFFuncGetListenerSock            BPFFunc = C.BPF_FUNC_get_listener_sock
+	BPFFuncSkcLookupTcp               BPFFunc = C.BPF_FUNC_skc_lookup_tcp
+	BPFFuncTcpCheckSyncookie          BPFFunc = C.BPF_FUNC_tcp_check_syncookie
+	BPFFuncSysctlGetName              BPFFunc = C.BPF_FUNC_sysctl_get_name
+	BPFFuncSysctlGetCurrentValue      BPFFunc = C.BPF_FUNC_sysctl_get_current_value
+	BPFFuncSysctlGetNewValue          BPFFunc = C.BPF_FUNC_sysctl_get_new_value
+	BPFFuncSysctlSetNewValue          BPFFunc = C.BPF_FUNC_sysctl_set_new_value
+	BPFFuncStrtol                     BPFFunc = C.BPF_FUNC_strtol
+	BPFFuncStrtoul                    BPFFunc = C.BPF_FUNC_strtoul
+	BPFFuncSkStorageGet               BPFFunc = C.BPF_FUNC_sk_storage_get
+	BPFFuncSkStorageDelete            BPFFunc = C.BPF_FUNC_sk_storage_delete
+	BPFFuncSendSignal                 BPFFunc = C.BPF_FUNC_send_signal
+	BPFFuncTcpGenSyncookie            BPFFunc = C.BPF_FUNC_tcp_gen_syncookie
+	BPFFuncSkbOutput                  BPFFunc = C.BPF_FUNC_skb_output
+	BPFFuncProbeReadUser              BPFFunc = C.BPF_FUNC_probe_read_user
+	BPFFuncProbeReadKernel            BPFFunc = C.BPF_FUNC_probe_read_kernel
+	BPFFuncProbeReadUserStr           BPFFunc = C.BPF_FUNC_probe_read_user_str
+	BPFFuncProbeReadKernelStr         BPFFunc = C.BPF_FUNC_probe_read_kernel_str
+	BPFFuncTcpSendAck                 BPFFunc = C.BPF_FUNC_tcp_send_ack
+	BPFFuncSendSignalThread           BPFFunc = C.BPF_FUNC_send_signal_thread
+	BPFFuncJiffies64                  BPFFunc = C.BPF_FUNC_jiffies64
+	BPFFuncReadBranchRecords          BPFFunc = C.BPF_FUNC_read_branch_records
+	BPFFuncGetNsCurrentPidTgid        BPFFunc = C.BPF_FUNC_get_ns_current_pid_tgid
+	BPFFuncXdpOutput                  BPFFunc = C.BPF_FUNC_xdp_output
+	BPFFuncGetNetnsCookie             BPFFunc = C.BPF_FUNC_get_netns_cookie
+	BPFFuncGetCurrentAncestorCgroupId BPFFunc = C.BPF_FUNC_get_current_ancestor_cgroup_id
+	BPFFuncSkAssign                   BPFFunc = C.BPF_FUNC_sk_assign
+	BPFFuncKtimeGetBootNs             BPFFunc = C.BPF_FUNC_ktime_get_boot_ns
+	BPFFuncSeqPrintf                  BPFFunc = C.BPF_FUNC_seq_printf
+	BPFFuncSeqWrite                   BPFFunc = C.BPF_FUNC_seq_write
+	BPFFuncSkCgroupId                 BPFFunc = C.BPF_FUNC_sk_cgroup_id
+	BPFFuncSkAncestorCgroupId         BPFFunc = C.BPF_FUNC_sk_ancestor_cgroup_id
+	BPFFuncRingbufOutput              BPFFunc = C.BPF_FUNC_ringbuf_output
+	BPFFuncRingbufReserve             BPFFunc = C.BPF_FUNC_ringbuf_reserve
+	BPFFuncRingbufSubmit              BPFFunc = C.BPF_FUNC_ringbuf_submit
+	BPFFuncRingbufDiscard             BPFFunc = C.BPF_FUNC_ringbuf_discard
+	BPFFuncRingbufQuery               BPFFunc = C.BPF_FUNC_ringbuf_query
+	BPFFuncCsumLevel                  BPFFunc = C.BPF_FUNC_csum_level
+	BPFFuncSkcToTcp6Sock              BPFFunc = C.BPF_FUNC_skc_to_tcp6_sock
+	BPFFuncSkcToTcpSock               BPFFunc = C.BPF_FUNC_skc_to_tcp_sock
+	BPFFuncSkcToTcpTimewaitSock       BPFFunc = C.BPF_FUNC_skc_to_tcp_timewait_sock
+	BPFFuncSkcToTcpRequestSock        BPFFunc = C.BPF_FUNC_skc_to_tcp_request_sock
+	BPFFuncSkcToUdp6Sock              BPFFunc = C.BPF_FUNC_skc_to_udp6_sock
+	BPFFuncGetTaskStack               BPFFunc = C.BPF_FUNC_get_task_stack
+	BPFFuncLoadHdrOpt                 BPFFunc = C.BPF_FUNC_load_hdr_opt
+	BPFFuncStoreHdrOpt                BPFFunc = C.BPF_FUNC_store_hdr_opt
+	BPFFuncReserveHdrOpt              BPFFunc = C.BPF_FUNC_reserve_hdr_opt
+	BPFFuncInodeStorageGet            BPFFunc = C.BPF_FUNC_inode_storage_get
+	BPFFuncInodeStorageDelete         BPFFunc = C.BPF_FUNC_inode_storage_delete
+	BPFFuncDPath                      BPFFunc = C.BPF_FUNC_d_path
+	BPFFuncCopyFromUser               BPFFunc = C.BPF_FUNC_copy_from_user
+	BPFFuncSnprintfBtf                BPFFunc = C.BPF_FUNC_snprintf_btf
+	BPFFuncSeqPrintfBtf               BPFFunc = C.BPF_FUNC_seq_printf_btf
+	BPFFuncSkbCgroupClassid           BPFFunc = C.BPF_FUNC_skb_cgroup_classid
+	BPFFuncRedirectNeigh              BPFFunc = C.BPF_FUNC_redirect_neigh
+	BPFFuncPerCpuPtr                  BPFFunc = C.BPF_FUNC_per_cpu_ptr
+	BPFFuncThisCpuPtr                 BPFFunc = C.BPF_FUNC_this_cpu_ptr
+	BPFFuncRedirectPeer               BPFFunc = C.BPF_FUNC_redirect_peer
+	BPFFuncTaskStorageGet             BPFFunc = C.BPF_FUNC_task_storage_get
+	BPFFuncTaskStorageDelete          BPFFunc = C.BPF_FUNC_task_storage_delete
+	BPFFuncGetCurrentTaskBtf          BPFFunc = C.BPF_FUNC_get_current_task_btf
+	BPFFuncBprmOptsSet                BPFFunc = C.BPF_FUNC_bprm_opts_set
+	BPFFuncKtimeGetCoarseNs           BPFFunc = C.BPF_FUNC_ktime_get_coarse_ns
+	BPFFuncImaInodeHash               BPFFunc = C.BPF_FUNC_ima_inode_hash
+	BPFFuncSockFromFile               BPFFunc = C.BPF_FUNC_sock_from_file
+	BPFFuncCheckMtu                   BPFFunc = C.BPF_FUNC_check_mtu
+	BPFFuncForEachMapElem             BPFFunc = C.BPF_FUNC_for_each_map_elem
+	BPFFuncSnprintf                   BPFFunc = C.BPF_FUNC_snprintf
+	BPFFuncSysBpf                     BPFFunc = C.BPF_FUNC_sys_bpf
+	BPFFuncBtfFindByNameKind          BPFFunc = C.BPF_FUNC_btf_find_by_name_kind
+	BPFFuncSysClose                   BPFFunc = C.BPF_FUNC_sys_close
+	BPFFuncTimerInit                  BPFFunc = C.BPF_FUNC_timer_init
+	BPFFuncTimerSetCallback           BPFFunc = C.BPF_FUNC_timer_set_callback
+	BPFFuncTimerStart                 BPFFunc = C.BPF_FUNC_timer_start
+	BPFFuncTimerCancel                BPFFunc = C.BPF_FUNC_timer_cancel
+	BPFFuncGetFuncIp                  BPFFunc = C.BPF_FUNC_get_func_ip
+	BPFFuncGetAttachCookie            BPFFunc = C.BPF_FUNC_get_attach_cookie
+	BPFFuncTaskPtRegs                 BPFFunc = C.BPF_FUNC_task_pt_regs
+	BPFFuncGetBranchSnapshot          BPFFunc = C.BPF_FUNC_get_branch_snapshot
+	BPFFuncTraceVprintk               BPFFunc = C.BPF_FUNC_trace_vprintk
+	BPFFuncSkcToUnixSock              BPFFunc = C.BPF_FUNC_skc_to_unix_sock
+	BPFFuncKallsymsLookupName         BPFFunc = C.BPF_FUNC_kallsyms_lookup_name
+	BPFFuncFindVma                    BPFFunc = C.BPF_FUNC_find_vma
+	BPFFuncLoop                       BPFFunc = C.BPF_FUNC_loop
+	BPFFuncStrncmp                    BPFFunc = C.BPF_FUNC_strncmp
+	BPFFuncGetFuncArg                 BPFFunc = C.BPF_FUNC_get_func_arg
+	BPFFuncGetFuncRet                 BPFFunc = C.BPF_FUNC_get_func_ret
+	BPFFuncGetFuncArgCnt              BPFFunc = C.BPF_FUNC_get_func_arg_cnt
+	BPFFuncGetRetval                  BPFFunc = C.BPF_FUNC_get_retval
+	BPFFuncSetRetval                  BPFFunc = C.BPF_FUNC_set_retval
+	BPFFuncXdpGetBuffLen              BPFFunc = C.BPF_FUNC_xdp_get_buff_len
+	BPFFuncXdpLoadBytes               BPFFunc = C.BPF_FUNC_xdp_load_bytes
+	BPFFuncXdpStoreBytes              BPFFunc = C.BPF_FUNC_xdp_store_bytes
+	BPFFuncCopyFromUserTask           BPFFunc = C.BPF_FUNC_copy_from_user_task
+	BPFFuncSkbSetTstamp               BPFFunc = C.BPF_FUNC_skb_set_tstamp
+	BPFFuncImaFileHash                BPFFunc = C.BPF_FUNC_ima_file_hash
+	BPFFuncKptrXchg                   BPFFunc = C.BPF_FUNC_kptr_xchg
+	BPFFuncMapLookupPercpuElem        BPFFunc = C.BPF_FUNC_map_lookup_percpu_elem
+	BPFFuncSkcToMptcpSock             BPFFunc = C.BPF_FUNC_skc_to_mptcp_sock
+	BPFFuncDynptrFromMem              BPFFunc = C.BPF_FUNC_dynptr_from_mem
+	BPFFuncRingbufReserveDynptr       BPFFunc = C.BPF_FUNC_ringbuf_reserve_dynptr
+	BPFFuncRingbufSubmitDynptr        BPFFunc = C.BPF_FUNC_ringbuf_submit_dynptr
+	BPFFuncRingbufDiscardDynptr       BPFFunc = C.BPF_FUNC_ringbuf_discard_dynptr
+	BPFFuncDynptrRead                 BPFFunc = C.BPF_FUNC_dynptr_read
+	BPFFuncDynptrWrite                BPFFunc = C.BPF_FUNC_dynptr_write
+	BPFFuncDynptrData                 BPFFunc = C.BPF_FUNC_dynptr_data
+	BPFFuncTcpRawGenSyncookieIpv4     BPFFunc = C.BPF_FUNC_tcp_raw_gen_syncookie_ipv4
+	BPFFuncTcpRawGenSyncookieIpv6     BPFFunc = C.BPF_FUNC_tcp_raw_gen_syncookie_ipv6
+	BPFFuncTcpRawCheckSyncookieIpv4   BPFFunc = C.BPF_FUNC_tcp_raw_check_syncookie_ipv4
+	BPFFuncTcpRawCheckSyncookieIpv6   BPFFunc = C.BPF_FUNC_tcp_raw_check_syncookie_ipv6
+	BPFFuncKtimeGetTaiNs              BPFFunc = C.BPF_FUNC_ktime_get_tai_ns
+	BPFFuncUserRingbufDrain           BPFFunc = C.BPF_FUNC_user_ringbuf_drain
+)
@@ -0,0 +1,325 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"sort"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+//
+// BPFProgInfo
+//
+
+// BPFProgInfoOpts selects the arrays retrieved along with the program info,
+// each costing a copy from the kernel. Dumping the instructions needs
+// CAP_SYS_ADMIN (or CAP_PERFMON and CAP_BPF).
+type BPFProgInfoOpts struct {
+	// XlatedInsns are the instructions as rewritten by the verifier, e.g.
+	// with inlined helpers and elided bounds checks.
+	XlatedInsns bool
+	// JitedImage is the machine code, with the addresses and lengths of the
+	// JITed functions.
+	JitedImage bool
+	// FuncInfo describes the functions of the program (BTF).
+	FuncInfo bool
+	// LineInfo maps instructions and JITed addresses to source lines (BTF).
+	LineInfo bool
+}
+
+// BPFFuncInfo is a function of a program.
+type BPFFuncInfo struct {
+	// InsnOff is the index of the first instruction of the function.
+	InsnOff uint32
+	TypeID  uint32
+	Name    string
+}
+
+// BPFLineInfo maps an instruction to its source line.
+type BPFLineInfo struct {
+	// InsnOff is the index of the first instruction of the line.
+	InsnOff uint32
+	// JitedAddr is the address of the line in the JITed image, zero if the
+	// addresses aren't exposed (see the bpf_jit_kallsyms sysctl).
+	JitedAddr uint64
+	FileName  string
+	// Line is the source line text.
+	Line    string
+	LineNum uint32
+	Col     uint32
+}
+
+// BPFProgInfo mirrors the C structure bpf_prog_info.
+type BPFProgInfo struct {
+	Type          BPFProgType
+	ID            uint32
+	Tag           string
+	Name          string
+	JitedProgLen  uint32
+	XlatedProgLen uint32
+	// LoadTime is the load time, since boot.
+	LoadTime        time.Duration
+	CreatedByUID    uint32
+	MapIDs          []uint32
+	BTFID           uint32
+	GPLCompatible   bool
+	VerifiedInsns   uint32
+	RunTime         time.Duration
+	RunCount        uint64
+	RecursionMisses uint64
+
+	// retrieved with BPFProgInfoOpts
+	XlatedInsns   []byte
+	JitedImage    []byte
+	JitedKsyms    []uint64 // address of each JITed function
+	JitedFuncLens []uint32 // length of each JITed function
+	FuncInfo      []BPFFuncInfo
+	LineInfo      []BPFLineInfo // sorted by InsnOff
+
+	linesByAddr []int // LineInfo indexes sorted by JitedAddr
+}
+
+// Info returns the program info, with the arrays selected by opts.
+func (p *BPFProg) Info(opts BPFProgInfoOpts) (*BPFProgInfo, error) {
+	fd := p.FileDescriptor()
+	if fd < 0 {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+
+	return GetProgInfoByFD(fd, opts)
+}
+
+// GetProgInfoByFD returns the BPFProgInfo for the program with the given file
+// descriptor, with the arrays selected by opts.
+func GetProgInfoByFD(fd int, opts BPFProgInfoOpts) (*BPFProgInfo, error) {
+	// first call for the sizes of the arrays
+	infoC := C.cgo_bpf_prog_info_new()
+	defer C.cgo_bpf_prog_info_free(infoC)
+
+	infoLenC := C.cgo_bpf_prog_info_size()
+	retC := C.bpf_prog_get_info_by_fd(C.int(fd), infoC, &infoLenC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to get program info for fd %d: %w", fd, syscall.Errno(-retC))
+	}
+
+	info := &BPFProgInfo{
+		Type:            BPFProgType(C.cgo_bpf_prog_info_type(infoC)),
+		ID:              uint32(C.cgo_bpf_prog_info_id(infoC)),
+		Tag:             hex.EncodeToString(C.GoBytes(unsafe.Pointer(C.cgo_bpf_prog_info_tag(infoC)), C.BPF_TAG_SIZE)),
+		Name:            C.GoString(C.cgo_bpf_prog_info_name(infoC)),
+		JitedProgLen:    uint32(C.cgo_bpf_prog_info_jited_prog_len(infoC)),
+		XlatedProgLen:   uint32(C.cgo_bpf_prog_info_xlated_prog_len(infoC)),
+		LoadTime:        time.Duration(C.cgo_bpf_prog_info_load_time(infoC)),
+		CreatedByUID:    uint32(C.cgo_bpf_prog_info_created_by_uid(infoC)),
+		BTFID:           uint32(C.cgo_bpf_prog_info_btf_id(infoC)),
+		GPLCompatible:   C.cgo_bpf_prog_info_gpl_compatible(infoC) != 0,
+		VerifiedInsns:   uint32(C.cgo_bpf_prog_info_verified_insns(infoC)),
+		RunTime:         time.Duration(C.cgo_bpf_prog_info_run_time_ns(infoC)),
+		RunCount:        uint64(C.cgo_bpf_prog_info_run_cnt(infoC)),
+		RecursionMisses: uint64(C.cgo_bpf_prog_info_recursion_misses(infoC)),
+	}
+
+	// second call filling the arrays, in C memory since the kernel writes
+	// them through pointers stored in the C info
+	arraysC := C.cgo_bpf_prog_info_new()
+	defer C.cgo_bpf_prog_info_free(arraysC)
+
+	var buffers []unsafe.Pointer
+	defer func() {
+		for _, buf := range buffers {
+			C.free(buf)
+		}
+	}()
+	alloc := func(nr, size C.__u32) unsafe.Pointer {
+		if nr == 0 || size == 0 {
+			return nil
+		}
+		buf := C.calloc(C.size_t(nr), C.size_t(size))
+		buffers = append(buffers, buf)
+		return buf
+	}
+
+	nrMapIDs := C.cgo_bpf_prog_info_nr_map_ids(infoC)
+	mapIDsC := alloc(nrMapIDs, 4)
+	C.cgo_bpf_prog_info_set_map_ids(arraysC, (*C.__u32)(mapIDsC), nrMapIDs)
+
+	var xlatedLen, jitedLen, nrKsyms, nrFuncLens C.__u32
+	var xlatedC, jitedC, ksymsC, funcLensC unsafe.Pointer
+	if opts.XlatedInsns {
+		xlatedLen = C.cgo_bpf_prog_info_xlated_prog_len(infoC)
+		xlatedC = alloc(xlatedLen, 1)
+		C.cgo_bpf_prog_info_set_xlated_prog_insns(arraysC, xlatedC, xlatedLen)
+	}
+	if opts.JitedImage || opts.LineInfo {
+		nrKsyms = C.cgo_bpf_prog_info_nr_jited_ksyms(infoC)
+		ksymsC = alloc(nrKsyms, 8)
+		C.cgo_bpf_prog_info_set_jited_ksyms(arraysC, (*C.__u64)(ksymsC), nrKsyms)
+		nrFuncLens = C.cgo_bpf_prog_info_nr_jited_func_lens(infoC)
+		funcLensC = alloc(nrFuncLens, 4)
+		C.cgo_bpf_prog_info_set_jited_func_lens(arraysC, (*C.__u32)(funcLensC), nrFuncLens)
+	}
+	if opts.JitedImage {
+		jitedLen = C.cgo_bpf_prog_info_jited_prog_len(infoC)
+		jitedC = alloc(jitedLen, 1)
+		C.cgo_bpf_prog_info_set_jited_prog_insns(arraysC, jitedC, jitedLen)
+	}
+
+	var nrFuncInfo, funcInfoRecSize C.__u32
+	var funcInfoC unsafe.Pointer
+	if opts.FuncInfo {
+		nrFuncInfo = C.cgo_bpf_prog_info_nr_func_info(infoC)
+		funcInfoRecSize = C.cgo_bpf_prog_info_func_info_rec_size(infoC)
+		funcInfoC = alloc(nrFuncInfo, funcInfoRecSize)
+		C.cgo_bpf_prog_info_set_func_info(arraysC, funcInfoC, nrFuncInfo, funcInfoRecSize)
+	}
+
+	var nrLineInfo, lineInfoRecSize, nrJitedLineInfo, jitedLineInfoRecSize C.__u32
+	var lineInfoC, jitedLineInfoC unsafe.Pointer
+	if opts.LineInfo {
+		nrLineInfo = C.cgo_bpf_prog_info_nr_line_info(infoC)
+		lineInfoRecSize = C.cgo_bpf_prog_info_line_info_rec_size(infoC)
+		lineInfoC = alloc(nrLineInfo, lineInfoRecSize)
+		C.cgo_bpf_prog_info_set_line_info(arraysC, lineInfoC, nrLineInfo, lineInfoRecSize)
+		nrJitedLineInfo = C.cgo_bpf_prog_info_nr_jited_line_info(infoC)
+		jitedLineInfoRecSize = C.cgo_bpf_prog_info_jited_line_info_rec_size(infoC)
+		jitedLineInfoC = alloc(nrJitedLineInfo, jitedLineInfoRecSize)
+		C.cgo_bpf_prog_info_set_jited_line_info(arraysC, (*C.__u64)(jitedLineInfoC), nrJitedLineInfo, jitedLineInfoRecSize)
+	}
+
+	infoLenC = C.cgo_bpf_prog_info_size()
+	retC = C.bpf_prog_get_info_by_fd(C.int(fd), arraysC, &infoLenC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to get program info arrays for fd %d: %w", fd, syscall.Errno(-retC))
+	}
+
+	if mapIDsC != nil {
+		info.MapIDs = append([]uint32(nil), unsafe.Slice((*uint32)(mapIDsC), nrMapIDs)...)
+	}
+	if xlatedC != nil {
+		info.XlatedInsns = C.GoBytes(xlatedC, C.int(xlatedLen))
+	}
+	if jitedC != nil {
+		info.JitedImage = C.GoBytes(jitedC, C.int(jitedLen))
+	}
+	if ksymsC != nil {
+		info.JitedKsyms = append([]uint64(nil), unsafe.Slice((*uint64)(ksymsC), nrKsyms)...)
+	}
+	if funcLensC != nil {
+		info.JitedFuncLens = append([]uint32(nil), unsafe.Slice((*uint32)(funcLensC), nrFuncLens)...)
+	}
+
+	var btfC *C.struct_btf
+	if (opts.FuncInfo || opts.LineInfo) && info.BTFID != 0 {
+		btfC = C.btf__load_from_kernel_by_id(C.__u32(info.BTFID))
+		if btfC != nil {
+			defer C.btf__free(btfC)
+		}
+	}
+	btfName := func(off C.__u32) string {
+		if btfC == nil {
+			return ""
+		}
+		nameC := C.btf__name_by_offset(btfC, off)
+		if nameC == nil {
+			return ""
+		}
+		return C.GoString(nameC)
+	}
+
+	// struct bpf_func_info
+	for i := C.__u32(0); i < nrFuncInfo; i++ {
+		rec := (*C.struct_bpf_func_info)(unsafe.Add(funcInfoC, uintptr(i*funcInfoRecSize)))
+		funcInfo := BPFFuncInfo{
+			InsnOff: uint32(rec.insn_off),
+			TypeID:  uint32(rec.type_id),
+		}
+		if btfC != nil {
+			if t := C.btf__type_by_id(btfC, rec.type_id); t != nil {
+				funcInfo.Name = btfName(t.name_off)
+			}
+		}
+		info.FuncInfo = append(info.FuncInfo, funcInfo)
+	}
+
+	// struct bpf_line_info, and the JITed address of each line
+	for i := C.__u32(0); i < nrLineInfo; i++ {
+		rec := (*C.struct_bpf_line_info)(unsafe.Add(lineInfoC, uintptr(i*lineInfoRecSize)))
+		lineInfo := BPFLineInfo{
+			InsnOff:  uint32(rec.insn_off),
+			FileName: btfName(rec.file_name_off),
+			Line:     btfName(rec.line_off),
+			LineNum:  uint32(rec.line_col) >> 10,
+			Col:      uint32(rec.line_col) & 0x3ff,
+		}
+		if i < nrJitedLineInfo {
+			lineInfo.JitedAddr = *(*uint64)(unsafe.Add(jitedLineInfoC, uintptr(i*jitedLineInfoRecSize)))
+		}
+		info.LineInfo = append(info.LineInfo, lineInfo)
+	}
+	info.indexLines()
+
+	return info, nil
+}
+
+// indexLines sorts the lines with a JITed address by address.
+func (i *BPFProgInfo) indexLines() {
+	i.linesByAddr = i.linesByAddr[:0]
+	for n, line := range i.LineInfo {
+		if line.JitedAddr != 0 {
+			i.linesByAddr = append(i.linesByAddr, n)
+		}
+	}
+	sort.SliceStable(i.linesByAddr, func(a, b int) bool {
+		return i.LineInfo[i.linesByAddr[a]].JitedAddr < i.LineInfo[i.linesByAddr[b]].JitedAddr
+	})
+}
+
+// JitedContains tells whether the address is in the JITed functions of the
+// program, e.g. for a profiler sample.
+func (i *BPFProgInfo) JitedContains(addr uint64) bool {
+	for n, ksym := range i.JitedKsyms {
+		if n < len(i.JitedFuncLens) && addr >= ksym && addr < ksym+uint64(i.JitedFuncLens[n]) {
+			return true
+		}
+	}
+
+	return false
+}
+
+// LineAt returns the source line of a JITed address, which needs the info
+// retrieved with LineInfo.
+func (i *BPFProgInfo) LineAt(addr uint64) (*BPFLineInfo, bool) {
+	if len(i.JitedKsyms) > 0 && !i.JitedContains(addr) {
+		return nil, false
+	}
+	n := sort.Search(len(i.linesByAddr), func(n int) bool {
+		return i.LineInfo[i.linesByAddr[n]].JitedAddr > addr
+	}) - 1
+	if n < 0 {
+		return nil, false
+	}
+
+	return &i.LineInfo[i.linesByAddr[n]], true
+}
+
+// LineAtInsn returns the source line of an instruction of the xlated
+// program, which needs the info retrieved with LineInfo.
+func (i *BPFProgInfo) LineAtInsn(insnOff uint32) (*BPFLineInfo, bool) {
+	n := sort.Search(len(i.LineInfo), func(n int) bool {
+		return i.LineInfo[n].InsnOff > insnOff
+	}) - 1
+	if n < 0 {
+		return nil, false
+	}
+
+	return &i.LineInfo[n], true
+}
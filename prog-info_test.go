@@ -0,0 +1,77 @@
+package libbpfgo
+
+import (
+	"testing"
+)
+
+func testProgInfo() *BPFProgInfo {
+	info := &BPFProgInfo{
+		JitedKsyms:    []uint64{0x1000, 0x2000},
+		JitedFuncLens: []uint32{0x40, 0x20},
+		LineInfo: []BPFLineInfo{
+			{InsnOff: 0, JitedAddr: 0x1000, LineNum: 10},
+			{InsnOff: 4, JitedAddr: 0x1018, LineNum: 11},
+			{InsnOff: 9, JitedAddr: 0x2000, LineNum: 20}, // subprogram
+			{InsnOff: 12, JitedAddr: 0x1030, LineNum: 12},
+		},
+	}
+	info.indexLines()
+
+	return info
+}
+
+func TestProgInfoLineAt(t *testing.T) {
+	info := testProgInfo()
+
+	for _, tc := range []struct {
+		addr    uint64
+		lineNum uint32
+	}{
+		{0x1000, 10},
+		{0x1017, 10},
+		{0x1018, 11},
+		{0x103f, 12},
+		{0x2010, 20},
+	} {
+		line, ok := info.LineAt(tc.addr)
+		if !ok {
+			t.Fatalf("expected a line at %#x", tc.addr)
+		}
+		if line.LineNum != tc.lineNum {
+			t.Fatalf("expected line %d at %#x, got %d", tc.lineNum, tc.addr, line.LineNum)
+		}
+	}
+
+	for _, addr := range []uint64{0xfff, 0x1040, 0x2020} {
+		if line, ok := info.LineAt(addr); ok {
+			t.Fatalf("expected no line at %#x, got %d", addr, line.LineNum)
+		}
+	}
+}
+
+func TestProgInfoLineAtInsn(t *testing.T) {
+	info := testProgInfo()
+
+	for _, tc := range []struct {
+		insnOff uint32
+		lineNum uint32
+	}{
+		{0, 10},
+		{3, 10},
+		{4, 11},
+		{10, 20},
+		{100, 12},
+	} {
+		line, ok := info.LineAtInsn(tc.insnOff)
+		if !ok {
+			t.Fatalf("expected a line at insn %d", tc.insnOff)
+		}
+		if line.LineNum != tc.lineNum {
+			t.Fatalf("expected line %d at insn %d, got %d", tc.lineNum, tc.insnOff, line.LineNum)
+		}
+	}
+
+	if _, ok := (&BPFProgInfo{}).LineAtInsn(0); ok {
+		t.Fatal("expected no line without line info")
+	}
+}
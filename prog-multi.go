@@ -0,0 +1,443 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"bufio"
+	"errors"
+	"fmt"
+	"os"
+	"path"
+	"path/filepath"
+	"runtime"
+	"strings"
+	"syscall"
+	"unsafe"
+)
+
+//
+// Multi attach
+//
+
+// errnoNotSupported is the kernel ENOTSUPP, returned for unsupported
+// operations, which has no syscall constant.
+const errnoNotSupported = syscall.Errno(524)
+
+// KprobeMultiOpts are the targets of BPFProg.AttachKprobeMulti.
+type KprobeMultiOpts struct {
+	// Symbols are the kernel functions to attach to.
+	Symbols []string
+	// Pattern is a glob matching the kernel functions to attach to (e.g.
+	// "tcp_*"), instead of Symbols.
+	Pattern string
+	// Cookies are the BPF cookies of the Symbols (bpf_get_attach_cookie), in
+	// the same order. Not supported with Pattern.
+	Cookies []uint64
+	// Retprobe attaches to the function returns.
+	Retprobe bool
+}
+
+// AttachKprobeMulti attaches the program to many kernel functions at once,
+// through a single kprobe_multi link (since kernel 5.18), instead of a perf
+// event per function. The program should be defined with SEC("kprobe.multi")
+// (or SEC("kretprobe.multi")).
+//
+// On kernels without kprobe_multi links, as probed once through the
+// ProbeCache of the module, it falls back to attaching a kprobe per function,
+// concurrently, and returns all of their links. The attachment
+// is all or nothing.
+func (p *BPFProg) AttachKprobeMulti(opts KprobeMultiOpts) ([]*BPFLink, error) {
+	if opts.Pattern != "" && (len(opts.Symbols) > 0 || len(opts.Cookies) > 0) {
+		return nil, errors.New("kprobe multi pattern can't be used with symbols or cookies")
+	}
+	if opts.Pattern == "" && len(opts.Symbols) == 0 {
+		return nil, errors.New("kprobe multi needs symbols or a pattern")
+	}
+	if len(opts.Cookies) > 0 && len(opts.Cookies) != len(opts.Symbols) {
+		return nil, fmt.Errorf("kprobe multi has %d cookies for %d symbols", len(opts.Cookies), len(opts.Symbols))
+	}
+
+	supported, err := p.module.probes().KprobeMultiIsSupported()
+	if err != nil {
+		return nil, fmt.Errorf("failed to probe kprobe multi links: %w", err)
+	}
+	if !supported {
+		return attachKprobesFallback(p, opts)
+	}
+
+	link, err := doAttachKprobeMulti(p, opts)
+	if err != nil {
+		return nil, err
+	}
+
+	return []*BPFLink{link}, nil
+}
+
+func doAttachKprobeMulti(prog *BPFProg, opts KprobeMultiOpts) (*BPFLink, error) {
+	cnt := len(opts.Symbols)
+	symsC, freeSyms := cStringArray(opts.Symbols)
+	defer freeSyms()
+	cookiesC := cU64Array(opts.Cookies)
+	defer C.free(unsafe.Pointer(cookiesC))
+
+	optsC, errno := C.cgo_bpf_kprobe_multi_opts_new(symsC, cookiesC, C.size_t(cnt), C.bool(opts.Retprobe))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create kprobe multi opts: %w", errno)
+	}
+	defer C.cgo_bpf_kprobe_multi_opts_free(optsC)
+
+	var patternC *C.char
+	if opts.Pattern != "" {
+		patternC = C.CString(opts.Pattern)
+		defer C.free(unsafe.Pointer(patternC))
+	}
+
+	eventName := multiEventName(opts.Pattern, opts.Symbols)
+	linkC, errno := C.bpf_program__attach_kprobe_multi_opts(prog.prog, patternC, optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach k(ret)probe multi %s to program %s: %w", eventName, prog.Name(), errno)
+	}
+
+	linkType := KprobeMulti
+	if opts.Retprobe {
+		linkType = KretprobeMulti
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      prog,
+		linkType:  linkType,
+		eventName: eventName,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachKprobeMulti(prog, opts)
+		},
+	}
+	prog.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// attachKprobesFallback attaches a kprobe per function of opts.
+func attachKprobesFallback(prog *BPFProg, opts KprobeMultiOpts) ([]*BPFLink, error) {
+	symbols := opts.Symbols
+	if opts.Pattern != "" {
+		var err error
+		symbols, err = kprobeSymbolsMatching(opts.Pattern)
+		if err != nil {
+			return nil, err
+		}
+		if len(symbols) == 0 {
+			return nil, fmt.Errorf("failed to attach kprobes to program %s: no function matches %s", prog.Name(), opts.Pattern)
+		}
+	}
+
+	links := make([]*BPFLink, len(symbols))
+	errs := make([]error, len(symbols))
+	jobs := make([]func(), len(symbols))
+	for i := range symbols {
+		i := i
+		var cookie uint64
+		if len(opts.Cookies) > 0 {
+			cookie = opts.Cookies[i]
+		}
+		jobs[i] = func() {
+			links[i], errs[i] = doAttachKprobeOpts(prog, symbols[i], opts.Retprobe, cookie)
+		}
+	}
+	runConcurrently(jobs, runtime.NumCPU())
+
+	for _, err := range errs {
+		if err == nil {
+			continue
+		}
+		for _, link := range links {
+			if link != nil {
+				_ = link.Destroy()
+				prog.module.removeLink(link)
+			}
+		}
+		return nil, err
+	}
+
+	return links, nil
+}
+
+func doAttachKprobeOpts(prog *BPFProg, kp string, isKretprobe bool, cookie uint64) (*BPFLink, error) {
+	if cookie == 0 {
+		return doAttachKprobe(prog, kp, isKretprobe)
+	}
+
+	optsC, errno := C.cgo_bpf_kprobe_opts_new(C.__u64(cookie), 0, C.bool(isKretprobe))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create kprobe opts: %w", errno)
+	}
+	defer C.cgo_bpf_kprobe_opts_free(optsC)
+
+	kpC := C.CString(kp)
+	defer C.free(unsafe.Pointer(kpC))
+
+	linkC, errno := C.bpf_program__attach_kprobe_opts(prog.prog, kpC, optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach %s k(ret)probe to program %s: %w", kp, prog.Name(), errno)
+	}
+
+	kpType := Kprobe
+	if isKretprobe {
+		kpType = Kretprobe
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      prog,
+		linkType:  kpType,
+		eventName: kp,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachKprobeOpts(prog, kp, isKretprobe, cookie)
+		},
+	}
+	prog.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// UprobeMultiOpts are the targets of BPFProg.AttachUprobeMulti.
+type UprobeMultiOpts struct {
+	// Path is the binary or library to attach to, relative or absolute.
+	Path string
+	// Pid is the process to attach to, -1 for all of them.
+	Pid int
+	// Pattern is a glob matching the functions to attach to (e.g. "SSL_*"),
+	// resolved from the binary symbols, instead of Symbols or Offsets.
+	Pattern string
+	// Symbols are the functions to attach to.
+	Symbols []string
+	// Offsets are the offsets in the binary to attach to, instead of Symbols.
+	Offsets []uint64
+	// RefCtrOffsets are the offsets of the reference counters (USDT
+	// semaphores) of the targets, if any.
+	RefCtrOffsets []uint64
+	// Cookies are the BPF cookies of the targets (bpf_get_attach_cookie).
+	Cookies []uint64
+	// Retprobe attaches to the function returns.
+	Retprobe bool
+}
+
+// AttachUprobeMulti attaches the program to many functions of a binary at
+// once, through a single uprobe_multi link (since kernel 6.6), instead of a
+// perf event per function and process. The program should be defined with
+// SEC("uprobe.multi") (or SEC("uretprobe.multi")). The binary symbols are
+// resolved in a single pass. It needs libbpf 1.3 or later, and fails with
+// EOPNOTSUPP when built against an older libbpf.
+func (p *BPFProg) AttachUprobeMulti(opts UprobeMultiOpts) (*BPFLink, error) {
+	cnt := len(opts.Symbols)
+	if cnt == 0 {
+		cnt = len(opts.Offsets)
+	}
+	if opts.Pattern != "" && cnt > 0 {
+		return nil, errors.New("uprobe multi pattern can't be used with symbols or offsets")
+	}
+	if opts.Pattern == "" && cnt == 0 {
+		return nil, errors.New("uprobe multi needs symbols, offsets or a pattern")
+	}
+	if len(opts.Symbols) > 0 && len(opts.Offsets) > 0 {
+		// libbpf fails with EINVAL rather than resolving one with the other
+		return nil, errors.New("uprobe multi symbols and offsets are mutually exclusive")
+	}
+	for _, extra := range [][]uint64{opts.RefCtrOffsets, opts.Cookies} {
+		if len(extra) > 0 && len(extra) != cnt {
+			return nil, fmt.Errorf("uprobe multi reference counters or cookies don't match its %d targets", cnt)
+		}
+	}
+
+	absPath, err := filepath.Abs(opts.Path)
+	if err != nil {
+		return nil, err
+	}
+	opts.Path = absPath
+
+	return doAttachUprobeMulti(p, opts)
+}
+
+func doAttachUprobeMulti(prog *BPFProg, opts UprobeMultiOpts) (*BPFLink, error) {
+	cnt := len(opts.Symbols)
+	if cnt == 0 {
+		cnt = len(opts.Offsets)
+	}
+	symsC, freeSyms := cStringArray(opts.Symbols)
+	defer freeSyms()
+	offsetsC := cULongArray(opts.Offsets)
+	defer C.free(unsafe.Pointer(offsetsC))
+	refCtrOffsetsC := cULongArray(opts.RefCtrOffsets)
+	defer C.free(unsafe.Pointer(refCtrOffsetsC))
+	cookiesC := cU64Array(opts.Cookies)
+	defer C.free(unsafe.Pointer(cookiesC))
+
+	optsC, errno := C.cgo_bpf_uprobe_multi_opts_new(
+		symsC,
+		offsetsC,
+		refCtrOffsetsC,
+		cookiesC,
+		C.size_t(cnt),
+		C.bool(opts.Retprobe),
+	)
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create uprobe multi opts: %w", errno)
+	}
+	defer C.cgo_bpf_uprobe_multi_opts_free(optsC)
+
+	pathC := C.CString(opts.Path)
+	defer C.free(unsafe.Pointer(pathC))
+	var patternC *C.char
+	if opts.Pattern != "" {
+		patternC = C.CString(opts.Pattern)
+		defer C.free(unsafe.Pointer(patternC))
+	}
+
+	eventName := fmt.Sprintf("%s:%d:%s", opts.Path, opts.Pid, multiEventName(opts.Pattern, opts.Symbols))
+	if opts.Pattern == "" && len(opts.Symbols) == 0 {
+		eventName = fmt.Sprintf("%s:%d:%d offsets", opts.Path, opts.Pid, cnt)
+	}
+	linkC, errno := C.cgo_bpf_program__attach_uprobe_multi(prog.prog, C.int(opts.Pid), pathC, patternC, optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach u(ret)probe multi %s to program %s: %w", eventName, prog.Name(), errno)
+	}
+
+	linkType := UprobeMulti
+	if opts.Retprobe {
+		linkType = UretprobeMulti
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      prog,
+		linkType:  linkType,
+		eventName: eventName,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachUprobeMulti(prog, opts)
+		},
+	}
+	prog.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+var availableFilterFunctionsPaths = []string{
+	"/sys/kernel/tracing/available_filter_functions",
+	"/sys/kernel/debug/tracing/available_filter_functions",
+}
+
+// kprobeSymbolsMatching returns the kprobe-able kernel functions matching the
+// glob pattern, like libbpf does for kprobe_multi links.
+func kprobeSymbolsMatching(pattern string) ([]string, error) {
+	seen := make(map[string]bool)
+	var symbols []string
+	err := scanAvailableFilterFunctions(func(name string) {
+		if seen[name] {
+			return
+		}
+		if ok, _ := path.Match(pattern, name); ok {
+			seen[name] = true
+			symbols = append(symbols, name)
+		}
+	})
+	if err != nil {
+		return nil, err
+	}
+
+	return symbols, nil
+}
+
+// scanAvailableFilterFunctions calls visit with the name of each function
+// listed in available_filter_functions, the functions ftrace can trace.
+func scanAvailableFilterFunctions(visit func(name string)) error {
+	var f *os.File
+	var err error
+	for _, p := range availableFilterFunctionsPaths {
+		f, err = os.Open(p)
+		if err == nil {
+			break
+		}
+	}
+	if err != nil {
+		return fmt.Errorf("failed to open available filter functions: %w", err)
+	}
+	defer f.Close()
+
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		// "name" or "name [module]"
+		name, _, _ := strings.Cut(scanner.Text(), " ")
+		visit(name)
+	}
+	if err := scanner.Err(); err != nil {
+		return fmt.Errorf("failed to read available filter functions: %w", err)
+	}
+
+	return nil
+}
+
+// cStringArray copies strs to a C array of C strings, nil if empty.
+func cStringArray(strs []string) (**C.char, func()) {
+	if len(strs) == 0 {
+		return nil, func() {}
+	}
+
+	arrC := (**C.char)(C.calloc(C.size_t(len(strs)), C.size_t(unsafe.Sizeof(uintptr(0)))))
+	arr := unsafe.Slice(arrC, len(strs))
+	for i, str := range strs {
+		arr[i] = C.CString(str)
+	}
+
+	return arrC, func() {
+		for _, strC := range arr {
+			C.free(unsafe.Pointer(strC))
+		}
+		C.free(unsafe.Pointer(arrC))
+	}
+}
+
+// cU64Array copies values to a C array, nil if empty.
+func cU64Array(values []uint64) *C.__u64 {
+	if len(values) == 0 {
+		return nil
+	}
+
+	arrC := (*C.__u64)(C.calloc(C.size_t(len(values)), 8))
+	arr := unsafe.Slice(arrC, len(values))
+	for i, v := range values {
+		arr[i] = C.__u64(v)
+	}
+
+	return arrC
+}
+
+// cULongArray copies values to a C array, nil if empty.
+func cULongArray(values []uint64) *C.ulong {
+	if len(values) == 0 {
+		return nil
+	}
+
+	arrC := (*C.ulong)(C.calloc(C.size_t(len(values)), C.size_t(unsafe.Sizeof(C.ulong(0)))))
+	arr := unsafe.Slice(arrC, len(values))
+	for i, v := range values {
+		arr[i] = C.ulong(v)
+	}
+
+	return arrC
+}
+
+// multiEventName names the targets of a multi link.
+func multiEventName(pattern string, targets []string) string {
+	switch {
+	case pattern != "":
+		return pattern
+	case len(targets) == 1:
+		return targets[0]
+	default:
+		return fmt.Sprintf("%s...(%d targets)", targets[0], len(targets))
+	}
+}
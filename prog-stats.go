@@ -0,0 +1,237 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"sync"
+	"syscall"
+	"time"
+)
+
+//
+// BPF program statistics
+//
+
+// BPFStats keeps the kernel collecting BPF program run time statistics
+// (BPF_ENABLE_STATS), which costs a little on every program run, until it is
+// closed. The statistics stay enabled while any BPFStats is open, including
+// the ones of other processes.
+type BPFStats struct {
+	fd int
+}
+
+// EnableBPFStats enables the BPF program run time statistics of the kernel.
+func EnableBPFStats() (*BPFStats, error) {
+	fdC := C.bpf_enable_stats(C.BPF_STATS_RUN_TIME)
+	if fdC < 0 {
+		return nil, fmt.Errorf("failed to enable BPF stats: %w", syscall.Errno(-fdC))
+	}
+
+	return &BPFStats{fd: int(fdC)}, nil
+}
+
+// Close stops holding the statistics enabled.
+func (s *BPFStats) Close() error {
+	if s.fd < 0 {
+		return nil
+	}
+	err := syscall.Close(s.fd)
+	s.fd = -1
+
+	return err
+}
+
+// ProgramStats are the cumulative run time statistics of a program. They only
+// grow while the statistics are enabled (see EnableBPFStats).
+type ProgramStats struct {
+	Name            string
+	ID              uint32
+	RunTime         time.Duration
+	RunCount        uint64
+	RecursionMisses uint64
+}
+
+// Stats returns the run time statistics of the program.
+func (p *BPFProg) Stats() (*ProgramStats, error) {
+	fd := p.FileDescriptor()
+	if fd < 0 {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+
+	return getProgramStatsByFD(fd, p.Name())
+}
+
+func getProgramStatsByFD(fd int, name string) (*ProgramStats, error) {
+	infoC := C.cgo_bpf_prog_info_new()
+	defer C.cgo_bpf_prog_info_free(infoC)
+
+	infoLenC := C.cgo_bpf_prog_info_size()
+	retC := C.bpf_prog_get_info_by_fd(C.int(fd), infoC, &infoLenC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to get program info for %s: %w", name, syscall.Errno(-retC))
+	}
+
+	return &ProgramStats{
+		Name:            name,
+		ID:              uint32(C.cgo_bpf_prog_info_id(infoC)),
+		RunTime:         time.Duration(C.cgo_bpf_prog_info_run_time_ns(infoC)),
+		RunCount:        uint64(C.cgo_bpf_prog_info_run_cnt(infoC)),
+		RecursionMisses: uint64(C.cgo_bpf_prog_info_recursion_misses(infoC)),
+	}, nil
+}
+
+// ProgramStats returns a snapshot of the run time statistics of the loaded
+// programs of the module. Reading them costs a syscall per program and
+// nothing otherwise.
+func (m *Module) ProgramStats() ([]ProgramStats, error) {
+	if !m.loaded {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+
+	var stats []ProgramStats
+	it := m.Iterator()
+	for prog := it.NextProgram(); prog != nil; prog = it.NextProgram() {
+		fd := prog.FileDescriptor()
+		if fd < 0 {
+			continue // not loaded
+		}
+		s, err := getProgramStatsByFD(fd, prog.Name())
+		if err != nil {
+			return nil, err
+		}
+		stats = append(stats, *s)
+	}
+
+	return stats, nil
+}
+
+// ProgramStatsInterval are the statistics of a program over a sampling
+// interval.
+type ProgramStatsInterval struct {
+	Name     string
+	Interval time.Duration
+	RunTime  time.Duration
+	RunCount uint64
+	// AvgRunTime is the average cost of a run.
+	AvgRunTime time.Duration
+	// Rate is the number of runs per second.
+	Rate float64
+	// CPU is the share of a CPU spent running the program.
+	CPU float64
+}
+
+// ProgramStatsSampler samples the statistics of the programs of a module,
+// holding them enabled while it runs. It is safe for concurrent use.
+type ProgramStatsSampler struct {
+	module *Module
+	stats  *BPFStats
+	mu     sync.Mutex // protects prev and last
+	prev   map[uint32]ProgramStats
+	last   time.Time
+	task   periodicTask
+}
+
+// NewProgramStatsSampler enables the BPF statistics and takes the first
+// sample of the module programs.
+func (m *Module) NewProgramStatsSampler() (*ProgramStatsSampler, error) {
+	stats, err := EnableBPFStats()
+	if err != nil {
+		return nil, err
+	}
+
+	s := &ProgramStatsSampler{
+		module: m,
+		stats:  stats,
+	}
+	if _, err := s.Sample(); err != nil {
+		stats.Close()
+		return nil, err
+	}
+
+	return s, nil
+}
+
+// Sample returns the statistics of the programs since the previous sample.
+func (s *ProgramStatsSampler) Sample() ([]ProgramStatsInterval, error) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	now := time.Now()
+	stats, err := s.module.ProgramStats()
+	if err != nil {
+		return nil, err
+	}
+
+	curr := make(map[uint32]ProgramStats, len(stats))
+	var intervals []ProgramStatsInterval
+	for _, st := range stats {
+		curr[st.ID] = st
+		prev, ok := s.prev[st.ID]
+		if !ok {
+			continue
+		}
+		intervals = append(intervals, newProgramStatsInterval(prev, st, now.Sub(s.last)))
+	}
+	s.prev = curr
+	s.last = now
+
+	return intervals, nil
+}
+
+func newProgramStatsInterval(prev, curr ProgramStats, interval time.Duration) ProgramStatsInterval {
+	i := ProgramStatsInterval{
+		Name:     curr.Name,
+		Interval: interval,
+		RunTime:  curr.RunTime - prev.RunTime,
+		RunCount: curr.RunCount - prev.RunCount,
+	}
+	if i.RunCount > 0 {
+		i.AvgRunTime = i.RunTime / time.Duration(i.RunCount)
+	}
+	if interval > 0 {
+		i.Rate = float64(i.RunCount) / interval.Seconds()
+		i.CPU = float64(i.RunTime) / float64(interval)
+	}
+
+	return i
+}
+
+// Start samples the statistics every interval, sending them to ch, until the
+// sampler is stopped or a sample fails. ch is closed when the sampling stops,
+// then Err tells why. It fails if the sampling is already started.
+func (s *ProgramStatsSampler) Start(interval time.Duration, ch chan<- []ProgramStatsInterval) error {
+	return s.task.start(interval, func(stop <-chan struct{}) error {
+		intervals, err := s.Sample()
+		if err != nil {
+			return err
+		}
+		select {
+		case ch <- intervals:
+		case <-stop:
+		}
+		return nil
+	}, func() { close(ch) })
+}
+
+// Err returns the error that stopped the last sampling started by Start, or
+// nil if it was stopped by Stop or is still running.
+func (s *ProgramStatsSampler) Err() error {
+	return s.task.lastErr()
+}
+
+// Stop stops the sampling started by Start.
+func (s *ProgramStatsSampler) Stop() {
+	s.task.stopAndWait()
+}
+
+// Close stops the sampling and stops holding the statistics enabled.
+func (s *ProgramStatsSampler) Close() error {
+	s.Stop()
+	return s.stats.Close()
+}
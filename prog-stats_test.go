@@ -0,0 +1,24 @@
+package libbpfgo
+
+import (
+	"testing"
+	"time"
+)
+
+func TestProgramStatsInterval(t *testing.T) {
+	prev := ProgramStats{Name: "handler", RunTime: 1000, RunCount: 10}
+	curr := ProgramStats{Name: "handler", RunTime: 51000, RunCount: 110}
+
+	i := newProgramStatsInterval(prev, curr, time.Second)
+	if i.RunCount != 100 || i.RunTime != 50000 || i.AvgRunTime != 500 {
+		t.Fatalf("got %d runs in %v, %v per run", i.RunCount, i.RunTime, i.AvgRunTime)
+	}
+	if i.Rate != 100 || i.CPU != 0.00005 {
+		t.Fatalf("got rate %f, cpu %f", i.Rate, i.CPU)
+	}
+
+	i = newProgramStatsInterval(curr, curr, 0)
+	if i.AvgRunTime != 0 || i.Rate != 0 {
+		t.Fatalf("expected an empty interval, got %+v", i)
+	}
+}
@@ -0,0 +1,253 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"syscall"
+	"unsafe"
+)
+
+//
+// TCX and netkit
+//
+
+// MultiProgPosition places a program among the other programs of a
+// multi-program attach point (TCX, netkit), which run in order.
+type MultiProgPosition int
+
+const (
+	// MultiProgLast appends the program after all the others.
+	MultiProgLast MultiProgPosition = iota
+	// MultiProgFirst prepends the program before all the others.
+	MultiProgFirst
+	// MultiProgBefore places the program right before the anchor.
+	MultiProgBefore
+	// MultiProgAfter places the program right after the anchor.
+	MultiProgAfter
+)
+
+// MultiProgOpts are the options of AttachTCX and AttachNetkit.
+type MultiProgOpts struct {
+	Position MultiProgPosition
+	// The anchor of MultiProgBefore and MultiProgAfter: one of a program, a
+	// link, or the ID of a program attached to the same hook.
+	AnchorProg   *BPFProg
+	AnchorLink   *BPFLink
+	AnchorProgID uint32
+	// ExpectedRevision makes the attach fail with ESTALE if the programs of
+	// the hook changed since it was queried (see QueryMultiProg), zero to
+	// skip the check.
+	ExpectedRevision uint64
+}
+
+// flags returns the flags and the relative fd or ID of the options.
+func (opts MultiProgOpts) flags() (uint32, uint32, uint32, error) {
+	var flags, relativeFd, relativeID uint32
+
+	switch opts.Position {
+	case MultiProgLast:
+		return 0, 0, 0, nil
+	case MultiProgFirst:
+		return C.BPF_F_BEFORE, 0, 0, nil
+	case MultiProgBefore:
+		flags = C.BPF_F_BEFORE
+	case MultiProgAfter:
+		flags = C.BPF_F_AFTER
+	default:
+		return 0, 0, 0, fmt.Errorf("unknown multi-program position %d", opts.Position)
+	}
+
+	switch {
+	case opts.AnchorProg != nil:
+		fd := opts.AnchorProg.FileDescriptor()
+		if fd < 0 {
+			return 0, 0, 0, fmt.Errorf("anchor program %s is not loaded", opts.AnchorProg.Name())
+		}
+		relativeFd = uint32(fd)
+	case opts.AnchorLink != nil:
+		flags |= C.BPF_F_LINK
+		relativeFd = uint32(opts.AnchorLink.FileDescriptor())
+	case opts.AnchorProgID != 0:
+		flags |= C.BPF_F_ID
+		relativeID = opts.AnchorProgID
+	default:
+		return 0, 0, 0, errors.New("multi-program position before or after needs an anchor")
+	}
+
+	return flags, relativeFd, relativeID, nil
+}
+
+type TCXAttachPoint uint32
+
+const (
+	TCXIngress TCXAttachPoint = C.BPF_TCX_INGRESS
+	TCXEgress  TCXAttachPoint = C.BPF_TCX_EGRESS
+)
+
+type NetkitAttachPoint uint32
+
+const (
+	// NetkitPrimary is the host side of a netkit device pair.
+	NetkitPrimary NetkitAttachPoint = C.BPF_NETKIT_PRIMARY
+	// NetkitPeer is the container side of a netkit device pair.
+	NetkitPeer NetkitAttachPoint = C.BPF_NETKIT_PEER
+)
+
+// checkAttachType checks the attach point against the expected attach type
+// of the program, which libbpf attaches with and which is set at load time
+// by its section (e.g. SEC("tcx/ingress")) or SetExpectedAttachType.
+func (p *BPFProg) checkAttachType(attachType BPFAttachType) error {
+	expected := BPFAttachType(C.bpf_program__expected_attach_type(p.prog))
+	if expected != attachType {
+		return fmt.Errorf("program %s is loaded for %s, not %s", p.Name(), expected, attachType)
+	}
+
+	return nil
+}
+
+// AttachTCX attaches the BPFProgram, defined with SEC("tcx/ingress") or
+// SEC("tcx/egress"), to the TCX hook of the interface. Unlike the netlink
+// based TcHook, the attach is a single bpf() syscall, and the program is
+// detached when its link is destroyed, including when the process exits.
+// Several programs can be attached to a hook, ordered by opts. It needs
+// libbpf 1.3 or later, and fails with EOPNOTSUPP when built against an older
+// libbpf.
+func (p *BPFProg) AttachTCX(ifindex int, attachPoint TCXAttachPoint, opts MultiProgOpts) (*BPFLink, error) {
+	if err := p.checkAttachType(BPFAttachType(attachPoint)); err != nil {
+		return nil, err
+	}
+	flags, relativeFd, relativeID, err := opts.flags()
+	if err != nil {
+		return nil, err
+	}
+
+	optsC, errno := C.cgo_bpf_tcx_opts_new(C.__u32(flags), C.__u32(relativeFd), C.__u32(relativeID), C.__u64(opts.ExpectedRevision))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create tcx_opts of %s: %w", p.Name(), errno)
+	}
+	defer C.cgo_bpf_tcx_opts_free(optsC)
+
+	linkC, errno := C.cgo_bpf_program__attach_tcx(p.prog, C.int(ifindex), optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach tcx on interface %d to program %s: %w", ifindex, p.Name(), errno)
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      p,
+		linkType:  TCX,
+		eventName: fmt.Sprintf("tcx-%s-%d", p.Name(), ifindex),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachTCX(ifindex, attachPoint, MultiProgOpts{})
+		},
+	}
+	p.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// AttachNetkit attaches the BPFProgram, defined with SEC("netkit/primary") or
+// SEC("netkit/peer"), to the netkit device of the interface. Netkit devices
+// replace veth pairs, running the program of the container side in the
+// namespace switch instead of on the backlog queue. Several programs can be
+// attached to a device, ordered by opts. It needs libbpf 1.4 or later, and
+// fails with EOPNOTSUPP when built against an older libbpf.
+func (p *BPFProg) AttachNetkit(ifindex int, attachPoint NetkitAttachPoint, opts MultiProgOpts) (*BPFLink, error) {
+	if err := p.checkAttachType(BPFAttachType(attachPoint)); err != nil {
+		return nil, err
+	}
+	flags, relativeFd, relativeID, err := opts.flags()
+	if err != nil {
+		return nil, err
+	}
+
+	optsC, errno := C.cgo_bpf_netkit_opts_new(C.__u32(flags), C.__u32(relativeFd), C.__u32(relativeID), C.__u64(opts.ExpectedRevision))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create netkit_opts of %s: %w", p.Name(), errno)
+	}
+	defer C.cgo_bpf_netkit_opts_free(optsC)
+
+	linkC, errno := C.cgo_bpf_program__attach_netkit(p.prog, C.int(ifindex), optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach netkit on interface %d to program %s: %w", ifindex, p.Name(), errno)
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      p,
+		linkType:  Netkit,
+		eventName: fmt.Sprintf("netkit-%s-%d", p.Name(), ifindex),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachNetkit(ifindex, attachPoint, MultiProgOpts{})
+		},
+	}
+	p.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// MultiProgQuery are the programs of a multi-program attach point, in the
+// order they run.
+type MultiProgQuery struct {
+	// Revision changes with every attach and detach of the hook.
+	Revision uint64
+	ProgIDs  []uint32
+	// LinkIDs are the links of the programs, zero for the programs attached
+	// without a link.
+	LinkIDs []uint32
+}
+
+// QueryMultiProg returns the programs attached to the TCX or netkit hook of
+// an interface (e.g. BPFAttachTypeTCXIngress). It needs libbpf 1.3 or later,
+// and fails with EOPNOTSUPP when built against an older libbpf.
+func QueryMultiProg(ifindex int, attachType BPFAttachType) (*MultiProgQuery, error) {
+	// first call for the number of programs
+	optsC, errno := C.cgo_bpf_prog_query_opts_new(nil, nil, 0)
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create bpf_prog_query_opts: %w", errno)
+	}
+	defer C.cgo_bpf_prog_query_opts_free(optsC)
+
+	retC := C.bpf_prog_query_opts(C.int(ifindex), uint32(attachType), optsC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to query %s programs of interface %d: %w", attachType, ifindex, syscall.Errno(-retC))
+	}
+
+	query := &MultiProgQuery{
+		Revision: uint64(C.cgo_bpf_prog_query_opts_revision(optsC)),
+	}
+	count := C.cgo_bpf_prog_query_opts_count(optsC)
+	if count == 0 {
+		return query, nil
+	}
+
+	// the programs may change in between, the kernel then fails with ENOSPC
+	// or returns fewer
+	progIDsC := C.calloc(C.size_t(count), C.size_t(unsafe.Sizeof(C.__u32(0))))
+	defer C.free(progIDsC)
+	linkIDsC := C.calloc(C.size_t(count), C.size_t(unsafe.Sizeof(C.__u32(0))))
+	defer C.free(linkIDsC)
+	idsOptsC, errno := C.cgo_bpf_prog_query_opts_new((*C.__u32)(progIDsC), (*C.__u32)(linkIDsC), count)
+	if idsOptsC == nil {
+		return nil, fmt.Errorf("failed to create bpf_prog_query_opts: %w", errno)
+	}
+	defer C.cgo_bpf_prog_query_opts_free(idsOptsC)
+
+	retC = C.bpf_prog_query_opts(C.int(ifindex), uint32(attachType), idsOptsC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to query %s programs of interface %d: %w", attachType, ifindex, syscall.Errno(-retC))
+	}
+
+	count = C.cgo_bpf_prog_query_opts_count(idsOptsC)
+	query.Revision = uint64(C.cgo_bpf_prog_query_opts_revision(idsOptsC))
+	query.ProgIDs = append([]uint32(nil), unsafe.Slice((*uint32)(progIDsC), count)...)
+	query.LinkIDs = append([]uint32(nil), unsafe.Slice((*uint32)(linkIDsC), count)...)
+
+	return query, nil
+}
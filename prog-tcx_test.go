@@ -0,0 +1,44 @@
+package libbpfgo
+
+import (
+	"testing"
+)
+
+func TestMultiProgOptsFlags(t *testing.T) {
+	const (
+		before = 1 << 3 // BPF_F_BEFORE
+		after  = 1 << 4 // BPF_F_AFTER
+		id     = 1 << 5 // BPF_F_ID
+	)
+
+	for _, tc := range []struct {
+		opts       MultiProgOpts
+		flags      uint32
+		relativeID uint32
+	}{
+		{MultiProgOpts{}, 0, 0},
+		{MultiProgOpts{AnchorProgID: 7}, 0, 0},
+		{MultiProgOpts{Position: MultiProgFirst}, before, 0},
+		{MultiProgOpts{Position: MultiProgBefore, AnchorProgID: 7}, before | id, 7},
+		{MultiProgOpts{Position: MultiProgAfter, AnchorProgID: 7}, after | id, 7},
+	} {
+		flags, relativeFd, relativeID, err := tc.opts.flags()
+		if err != nil {
+			t.Fatal(err)
+		}
+		if flags != tc.flags || relativeFd != 0 || relativeID != tc.relativeID {
+			t.Fatalf("%+v: expected flags %#x and id %d, got flags %#x, fd %d and id %d",
+				tc.opts, tc.flags, tc.relativeID, flags, relativeFd, relativeID)
+		}
+	}
+
+	for _, opts := range []MultiProgOpts{
+		{Position: MultiProgBefore},
+		{Position: MultiProgAfter},
+		{Position: MultiProgPosition(42)},
+	} {
+		if _, _, _, err := opts.flags(); err == nil {
+			t.Fatalf("%+v: expected an error", opts)
+		}
+	}
+}
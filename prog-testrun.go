@@ -0,0 +1,227 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"sort"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+//
+// BPFProg test run
+//
+
+// TestRunFlag is a flag of BPF_PROG_TEST_RUN.
+type TestRunFlag uint32
+
+const (
+	TestRunFlagOnCPU         TestRunFlag = C.BPF_F_TEST_RUN_ON_CPU
+	TestRunFlagXDPLiveFrames TestRunFlag = C.BPF_F_TEST_XDP_LIVE_FRAMES
+)
+
+// testRunOutHeadroom is the room left for programs growing the packet.
+const testRunOutHeadroom = 256
+
+// TestRunOpts is the input of BPFProg.TestRun. Which of data and context a
+// program takes depends on its type (e.g. XDP and TC programs take a packet
+// as data, raw tracepoints and syscall programs take a context).
+type TestRunOpts struct {
+	DataIn []byte
+	// DataOutSize is the capacity of the output data, len(DataIn) plus some
+	// headroom if zero.
+	DataOutSize uint32
+	CtxIn       []byte
+	// CtxOutSize is the capacity of the output context, none if zero (some
+	// program types, e.g. raw tracepoints, reject an output context).
+	CtxOutSize uint32
+	// Repeat is the number of times the kernel runs the program.
+	Repeat    int
+	Flags     TestRunFlag
+	CPU       uint32 // with TestRunFlagOnCPU
+	BatchSize uint32 // with TestRunFlagXDPLiveFrames
+}
+
+// TestRunResult is the output of BPFProg.TestRun.
+type TestRunResult struct {
+	RetVal  uint32
+	DataOut []byte
+	CtxOut  []byte
+	// Duration is the average duration of a run, as measured by the kernel.
+	Duration time.Duration
+}
+
+// TestRun runs the program in the kernel, without attaching it, through
+// BPF_PROG_TEST_RUN. It must be called after the BPF object is loaded.
+func (p *BPFProg) TestRun(opts TestRunOpts) (*TestRunResult, error) {
+	fd := p.FileDescriptor()
+	if fd < 0 {
+		return nil, errors.New("must be called after the BPF object is loaded")
+	}
+
+	dataOutSize := opts.DataOutSize
+	if dataOutSize == 0 && len(opts.DataIn) > 0 {
+		dataOutSize = uint32(len(opts.DataIn)) + testRunOutHeadroom
+	}
+	// the kernel reads and writes C memory, since Go pointers can't be
+	// stored in the C options
+	dataInC := cBytesOrNil(opts.DataIn)
+	defer C.free(dataInC)
+	ctxInC := cBytesOrNil(opts.CtxIn)
+	defer C.free(ctxInC)
+	dataOutC := cMallocOrNil(dataOutSize)
+	defer C.free(dataOutC)
+	ctxOutC := cMallocOrNil(opts.CtxOutSize)
+	defer C.free(ctxOutC)
+
+	optsC, errno := C.cgo_bpf_test_run_opts_new(
+		dataInC,
+		dataOutC,
+		C.uint(len(opts.DataIn)),
+		C.uint(dataOutSize),
+		ctxInC,
+		ctxOutC,
+		C.uint(len(opts.CtxIn)),
+		C.uint(opts.CtxOutSize),
+		C.int(opts.Repeat),
+		C.uint(opts.Flags),
+		C.uint(opts.CPU),
+		C.uint(opts.BatchSize),
+	)
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create test run opts: %w", errno)
+	}
+	defer C.cgo_bpf_test_run_opts_free(optsC)
+
+	retC := C.bpf_prog_test_run_opts(C.int(fd), optsC)
+	if retC < 0 {
+		return nil, fmt.Errorf("failed to test run program %s: %w", p.Name(), syscall.Errno(-retC))
+	}
+
+	result := &TestRunResult{
+		RetVal:   uint32(C.cgo_bpf_test_run_opts_retval(optsC)),
+		Duration: time.Duration(C.cgo_bpf_test_run_opts_duration(optsC)),
+	}
+	if dataOutC != nil {
+		size := C.cgo_bpf_test_run_opts_data_size_out(optsC)
+		result.DataOut = C.GoBytes(dataOutC, C.int(size))
+	}
+	if ctxOutC != nil {
+		size := C.cgo_bpf_test_run_opts_ctx_size_out(optsC)
+		result.CtxOut = C.GoBytes(ctxOutC, C.int(size))
+	}
+
+	return result, nil
+}
+
+func cBytesOrNil(b []byte) unsafe.Pointer {
+	if len(b) == 0 {
+		return nil
+	}
+	return C.CBytes(b)
+}
+
+func cMallocOrNil(size uint32) unsafe.Pointer {
+	if size == 0 {
+		return nil
+	}
+	return C.calloc(1, C.size_t(size))
+}
+
+//
+// BPFProg benchmark
+//
+
+// BenchmarkOpts is the input of BPFProg.Benchmark.
+type BenchmarkOpts struct {
+	// Inputs are the test runs, used in turn by the samples.
+	Inputs []TestRunOpts
+	// Samples is the number of test runs.
+	Samples int
+	// Repeat overrides the repeat count of each input, so each sample is
+	// the average of many runs.
+	Repeat int
+}
+
+// BenchmarkResult is the distribution of the durations of a program run.
+type BenchmarkResult struct {
+	// Samples are the average durations of a run of each sample, sorted.
+	Samples []time.Duration
+	Min     time.Duration
+	Max     time.Duration
+	Mean    time.Duration
+}
+
+// Percentile returns the duration under which the given percentage (0 to
+// 100) of the samples are.
+func (r *BenchmarkResult) Percentile(percent float64) time.Duration {
+	if len(r.Samples) == 0 {
+		return 0
+	}
+	i := int(percent / 100 * float64(len(r.Samples)-1))
+	if i < 0 {
+		i = 0
+	}
+	if i >= len(r.Samples) {
+		i = len(r.Samples) - 1
+	}
+
+	return r.Samples[i]
+}
+
+// String returns the result in ns/op.
+func (r *BenchmarkResult) String() string {
+	return fmt.Sprintf("min %d ns/op, mean %d ns/op, p50 %d ns/op, p99 %d ns/op, max %d ns/op",
+		r.Min.Nanoseconds(), r.Mean.Nanoseconds(),
+		r.Percentile(50).Nanoseconds(), r.Percentile(99).Nanoseconds(),
+		r.Max.Nanoseconds())
+}
+
+// Benchmark measures the cost of the program, test running it with the
+// synthetic inputs, and returns the distribution of its ns/op.
+func (p *BPFProg) Benchmark(opts BenchmarkOpts) (*BenchmarkResult, error) {
+	if len(opts.Inputs) == 0 {
+		return nil, errors.New("benchmark needs at least one input")
+	}
+	if opts.Samples <= 0 {
+		return nil, errors.New("benchmark needs at least one sample")
+	}
+
+	samples := make([]time.Duration, 0, opts.Samples)
+	for i := 0; i < opts.Samples; i++ {
+		input := opts.Inputs[i%len(opts.Inputs)]
+		if opts.Repeat > 0 {
+			input.Repeat = opts.Repeat
+		}
+		result, err := p.TestRun(input)
+		if err != nil {
+			return nil, err
+		}
+		samples = append(samples, result.Duration)
+	}
+
+	return newBenchmarkResult(samples), nil
+}
+
+func newBenchmarkResult(samples []time.Duration) *BenchmarkResult {
+	sort.Slice(samples, func(i, j int) bool { return samples[i] < samples[j] })
+
+	var sum time.Duration
+	for _, s := range samples {
+		sum += s
+	}
+
+	return &BenchmarkResult{
+		Samples: samples,
+		Min:     samples[0],
+		Max:     samples[len(samples)-1],
+		Mean:    sum / time.Duration(len(samples)),
+	}
+}
@@ -0,0 +1,23 @@
+package libbpfgo
+
+import (
+	"testing"
+	"time"
+)
+
+func TestBenchmarkResult(t *testing.T) {
+	result := newBenchmarkResult([]time.Duration{40, 10, 30, 20, 100})
+
+	if result.Min != 10 || result.Max != 100 || result.Mean != 40 {
+		t.Fatalf("got min %d, max %d, mean %d", result.Min, result.Max, result.Mean)
+	}
+	if p := result.Percentile(50); p != 30 {
+		t.Fatalf("got p50 %d, expected 30", p)
+	}
+	if p := result.Percentile(100); p != 100 {
+		t.Fatalf("got p100 %d, expected 100", p)
+	}
+	if p := result.Percentile(0); p != 10 {
+		t.Fatalf("got p0 %d, expected 10", p)
+	}
+}
@@ -0,0 +1,298 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strconv"
+	"sync"
+	"syscall"
+	"unsafe"
+)
+
+//
+// Process set uprobes
+//
+
+// UprobeManagerOpts configures an UprobeManager.
+type UprobeManagerOpts struct {
+	// Path is the binary or library to probe, as seen from the mount
+	// namespace of the processes (e.g. /usr/lib/x86_64-linux-gnu/libssl.so.3).
+	Path string
+	// Symbol is the function to probe, resolved by libbpf in each binary.
+	// Offset is used instead if Symbol is empty.
+	Symbol string
+	// Offset is the offset of the probe in the binary, or in the symbol if
+	// Symbol is set.
+	Offset   uint32
+	Retprobe bool
+	// Cookie is read by bpf_get_attach_cookie().
+	Cookie uint64
+}
+
+// uprobeBinaryKey identifies a binary across mount namespaces.
+type uprobeBinaryKey struct {
+	dev uint64
+	ino uint64
+}
+
+type uprobeBinary struct {
+	link *BPFLink
+	pids map[int]struct{}
+}
+
+// UprobeManager attaches an uprobe to the binary used by a set of processes,
+// possibly in other mount namespaces (containers). The binary of each process
+// is resolved through /proc/<pid>/root, and processes using the same binary
+// (same device and inode) share a single attachment: a binary used by
+// thousands of processes is probed once.
+//
+// Since uprobes are set on the binary and not on a process, the program runs
+// for every process using a probed binary, in the set or not: it should
+// filter by pid if that matters. It is safe for concurrent use.
+type UprobeManager struct {
+	opts UprobeManagerOpts
+
+	mu       sync.Mutex
+	binaries map[uprobeBinaryKey]*uprobeBinary
+	pids     map[int]uprobeBinaryKey
+
+	// overridden by tests
+	procRoot string
+	attach   func(path string) (*BPFLink, error)
+	detach   func(link *BPFLink) error
+}
+
+// NewUprobeManager creates an UprobeManager attaching the program, with no
+// process yet.
+func (p *BPFProg) NewUprobeManager(opts UprobeManagerOpts) (*UprobeManager, error) {
+	if !filepath.IsAbs(opts.Path) {
+		return nil, errors.New("uprobe manager needs an absolute path")
+	}
+
+	return &UprobeManager{
+		opts:     opts,
+		binaries: make(map[uprobeBinaryKey]*uprobeBinary),
+		pids:     make(map[int]uprobeBinaryKey),
+		procRoot: "/proc",
+		attach: func(path string) (*BPFLink, error) {
+			return doAttachUprobeSymbol(p, path, opts)
+		},
+		detach: func(link *BPFLink) error {
+			if err := link.Destroy(); err != nil {
+				return err
+			}
+			link.prog.module.removeLink(link)
+
+			return nil
+		},
+	}, nil
+}
+
+func doAttachUprobeSymbol(prog *BPFProg, path string, opts UprobeManagerOpts) (*BPFLink, error) {
+	var symbolC *C.char
+	if opts.Symbol != "" {
+		symbolC = C.CString(opts.Symbol)
+		defer C.free(unsafe.Pointer(symbolC))
+	}
+	optsC, errno := C.cgo_bpf_uprobe_opts_new(symbolC, C.__u64(opts.Cookie), C.bool(opts.Retprobe))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create uprobe opts: %w", errno)
+	}
+	defer C.cgo_bpf_uprobe_opts_free(optsC)
+
+	pathC := C.CString(path)
+	defer C.free(unsafe.Pointer(pathC))
+
+	linkC, errno := C.bpf_program__attach_uprobe_opts(prog.prog, -1, pathC, C.size_t(opts.Offset), optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach u(ret)probe %s:%s+%d to program %s: %w", path, opts.Symbol, opts.Offset, prog.Name(), errno)
+	}
+
+	upType := Uprobe
+	if opts.Retprobe {
+		upType = Uretprobe
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      prog,
+		linkType:  upType,
+		eventName: fmt.Sprintf("%s:%s:%d", path, opts.Symbol, opts.Offset),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachUprobeSymbol(prog, path, opts)
+		},
+	}
+	prog.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// resolve returns the path of the binary in the mount namespace of the
+// process, and its identity.
+func (m *UprobeManager) resolve(pid int) (string, uprobeBinaryKey, error) {
+	path := filepath.Join(m.procRoot, strconv.Itoa(pid), "root", m.opts.Path)
+	info, err := os.Stat(path)
+	if err != nil {
+		return "", uprobeBinaryKey{}, err
+	}
+	stat, ok := info.Sys().(*syscall.Stat_t)
+	if !ok {
+		return "", uprobeBinaryKey{}, fmt.Errorf("failed to stat %s", path)
+	}
+
+	return path, uprobeBinaryKey{dev: uint64(stat.Dev), ino: uint64(stat.Ino)}, nil
+}
+
+// AddProcess adds a process to the set, attaching to its binary unless
+// another process of the set uses the same one. A process added again (e.g.
+// after an exec) moves to its current binary. It fails, with an error
+// matching os.ErrNotExist, if the process doesn't have the binary.
+func (m *UprobeManager) AddProcess(pid int) error {
+	path, key, err := m.resolve(pid)
+	if err != nil {
+		return err
+	}
+
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.addProcess(pid, path, key)
+}
+
+func (m *UprobeManager) addProcess(pid int, path string, key uprobeBinaryKey) error {
+	if prev, ok := m.pids[pid]; ok {
+		if prev == key {
+			return nil
+		}
+		if err := m.removeProcess(pid); err != nil {
+			return err
+		}
+	}
+
+	binary, ok := m.binaries[key]
+	if !ok {
+		link, err := m.attach(path)
+		if err != nil {
+			return err
+		}
+		binary = &uprobeBinary{
+			link: link,
+			pids: make(map[int]struct{}),
+		}
+		m.binaries[key] = binary
+	}
+	binary.pids[pid] = struct{}{}
+	m.pids[pid] = key
+
+	return nil
+}
+
+// RemoveProcess removes a process from the set (e.g. when it exits),
+// detaching from its binary if no other process of the set uses it.
+func (m *UprobeManager) RemoveProcess(pid int) error {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.removeProcess(pid)
+}
+
+func (m *UprobeManager) removeProcess(pid int) error {
+	key, ok := m.pids[pid]
+	if !ok {
+		return nil
+	}
+	delete(m.pids, pid)
+
+	binary := m.binaries[key]
+	delete(binary.pids, pid)
+	if len(binary.pids) > 0 {
+		return nil
+	}
+	delete(m.binaries, key)
+
+	return m.detach(binary.link)
+}
+
+// Sync updates the set to the given processes: the processes no longer given
+// are removed, the new ones are added and the ones that exec'd another
+// binary are moved. The given processes that don't have the binary (or
+// exited) are skipped. The first attach or detach error is returned, after
+// the other processes are synced.
+func (m *UprobeManager) Sync(pids []int) error {
+	type resolved struct {
+		pid  int
+		path string
+		key  uprobeBinaryKey
+	}
+	current := make(map[int]bool, len(pids))
+	targets := make([]resolved, 0, len(pids))
+	for _, pid := range pids {
+		path, key, err := m.resolve(pid)
+		if err != nil {
+			continue
+		}
+		current[pid] = true
+		targets = append(targets, resolved{pid, path, key})
+	}
+
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	var firstErr error
+	for pid := range m.pids {
+		if current[pid] {
+			continue
+		}
+		if err := m.removeProcess(pid); err != nil && firstErr == nil {
+			firstErr = err
+		}
+	}
+	for _, t := range targets {
+		if err := m.addProcess(t.pid, t.path, t.key); err != nil && firstErr == nil {
+			firstErr = err
+		}
+	}
+
+	return firstErr
+}
+
+// Processes returns the number of processes in the set.
+func (m *UprobeManager) Processes() int {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return len(m.pids)
+}
+
+// Binaries returns the number of binaries attached to.
+func (m *UprobeManager) Binaries() int {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return len(m.binaries)
+}
+
+// Close detaches from all the binaries and empties the set.
+func (m *UprobeManager) Close() error {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	var firstErr error
+	for key, binary := range m.binaries {
+		if err := m.detach(binary.link); err != nil && firstErr == nil {
+			firstErr = err
+		}
+		delete(m.binaries, key)
+	}
+	m.pids = make(map[int]uprobeBinaryKey)
+
+	return firstErr
+}
@@ -0,0 +1,97 @@
+package libbpfgo
+
+import (
+	"os"
+	"path/filepath"
+	"strconv"
+	"testing"
+)
+
+func TestUprobeManager(t *testing.T) {
+	procRoot := t.TempDir()
+	lib := "/usr/lib/libtarget.so"
+	addProc := func(pid int) string {
+		path := filepath.Join(procRoot, strconv.Itoa(pid), "root", lib)
+		if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+			t.Fatal(err)
+		}
+		return path
+	}
+
+	// processes 1 and 2 share a binary (same inode), process 3 has its own
+	shared := addProc(1)
+	if err := os.WriteFile(shared, []byte("shared"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.Link(shared, addProc(2)); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.WriteFile(addProc(3), []byte("other"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	addProc(4) // without the binary
+
+	attached := map[string]int{}
+	m := &UprobeManager{
+		opts:     UprobeManagerOpts{Path: lib},
+		binaries: make(map[uprobeBinaryKey]*uprobeBinary),
+		pids:     make(map[int]uprobeBinaryKey),
+		procRoot: procRoot,
+		attach: func(path string) (*BPFLink, error) {
+			attached[path]++
+			return &BPFLink{eventName: path}, nil
+		},
+		detach: func(link *BPFLink) error {
+			attached[link.eventName]--
+			return nil
+		},
+	}
+
+	if err := m.Sync([]int{1, 2, 3, 4}); err != nil {
+		t.Fatal(err)
+	}
+	if m.Processes() != 3 || m.Binaries() != 2 {
+		t.Fatalf("expected 3 processes on 2 binaries, got %d on %d", m.Processes(), m.Binaries())
+	}
+	if err := m.AddProcess(4); !os.IsNotExist(err) {
+		t.Fatalf("expected a not exist error, got %v", err)
+	}
+
+	// the shared binary stays attached until its last process goes
+	if err := m.RemoveProcess(1); err != nil {
+		t.Fatal(err)
+	}
+	if m.Binaries() != 2 {
+		t.Fatalf("expected 2 binaries, got %d", m.Binaries())
+	}
+	if err := m.Sync([]int{3}); err != nil {
+		t.Fatal(err)
+	}
+	if m.Processes() != 1 || m.Binaries() != 1 {
+		t.Fatalf("expected 1 process on 1 binary, got %d on %d", m.Processes(), m.Binaries())
+	}
+
+	// process 3 exec'd the shared binary
+	path3 := filepath.Join(procRoot, "3", "root", lib)
+	if err := os.Remove(path3); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.Link(shared, path3); err != nil {
+		t.Fatal(err)
+	}
+	if err := m.AddProcess(3); err != nil {
+		t.Fatal(err)
+	}
+	if m.Processes() != 1 || m.Binaries() != 1 {
+		t.Fatalf("expected 1 process on 1 binary, got %d on %d", m.Processes(), m.Binaries())
+	}
+
+	if err := m.Close(); err != nil {
+		t.Fatal(err)
+	}
+	for path, n := range attached {
+		if n != 0 {
+			t.Fatalf("%s attached %d times after close", path, n)
+		}
+	}
+}
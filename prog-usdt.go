@@ -0,0 +1,68 @@
+package libbpfgo
+
+/*
+#cgo LDFLAGS: -lelf -lz
+#include "libbpfgo.h"
+*/
+import "C"
+
+import (
+	"fmt"
+	"path/filepath"
+	"unsafe"
+)
+
+//
+// USDT
+//
+
+// AttachUSDT attaches the BPFProgram, defined with SEC("usdt"), to the USDT
+// probe provider:name of the binary or library at binaryPath, which can be
+// relative or absolute. A pid can be provided to attach to, or -1 to attach
+// to all processes: tracing all the processes running a binary through a
+// single link is cheaper than a link per process. The cookie is read with
+// bpf_usdt_cookie().
+//
+// libbpf fails to attach to a probe the binary doesn't have. The probes of a
+// binary can be listed with helpers.USDTProbes.
+func (p *BPFProg) AttachUSDT(pid int, binaryPath, provider, name string, cookie uint64) (*BPFLink, error) {
+	absPath, err := filepath.Abs(binaryPath)
+	if err != nil {
+		return nil, err
+	}
+
+	return doAttachUSDT(p, pid, absPath, provider, name, cookie)
+}
+
+func doAttachUSDT(prog *BPFProg, pid int, path, provider, name string, cookie uint64) (*BPFLink, error) {
+	optsC, errno := C.cgo_bpf_usdt_opts_new(C.__u64(cookie))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create usdt opts: %w", errno)
+	}
+	defer C.cgo_bpf_usdt_opts_free(optsC)
+
+	pathC := C.CString(path)
+	defer C.free(unsafe.Pointer(pathC))
+	providerC := C.CString(provider)
+	defer C.free(unsafe.Pointer(providerC))
+	nameC := C.CString(name)
+	defer C.free(unsafe.Pointer(nameC))
+
+	linkC, errno := C.bpf_program__attach_usdt(prog.prog, C.int(pid), pathC, providerC, nameC, optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach usdt %s:%s of %s with pid %d to program %s: %w", provider, name, path, pid, prog.Name(), errno)
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      prog,
+		linkType:  USDT,
+		eventName: fmt.Sprintf("%s:%s:%s:%d", path, provider, name, pid),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachUSDT(prog, pid, path, provider, name, cookie)
+		},
+	}
+	prog.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
@@ -26,6 +26,13 @@ type BPFProg struct {
 }
 
 func (p *BPFProg) FileDescriptor() int {
+	if p.module.persistence != nil {
+		// restored programs are not loaded by libbpf
+		if fd, ok := p.module.persistence.progFDs[p.prog]; ok {
+			return fd
+		}
+	}
+
 	return int(C.bpf_program__fd(p.prog))
 }
 
@@ -120,12 +127,18 @@ func (p *BPFProg) AttachGeneric() (*BPFLink, error) {
 		return nil, fmt.Errorf("failed to attach program: %w", errno)
 	}
 
-	return &BPFLink{
+	bpfLink := &BPFLink{
 		link:      linkC,
 		prog:      p,
 		linkType:  Tracing,
 		eventName: fmt.Sprintf("tracing-%s", p.Name()),
-	}, nil
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachGeneric()
+		},
+	}
+	p.module.addLink(bpfLink)
+
+	return bpfLink, nil
 }
 
 // SetAttachTarget can be used to specify the program and/or function to attach
@@ -194,8 +207,11 @@ func (p *BPFProg) AttachCgroup(cgroupV2DirPath string) (*BPFLink, error) {
 		prog:      p,
 		linkType:  Cgroup,
 		eventName: fmt.Sprintf("cgroup-%s-%s", p.Name(), dirName),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachCgroup(cgroupV2DirPath)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -244,6 +260,9 @@ func (p *BPFProg) AttachCgroupLegacy(cgroupV2DirPath string, attachType BPFAttac
 		// info bellow needed for detach (there isn't a real ebpf link)
 		linkType: CgroupLegacy,
 		legacy:   bpfLinkLegacy,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachCgroupLegacy(cgroupV2DirPath, attachType)
+		},
 	}
 
 	return fakeBpfLink, nil
@@ -290,8 +309,11 @@ func (p *BPFProg) AttachXDP(deviceName string) (*BPFLink, error) {
 		prog:      p,
 		linkType:  XDP,
 		eventName: fmt.Sprintf("xdp-%s-%s", p.Name(), deviceName),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachXDP(deviceName)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -312,8 +334,49 @@ func (p *BPFProg) AttachTracepoint(category, name string) (*BPFLink, error) {
 		prog:      p,
 		linkType:  Tracepoint,
 		eventName: name,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachTracepoint(category, name)
+		},
+	}
+	p.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// AttachTracepointWithCookie attaches the program like AttachTracepoint,
+// with a cookie read by bpf_get_attach_cookie(), so that one program can tell
+// apart the tracepoints it is attached to.
+func (p *BPFProg) AttachTracepointWithCookie(category, name string, cookie uint64) (*BPFLink, error) {
+	if cookie == 0 {
+		return p.AttachTracepoint(category, name)
+	}
+
+	optsC, errno := C.cgo_bpf_tracepoint_opts_new(C.__u64(cookie))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create tracepoint opts: %w", errno)
+	}
+	defer C.cgo_bpf_tracepoint_opts_free(optsC)
+
+	tpCategoryC := C.CString(category)
+	defer C.free(unsafe.Pointer(tpCategoryC))
+	tpNameC := C.CString(name)
+	defer C.free(unsafe.Pointer(tpNameC))
+
+	linkC, errno := C.bpf_program__attach_tracepoint_opts(p.prog, tpCategoryC, tpNameC, optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach tracepoint %s to program %s: %w", name, p.Name(), errno)
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      p,
+		linkType:  Tracepoint,
+		eventName: name,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachTracepointWithCookie(category, name, cookie)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -332,8 +395,48 @@ func (p *BPFProg) AttachRawTracepoint(tpEvent string) (*BPFLink, error) {
 		prog:      p,
 		linkType:  RawTracepoint,
 		eventName: tpEvent,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachRawTracepoint(tpEvent)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// AttachRawTracepointWithCookie attaches the program like
+// AttachRawTracepoint, with a cookie read by bpf_get_attach_cookie(). Raw
+// tracepoint cookies need kernel 6.10 and libbpf 1.5 or later, it fails with
+// EOPNOTSUPP when built against an older libbpf.
+func (p *BPFProg) AttachRawTracepointWithCookie(tpEvent string, cookie uint64) (*BPFLink, error) {
+	if cookie == 0 {
+		return p.AttachRawTracepoint(tpEvent)
+	}
+
+	optsC, errno := C.cgo_bpf_raw_tracepoint_opts_new(C.__u64(cookie))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create raw tracepoint opts: %w", errno)
+	}
+	defer C.cgo_bpf_raw_tracepoint_opts_free(optsC)
+
+	tpEventC := C.CString(tpEvent)
+	defer C.free(unsafe.Pointer(tpEventC))
+
+	linkC, errno := C.cgo_bpf_program__attach_raw_tracepoint_opts(p.prog, tpEventC, optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach raw tracepoint %s to program %s: %w", tpEvent, p.Name(), errno)
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      p,
+		linkType:  RawTracepoint,
+		eventName: tpEvent,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachRawTracepointWithCookie(tpEvent, cookie)
+		},
+	}
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -348,8 +451,11 @@ func (p *BPFProg) AttachLSM() (*BPFLink, error) {
 		link:     linkC,
 		prog:     p,
 		linkType: LSM,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachLSM()
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -364,8 +470,43 @@ func (p *BPFProg) AttachPerfEvent(fd int) (*BPFLink, error) {
 		link:     linkC,
 		prog:     p,
 		linkType: PerfEvent,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachPerfEvent(fd)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// AttachPerfEventWithCookie attaches the program like AttachPerfEvent, with a
+// cookie read by bpf_get_attach_cookie(), so that one program can tell apart
+// the perf events it is attached to.
+func (p *BPFProg) AttachPerfEventWithCookie(fd int, cookie uint64) (*BPFLink, error) {
+	if cookie == 0 {
+		return p.AttachPerfEvent(fd)
+	}
+
+	optsC, errno := C.cgo_bpf_perf_event_opts_new(C.__u64(cookie))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create perf event opts: %w", errno)
+	}
+	defer C.cgo_bpf_perf_event_opts_free(optsC)
+
+	linkC, errno := C.bpf_program__attach_perf_event_opts(p.prog, C.int(fd), optsC)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach perf event to program %s: %w", p.Name(), errno)
+	}
+
+	bpfLink := &BPFLink{
+		link:     linkC,
+		prog:     p,
+		linkType: PerfEvent,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachPerfEventWithCookie(fd, cookie)
+		},
+	}
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -380,6 +521,19 @@ func (p *BPFProg) AttachKretprobe(kp string) (*BPFLink, error) {
 	return doAttachKprobe(p, kp, true)
 }
 
+// AttachKprobeWithCookie attaches the program like AttachKprobe, with a
+// cookie read by bpf_get_attach_cookie(), so that one program can tell apart
+// the functions it is attached to.
+func (p *BPFProg) AttachKprobeWithCookie(kp string, cookie uint64) (*BPFLink, error) {
+	return doAttachKprobeOpts(p, kp, false, cookie)
+}
+
+// AttachKretprobeWithCookie attaches the program like AttachKretprobe, with a
+// cookie read by bpf_get_attach_cookie().
+func (p *BPFProg) AttachKretprobeWithCookie(kp string, cookie uint64) (*BPFLink, error) {
+	return doAttachKprobeOpts(p, kp, true, cookie)
+}
+
 func doAttachKprobe(prog *BPFProg, kp string, isKretprobe bool) (*BPFLink, error) {
 	kpC := C.CString(kp)
 	defer C.free(unsafe.Pointer(kpC))
@@ -399,8 +553,11 @@ func doAttachKprobe(prog *BPFProg, kp string, isKretprobe bool) (*BPFLink, error
 		prog:      prog,
 		linkType:  kpType,
 		eventName: kp,
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachKprobe(prog, kp, isKretprobe)
+		},
 	}
-	prog.module.links = append(prog.module.links, bpfLink)
+	prog.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -428,8 +585,11 @@ func (p *BPFProg) AttachNetns(networkNamespacePath string) (*BPFLink, error) {
 		prog:      p,
 		linkType:  Netns,
 		eventName: fmt.Sprintf("netns-%s-%s", p.Name(), fileName),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachNetns(networkNamespacePath)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -469,8 +629,11 @@ func (p *BPFProg) AttachIter(opts IterOpts) (*BPFLink, error) {
 		prog:      p,
 		linkType:  Iter,
 		eventName: fmt.Sprintf("iter-%s-%d", p.Name(), opts.MapFd),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return prog.AttachIter(opts)
+		},
 	}
-	p.module.links = append(p.module.links, bpfLink)
+	p.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -524,7 +687,78 @@ func doAttachUprobe(prog *BPFProg, isUretprobe bool, pid int, path string, offse
 		prog:      prog,
 		linkType:  upType,
 		eventName: fmt.Sprintf("%s:%d:%d", path, pid, offset),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachUprobe(prog, isUretprobe, pid, path, offset)
+		},
+	}
+	prog.module.addLink(bpfLink)
+
+	return bpfLink, nil
+}
+
+// AttachUprobeWithCookie attaches the program like AttachUprobe, with a
+// cookie read by bpf_get_attach_cookie(), so that one program can tell apart
+// the symbols it is attached to.
+func (p *BPFProg) AttachUprobeWithCookie(pid int, path string, offset uint32, cookie uint64) (*BPFLink, error) {
+	absPath, err := filepath.Abs(path)
+	if err != nil {
+		return nil, err
+	}
+
+	return doAttachUprobeOpts(p, false, pid, absPath, offset, cookie)
+}
+
+// AttachURetprobeWithCookie attaches the program like AttachURetprobe, with a
+// cookie read by bpf_get_attach_cookie().
+func (p *BPFProg) AttachURetprobeWithCookie(pid int, path string, offset uint32, cookie uint64) (*BPFLink, error) {
+	absPath, err := filepath.Abs(path)
+	if err != nil {
+		return nil, err
+	}
+
+	return doAttachUprobeOpts(p, true, pid, absPath, offset, cookie)
+}
+
+func doAttachUprobeOpts(prog *BPFProg, isUretprobe bool, pid int, path string, offset uint32, cookie uint64) (*BPFLink, error) {
+	if cookie == 0 {
+		return doAttachUprobe(prog, isUretprobe, pid, path, offset)
+	}
+
+	optsC, errno := C.cgo_bpf_uprobe_opts_new(nil, C.__u64(cookie), C.bool(isUretprobe))
+	if optsC == nil {
+		return nil, fmt.Errorf("failed to create uprobe opts: %w", errno)
+	}
+	defer C.cgo_bpf_uprobe_opts_free(optsC)
+
+	pathC := C.CString(path)
+	defer C.free(unsafe.Pointer(pathC))
+
+	linkC, errno := C.bpf_program__attach_uprobe_opts(
+		prog.prog,
+		C.int(pid),
+		pathC,
+		C.size_t(offset),
+		optsC,
+	)
+	if linkC == nil {
+		return nil, fmt.Errorf("failed to attach u(ret)probe %s:%d with pid %d to program %s: %w", path, offset, pid, prog.Name(), errno)
+	}
+
+	upType := Uprobe
+	if isUretprobe {
+		upType = Uretprobe
+	}
+
+	bpfLink := &BPFLink{
+		link:      linkC,
+		prog:      prog,
+		linkType:  upType,
+		eventName: fmt.Sprintf("%s:%d:%d", path, pid, offset),
+		reattach: func(prog *BPFProg) (*BPFLink, error) {
+			return doAttachUprobeOpts(prog, isUretprobe, pid, path, offset, cookie)
+		},
 	}
+	prog.module.addLink(bpfLink)
 
 	return bpfLink, nil
 }
@@ -0,0 +1,24 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+__u64 kprobe_hits = 0;
+__u64 tracepoint_hits = 0;
+
+SEC("kprobe")
+int kprobe_counter(void *ctx)
+{
+    __sync_fetch_and_add(&kprobe_hits, 1);
+    return 0;
+}
+
+SEC("tracepoint")
+int tracepoint_counter(void *ctx)
+{
+    __sync_fetch_and_add(&tracepoint_hits, 1);
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,79 @@
+package main
+
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+var syscalls = []string{"read", "write", "openat", "close", "mmap", "munmap", "getpid", "getppid"}
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func ksymArch() string {
+	switch runtime.GOARCH {
+	case "amd64":
+		return "x64"
+	case "arm64":
+		return "arm64"
+	default:
+		panic("unsupported architecture")
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	kprobeProg, err := bpfModule.GetProgram("kprobe_counter")
+	exitOnErr(err)
+	tracepointProg, err := bpfModule.GetProgram("tracepoint_counter")
+	exitOnErr(err)
+
+	var specs []bpf.AttachSpec
+	for _, name := range syscalls {
+		specs = append(specs,
+			bpf.AttachSpec{Prog: kprobeProg, Type: bpf.Kprobe, Target: fmt.Sprintf("__%s_sys_%s", ksymArch(), name)},
+			bpf.AttachSpec{Prog: tracepointProg, Type: bpf.Tracepoint, Target: "syscalls:sys_enter_" + name},
+		)
+	}
+
+	results, err := bpfModule.AttachAll(specs, 4)
+	exitOnErr(err)
+	for i, result := range results {
+		if result.Link == nil || result.Link.FileDescriptor() < 0 {
+			fmt.Fprintf(os.Stderr, "spec %d (%s) has no link\n", i, specs[i].Target)
+			os.Exit(-1)
+		}
+		fmt.Printf("%s: %v\n", specs[i].Target, result.Latency)
+	}
+
+	// a failed spec must roll back the whole batch
+	badSpecs := []bpf.AttachSpec{
+		{Prog: kprobeProg, Type: bpf.Kprobe, Target: fmt.Sprintf("__%s_sys_getuid", ksymArch())},
+		{Prog: kprobeProg, Type: bpf.Kprobe, Target: "libbpfgo_no_such_symbol"},
+	}
+	results, err = bpfModule.AttachAll(badSpecs, 2)
+	if err == nil {
+		fmt.Fprintln(os.Stderr, "attaching to a missing symbol succeeded")
+		os.Exit(-1)
+	}
+	for i, result := range results {
+		if result.Link != nil {
+			fmt.Fprintf(os.Stderr, "spec %d was not rolled back\n", i)
+			os.Exit(-1)
+		}
+	}
+}
@@ -0,0 +1,38 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 4);
+    __type(key, __u32);
+    __type(value, __u64);
+} hits_by_cookie SEC(".maps");
+
+static __always_inline void count(void *ctx)
+{
+    __u32 key = bpf_get_attach_cookie(ctx);
+    __u64 *hits;
+
+    hits = bpf_map_lookup_elem(&hits_by_cookie, &key);
+    if (hits)
+        __sync_fetch_and_add(hits, 1);
+}
+
+SEC("tracepoint")
+int tracepoint_by_cookie(void *ctx)
+{
+    count(ctx);
+    return 0;
+}
+
+SEC("kprobe")
+int kprobe_by_cookie(void *ctx)
+{
+    count(ctx);
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,71 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"runtime"
+	"syscall"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	// one program per attach type, told apart by cookies
+	tpProg, err := bpfModule.GetProgram("tracepoint_by_cookie")
+	exitOnErr(err)
+	_, err = tpProg.AttachTracepointWithCookie("syscalls", "sys_enter_getpid", 0)
+	exitOnErr(err)
+	_, err = tpProg.AttachTracepointWithCookie("syscalls", "sys_enter_getppid", 1)
+	exitOnErr(err)
+
+	kpProg, err := bpfModule.GetProgram("kprobe_by_cookie")
+	exitOnErr(err)
+	_, err = kpProg.AttachKprobeWithCookie(fmt.Sprintf("__%s_sys_getpid", ksymArch()), 2)
+	exitOnErr(err)
+	_, err = kpProg.AttachKprobeWithCookie(fmt.Sprintf("__%s_sys_getppid", ksymArch()), 3)
+	exitOnErr(err)
+
+	for i := 0; i < 10; i++ {
+		syscall.Getpid()
+		syscall.Getppid()
+	}
+
+	hitsMap, err := bpfModule.GetMap("hits_by_cookie")
+	exitOnErr(err)
+	for cookie := uint32(0); cookie < 4; cookie++ {
+		value, err := hitsMap.GetValue(unsafe.Pointer(&cookie))
+		exitOnErr(err)
+		// other processes can make the syscalls too
+		if hits := binary.LittleEndian.Uint64(value); hits < 10 {
+			exitOnErr(fmt.Errorf("cookie %d: %d hits, expected at least 10", cookie, hits))
+		}
+	}
+}
+
+func ksymArch() string {
+	switch runtime.GOARCH {
+	case "amd64":
+		return "x64"
+	case "arm64":
+		return "arm64"
+	default:
+		panic("unsupported architecture")
+	}
+}
@@ -0,0 +1,33 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+__u64 fentry_hits = 0;
+__u64 kprobe_hits = 0;
+
+// the attach targets are set by the function tracer
+
+SEC("fentry")
+int fentry_slot_0(void *ctx)
+{
+    __sync_fetch_and_add(&fentry_hits, 1);
+    return 0;
+}
+
+SEC("fentry")
+int fentry_slot_1(void *ctx)
+{
+    __sync_fetch_and_add(&fentry_hits, 1);
+    return 0;
+}
+
+SEC("kprobe.multi")
+int kprobe_any(void *ctx)
+{
+    __sync_fetch_and_add(&kprobe_hits, 1);
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,92 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"runtime"
+	"syscall"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func ksymArch() string {
+	switch runtime.GOARCH {
+	case "amd64":
+		return "x64"
+	case "arm64":
+		return "arm64"
+	default:
+		panic("unsupported architecture")
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	arch := ksymArch()
+	functions := []string{
+		fmt.Sprintf("__%s_sys_getpid", arch),
+		fmt.Sprintf("__%s_sys_getppid", arch),
+		fmt.Sprintf("__%s_sys_getuid", arch),
+	}
+
+	tracer, err := bpfModule.NewFunctionTracer(bpf.FunctionTracerOpts{
+		Functions:   functions,
+		FentryProgs: []string{"fentry_slot_0", "fentry_slot_1"},
+		KprobeProg:  "kprobe_any",
+	})
+	exitOnErr(err)
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	attachments, err := tracer.Attach()
+	exitOnErr(err)
+	if len(attachments) != len(functions) {
+		exitOnErr(fmt.Errorf("expected %d attachments, got %d", len(functions), len(attachments)))
+	}
+
+	var fentries, kprobes uint64
+	for i, a := range attachments {
+		if a.Function != functions[i] {
+			exitOnErr(fmt.Errorf("attachment %d is for %s, expected %s", i, a.Function, functions[i]))
+		}
+		fmt.Printf("%s: %s\n", a.Function, a.Mechanism)
+		if a.Mechanism == bpf.FunctionAttachFentry {
+			fentries++
+		} else {
+			kprobes++
+		}
+	}
+	// there are only two fentry programs
+	if kprobes == 0 {
+		exitOnErr(fmt.Errorf("expected %s through kprobes", functions[2]))
+	}
+
+	syscall.Getpid()
+	syscall.Getppid()
+	syscall.Getuid()
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	fentryHits := binary.LittleEndian.Uint64(value[0:8])
+	kprobeHits := binary.LittleEndian.Uint64(value[8:16])
+	if fentryHits < fentries || kprobeHits < kprobes {
+		exitOnErr(fmt.Errorf("got %d fentry and %d kprobe hits, expected at least %d and %d", fentryHits, kprobeHits, fentries, kprobes))
+	}
+}
@@ -0,0 +1,36 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 2);
+    __type(key, __u32);
+    __type(value, __u64);
+} hits_by_cookie SEC(".maps");
+
+__u64 pattern_hits = 0;
+
+SEC("kprobe.multi")
+int count_by_cookie(void *ctx)
+{
+    __u32 key = bpf_get_attach_cookie(ctx);
+    __u64 *hits;
+
+    hits = bpf_map_lookup_elem(&hits_by_cookie, &key);
+    if (hits)
+        __sync_fetch_and_add(hits, 1);
+
+    return 0;
+}
+
+SEC("kprobe.multi")
+int count_pattern(void *ctx)
+{
+    __sync_fetch_and_add(&pattern_hits, 1);
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,96 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"runtime"
+	"syscall"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func ksymArch() string {
+	switch runtime.GOARCH {
+	case "amd64":
+		return "x64"
+	case "arm64":
+		return "arm64"
+	default:
+		panic("unsupported architecture")
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	arch := ksymArch()
+	cookieProg, err := bpfModule.GetProgram("count_by_cookie")
+	exitOnErr(err)
+	_, err = cookieProg.AttachKprobeMulti(bpf.KprobeMultiOpts{
+		Symbols: []string{
+			fmt.Sprintf("__%s_sys_getpid", arch),
+			fmt.Sprintf("__%s_sys_getppid", arch),
+		},
+		Cookies: []uint64{0, 1},
+	})
+	exitOnErr(err)
+
+	patternProg, err := bpfModule.GetProgram("count_pattern")
+	exitOnErr(err)
+	links, err := patternProg.AttachKprobeMulti(bpf.KprobeMultiOpts{
+		Pattern: fmt.Sprintf("__%s_sys_getp*id", arch),
+	})
+	exitOnErr(err)
+	fmt.Printf("pattern attached through %d link(s)\n", len(links))
+	supported, err := bpf.NewProbeCache(bpf.NewProbeCacheArgs{}).KprobeMultiIsSupported()
+	exitOnErr(err)
+	if supported && len(links) != 1 {
+		exitOnErr(fmt.Errorf("kprobe multi is supported, but the pattern attached through %d links", len(links)))
+	}
+
+	// errors other than a missing kprobe multi support don't fall back
+	if _, err := patternProg.AttachKprobeMulti(bpf.KprobeMultiOpts{
+		Symbols: []string{"libbpfgo_no_such_function"},
+	}); err == nil {
+		exitOnErr(fmt.Errorf("expected attaching to a missing function to fail"))
+	}
+
+	for i := 0; i < 10; i++ {
+		syscall.Getpid()
+		syscall.Getppid()
+	}
+
+	hitsMap, err := bpfModule.GetMap("hits_by_cookie")
+	exitOnErr(err)
+	for cookie := uint32(0); cookie < 2; cookie++ {
+		value, err := hitsMap.GetValue(unsafe.Pointer(&cookie))
+		exitOnErr(err)
+		if hits := binary.LittleEndian.Uint64(value); hits < 10 {
+			exitOnErr(fmt.Errorf("cookie %d: %d hits, expected at least 10", cookie, hits))
+		}
+	}
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	if hits := binary.LittleEndian.Uint64(value); hits < 20 {
+		exitOnErr(fmt.Errorf("pattern: %d hits, expected at least 20", hits))
+	}
+}
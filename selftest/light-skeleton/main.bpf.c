@@ -0,0 +1,21 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+const volatile __u32 target_tgid = 0;
+__u64 counter = 0;
+
+SEC("raw_tp/sys_enter")
+int count_sys_enter(void *ctx)
+{
+    if ((bpf_get_current_pid_tgid() >> 32) != target_tgid)
+        return 0;
+
+    __sync_fetch_and_add(&counter, 1);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
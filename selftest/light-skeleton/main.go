@@ -0,0 +1,91 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"syscall"
+	"time"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+const iterations = 20
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func generateBlob() []byte {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	blob, err := bpfModule.GenerateLoaderBlob()
+	exitOnErr(err)
+
+	return blob
+}
+
+// benchmark compares the startup time of the regular and loader blob paths.
+func benchmark(blob []byte) {
+	start := time.Now()
+	for i := 0; i < iterations; i++ {
+		bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+		exitOnErr(err)
+		exitOnErr(bpfModule.BPFLoadObject())
+		bpfModule.Close()
+	}
+	regular := time.Since(start) / iterations
+
+	start = time.Now()
+	for i := 0; i < iterations; i++ {
+		lightModule, err := bpf.NewModuleFromLoaderBlob(blob)
+		exitOnErr(err)
+		lightModule.Close()
+	}
+	light := time.Since(start) / iterations
+
+	fmt.Printf("load time: regular %v, loader blob %v\n", regular, light)
+}
+
+func main() {
+	blob := generateBlob()
+	benchmark(blob)
+
+	rodata := make([]byte, 4)
+	binary.LittleEndian.PutUint32(rodata, uint32(os.Getpid()))
+
+	lightModule, err := bpf.NewModuleFromLoaderBlobArgs(bpf.NewLightModuleArgs{
+		LoaderBlob:    blob,
+		InitialValues: map[string][]byte{".rodata": rodata},
+	})
+	exitOnErr(err)
+	defer lightModule.Close()
+
+	prog, err := lightModule.GetProgram("count_sys_enter")
+	exitOnErr(err)
+	_, err = prog.Attach()
+	exitOnErr(err)
+
+	for i := 0; i < 10; i++ {
+		syscall.Getppid()
+	}
+
+	bss, err := lightModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+
+	if counter := binary.LittleEndian.Uint64(value); counter < 10 {
+		fmt.Fprintf(os.Stderr, "expected at least 10 syscalls, counted %d\n", counter)
+		os.Exit(-1)
+	}
+}
@@ -0,0 +1,51 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+struct {
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 1 << 24);
+} events SEC(".maps");
+long ringbuffer_flags = 0;
+
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, __u32);
+    __type(value, __u64);
+} uprobe_hits SEC(".maps");
+
+SEC("xdp")
+int target(struct xdp_md *ctx)
+{
+    int *process;
+
+    // Reserve space on the ringbuffer for the sample
+    process = bpf_ringbuf_reserve(&events, sizeof(int), ringbuffer_flags);
+    if (!process) {
+        return XDP_PASS;
+    }
+
+    *process = 2021;
+
+    bpf_ringbuf_submit(process, ringbuffer_flags);
+    return XDP_PASS;
+}
+
+SEC("uprobe")
+int count_uprobe(struct pt_regs *ctx)
+{
+    __u32 key = 0;
+    __u64 *hits;
+
+    hits = bpf_map_lookup_elem(&uprobe_hits, &key);
+    if (hits)
+        __sync_fetch_and_add(hits, 1);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,160 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"os/exec"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+	"github.com/khulnasoft-lab/libbpfgo/helpers"
+)
+
+const (
+	deviceName = "lo"
+)
+
+func loadModule() *bpf.Module {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	err = bpfModule.BPFLoadObject()
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	return bpfModule
+}
+
+//go:noinline
+func uprobeTarget() {
+}
+
+// attachUprobe attaches the uprobe program to uprobeTarget.
+func attachUprobe(bpfModule *bpf.Module) *bpf.BPFLink {
+	prog, err := bpfModule.GetProgram("count_uprobe")
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+	exe, err := os.Executable()
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+	offset, err := helpers.SymbolToOffset(exe, "main.uprobeTarget")
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+	link, err := prog.AttachUprobe(-1, exe, offset)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	return link
+}
+
+func uprobeHits(bpfModule *bpf.Module) uint64 {
+	hitsMap, err := bpfModule.GetMap("uprobe_hits")
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+	key := uint32(0)
+	value, err := hitsMap.GetValue(unsafe.Pointer(&key))
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	return binary.LittleEndian.Uint64(value)
+}
+
+func main() {
+	oldModule := loadModule()
+	uprobeLink := attachUprobe(oldModule)
+
+	xdpProg, err := oldModule.GetProgram("target")
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	xdpLink, err := xdpProg.AttachXDP(deviceName)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	newModule := loadModule()
+	defer newModule.Close()
+
+	// swap the xdp link to the new module program and get rid of the old
+	// module: the new program must keep receiving the traffic
+	err = newModule.UpgradeLinks(oldModule)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+	oldModule.Close()
+
+	// the handle follows the link to the new module
+	if xdpLink.FileDescriptor() < 0 {
+		fmt.Fprintln(os.Stderr, "upgraded link handle was destroyed with the old module")
+		os.Exit(-1)
+	}
+
+	// uprobe links, which can't be updated, are reattached to the new program
+	if uprobeLink.FileDescriptor() < 0 {
+		fmt.Fprintln(os.Stderr, "upgraded uprobe link handle was destroyed with the old module")
+		os.Exit(-1)
+	}
+	uprobeTarget()
+	if hits := uprobeHits(newModule); hits == 0 {
+		fmt.Fprintln(os.Stderr, "upgraded uprobe didn't run the new program")
+		os.Exit(-1)
+	}
+
+	eventsChannel := make(chan []byte)
+	rb, err := newModule.InitRingBuf("events", eventsChannel)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+
+	rb.Poll(300)
+	numberOfEventsReceived := 0
+	go func() {
+		_, err := exec.Command("ping", "localhost", "-c 10").Output()
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(-1)
+		}
+	}()
+
+recvLoop:
+
+	for {
+		b := <-eventsChannel
+		if binary.LittleEndian.Uint32(b) != 2021 {
+			fmt.Fprintf(os.Stderr, "invalid data retrieved\n")
+			os.Exit(-1)
+		}
+		numberOfEventsReceived++
+		if numberOfEventsReceived > 5 {
+			break recvLoop
+		}
+	}
+
+	rb.Stop()
+	rb.Close()
+}
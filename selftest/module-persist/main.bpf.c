@@ -0,0 +1,32 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, __u32);
+    __type(value, __u64);
+} counter SEC(".maps");
+
+const volatile __u32 target_tgid = 0;
+
+SEC("raw_tp/sys_enter")
+int count_sys_enter(void *ctx)
+{
+    __u32 key = 0;
+    __u64 *value;
+
+    if ((bpf_get_current_pid_tgid() >> 32) != target_tgid)
+        return 0;
+
+    value = bpf_map_lookup_elem(&counter, &key);
+    if (value)
+        __sync_fetch_and_add(value, 1);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
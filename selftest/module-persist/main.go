@@ -0,0 +1,120 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"syscall"
+	"time"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+const pinDir = "/sys/fs/bpf/libbpfgo-module-persist"
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+// start simulates a process start: the first one loads, attaches and persists
+// the object, the following ones restore it.
+func start(tgid uint32) (*bpf.Module, bool) {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	exitOnErr(bpfModule.InitGlobalVariable("target_tgid", tgid))
+
+	begin := time.Now()
+	restored, err := bpfModule.BPFLoadObjectPersistent(pinDir)
+	exitOnErr(err)
+	fmt.Printf("restored=%t in %v\n", restored, time.Since(begin))
+
+	if !restored {
+		prog, err := bpfModule.GetProgram("count_sys_enter")
+		exitOnErr(err)
+		_, err = prog.AttachRawTracepoint("sys_enter")
+		exitOnErr(err)
+	}
+	exitOnErr(bpfModule.Persist())
+
+	return bpfModule, restored
+}
+
+func count(bpfModule *bpf.Module) uint64 {
+	counter, err := bpfModule.GetMap("counter")
+	exitOnErr(err)
+
+	key := uint32(0)
+	value, err := counter.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+
+	return binary.LittleEndian.Uint64(value)
+}
+
+func main() {
+	_ = os.RemoveAll(pinDir)
+	tgid := uint32(os.Getpid())
+
+	first, restored := start(tgid)
+	if restored {
+		fmt.Fprintln(os.Stderr, "first start restored the object")
+		os.Exit(-1)
+	}
+	first.Close()
+
+	// the program must keep running while no module is open
+	for i := 0; i < 10; i++ {
+		syscall.Getppid()
+	}
+
+	second, restored := start(tgid)
+	if !restored {
+		fmt.Fprintln(os.Stderr, "restart didn't restore the object")
+		os.Exit(-1)
+	}
+	if n := count(second); n < 10 {
+		fmt.Fprintf(os.Stderr, "expected at least 10 syscalls counted across restart, got %d\n", n)
+		os.Exit(-1)
+	}
+	second.Close()
+
+	// incomplete pins must fall back to a fresh load
+	exitOnErr(os.RemoveAll(pinDir + "/links"))
+	fallback, restored := start(tgid)
+	if restored {
+		fmt.Fprintln(os.Stderr, "object with missing link pins was restored")
+		os.Exit(-1)
+	}
+	fallback.Close()
+
+	// a different configuration must not reuse the pins
+	third, restored := start(tgid + 1)
+	if restored {
+		fmt.Fprintln(os.Stderr, "object with a different configuration was restored")
+		os.Exit(-1)
+	}
+	exitOnErr(third.Unpersist())
+	third.Close()
+
+	// a directory that isn't empty and has no manifest is refused
+	exitOnErr(os.Mkdir(pinDir+"/other", 0700))
+	defer os.RemoveAll(pinDir)
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+	_, err = bpfModule.BPFLoadObjectPersistent(pinDir)
+	exitOnErr(err)
+	if err := bpfModule.Persist(); err == nil {
+		fmt.Fprintln(os.Stderr, "persisted to a directory with foreign entries")
+		os.Exit(-1)
+	}
+	if _, err := os.Stat(pinDir + "/other"); err != nil {
+		fmt.Fprintln(os.Stderr, "foreign entry was removed")
+		os.Exit(-1)
+	}
+}
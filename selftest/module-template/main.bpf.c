@@ -0,0 +1,32 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+const volatile __u32 tenant_id = 0;
+
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, 1);
+    __type(key, __u32);
+    __type(value, __u64);
+} tenant_events SEC(".maps");
+
+SEC("raw_tp/sys_enter")
+int count_events(void *ctx)
+{
+    __u32 key = tenant_id;
+    __u64 one = 1, *count;
+
+    count = bpf_map_lookup_elem(&tenant_events, &key);
+    if (count) {
+        __sync_fetch_and_add(count, 1);
+        return 0;
+    }
+    bpf_map_update_elem(&tenant_events, &key, &one, BPF_NOEXIST);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,53 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	template, err := bpf.NewModuleTemplate(bpf.NewModuleArgs{BPFObjPath: "main.bpf.o"})
+	exitOnErr(err)
+
+	for tenant := uint32(1); tenant <= 3; tenant++ {
+		bpfModule, err := template.NewModule(bpf.ModuleInstanceArgs{
+			GlobalVariables: map[string]interface{}{"tenant_id": tenant},
+			MaxEntries:      map[string]uint32{"tenant_events": 16 * tenant},
+		})
+		exitOnErr(err)
+
+		exitOnErr(bpfModule.BPFLoadObject())
+
+		rodata, err := bpfModule.GetMap(".rodata")
+		exitOnErr(err)
+		key := uint32(0)
+		value, err := rodata.GetValue(unsafe.Pointer(&key))
+		exitOnErr(err)
+		if got := binary.LittleEndian.Uint32(value); got != tenant {
+			exitOnErr(fmt.Errorf("tenant %d: tenant_id is %d", tenant, got))
+		}
+
+		events, err := bpfModule.GetMap("tenant_events")
+		exitOnErr(err)
+		info, err := bpf.GetMapInfoByFD(events.FileDescriptor())
+		exitOnErr(err)
+		if info.MaxEntries != 16*tenant {
+			exitOnErr(fmt.Errorf("tenant %d: tenant_events max entries is %d", tenant, info.MaxEntries))
+		}
+
+		bpfModule.Close()
+	}
+}
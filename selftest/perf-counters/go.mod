@@ -0,0 +1,7 @@
+module github.com/khulnasoft-lab/libbpfgo/selftest/perf-counters
+
+go 1.18
+
+require github.com/khulnasoft-lab/libbpfgo v0.4.7-libbpf-1.2.0-b2e29a1
+
+replace github.com/khulnasoft-lab/libbpfgo => ../../
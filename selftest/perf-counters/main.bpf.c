@@ -0,0 +1,30 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+struct {
+    __uint(type, BPF_MAP_TYPE_PERF_EVENT_ARRAY);
+    __uint(key_size, sizeof(__u32));
+    __uint(value_size, sizeof(__u32));
+} cpu_clock SEC(".maps");
+
+__u64 counter = 0;
+__u64 enabled = 0;
+
+SEC("tracepoint/syscalls/sys_enter_getpid")
+int read_counters(void *ctx)
+{
+    struct bpf_perf_event_value value = {};
+
+    if (bpf_perf_event_read_value(&cpu_clock, BPF_F_CURRENT_CPU, &value, sizeof(value)))
+        return 0;
+
+    counter = value.counter;
+    enabled = value.enabled;
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
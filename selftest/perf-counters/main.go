@@ -0,0 +1,60 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"syscall"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	// a software counter, since virtual machines lack hardware ones
+	counters, err := bpfModule.NewPerfCounters([]bpf.PerfCounter{
+		{Map: "cpu_clock", Event: bpf.PerfCounterCPUClock},
+	})
+	exitOnErr(err)
+	nCPU, err := bpf.NumPossibleCPUs()
+	exitOnErr(err)
+	if counters.CPUs() == 0 || counters.CPUs() > nCPU {
+		exitOnErr(fmt.Errorf("counters open on %d cpus", counters.CPUs()))
+	}
+	exitOnErr(counters.Refresh())
+
+	prog, err := bpfModule.GetProgram("read_counters")
+	exitOnErr(err)
+	_, err = prog.AttachTracepoint("syscalls", "sys_enter_getpid")
+	exitOnErr(err)
+
+	for i := 0; i < 10; i++ {
+		syscall.Getpid()
+	}
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	counter := binary.LittleEndian.Uint64(value[0:])
+	enabled := binary.LittleEndian.Uint64(value[8:])
+	if counter == 0 || enabled == 0 {
+		exitOnErr(fmt.Errorf("counter %d enabled for %d ns, expected both set", counter, enabled))
+	}
+}
@@ -6,6 +6,7 @@ import (
 	"fmt"
 	"log"
 	"os"
+	"path/filepath"
 
 	bpf "github.com/khulnasoft-lab/libbpfgo"
 )
@@ -62,4 +63,43 @@ func main() {
 			log.Fatal(err)
 		}
 	}
+
+	// the probe cache must agree with the live probes, both when probing and
+	// when reading the persisted results back
+	cachePath := filepath.Join(os.TempDir(), "libbpfgo-probe-features.json")
+	defer os.Remove(cachePath)
+
+	for i := 0; i < 2; i++ {
+		cache := bpf.NewProbeCache(bpf.NewProbeCacheArgs{
+			CachePath: cachePath,
+			Helpers: map[bpf.BPFProgType][]bpf.BPFFunc{
+				bpf.BPFProgTypeKprobe: {bpf.BPFFuncTracePrintk},
+			},
+		})
+
+		cached, err := cache.MapTypeIsSupported(bpf.MapTypeHash)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(-1)
+		}
+		if cached != isSupported {
+			fmt.Fprintln(os.Stderr, "probe cache disagrees with live map type probe")
+			os.Exit(-1)
+		}
+
+		live, err := bpf.BPFHelperIsSupported(bpf.BPFProgTypeKprobe, bpf.BPFFuncTracePrintk)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(-1)
+		}
+		cached, err = cache.HelperIsSupported(bpf.BPFProgTypeKprobe, bpf.BPFFuncTracePrintk)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			os.Exit(-1)
+		}
+		if cached != live {
+			fmt.Fprintln(os.Stderr, "probe cache disagrees with live helper probe")
+			os.Exit(-1)
+		}
+	}
 }
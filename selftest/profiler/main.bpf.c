@@ -0,0 +1,46 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+struct profile_key {
+    __u32 pid;
+    __s32 user_stack_id;
+    __s32 kernel_stack_id;
+};
+
+struct {
+    __uint(type, BPF_MAP_TYPE_STACK_TRACE);
+    __uint(max_entries, 16384);
+    __type(key, __u32);
+    __uint(value_size, 127 * sizeof(__u64));
+} stacks SEC(".maps");
+
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, 16384);
+    __type(key, struct profile_key);
+    __type(value, __u64);
+} counts SEC(".maps");
+
+SEC("perf_event")
+int profile(struct bpf_perf_event_data *ctx)
+{
+    struct profile_key key = {};
+    __u64 one = 1, *count;
+
+    key.pid = bpf_get_current_pid_tgid() >> 32;
+    key.user_stack_id = bpf_get_stackid(ctx, &stacks, BPF_F_USER_STACK);
+    key.kernel_stack_id = bpf_get_stackid(ctx, &stacks, 0);
+
+    count = bpf_map_lookup_elem(&counts, &key);
+    if (count)
+        __sync_fetch_and_add(count, 1);
+    else
+        bpf_map_update_elem(&counts, &key, &one, BPF_NOEXIST);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,75 @@
+package main
+
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"time"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	profiler, err := bpfModule.NewProfiler(bpf.ProfilerOpts{
+		Prog:      "profile",
+		CountsMap: "counts",
+		StacksMap: "stacks",
+		Event:     bpf.ProfilerEventCPUClock,
+		Frequency: 99,
+	})
+	exitOnErr(err)
+	defer profiler.Close()
+
+	// burn some CPU to be sampled
+	deadline := time.Now().Add(time.Second)
+	x := 0
+	for time.Now().Before(deadline) {
+		x++
+	}
+
+	samples, err := profiler.Drain()
+	exitOnErr(err)
+	total, own := uint64(0), uint64(0)
+	for _, s := range samples {
+		total += s.Count
+		if s.Pid == uint32(os.Getpid()) {
+			own += s.Count
+		}
+	}
+	if own == 0 {
+		exitOnErr(fmt.Errorf("no sample of the busy process in %d samples", total))
+	}
+
+	// drained counts are reset
+	samples, err = profiler.Drain()
+	exitOnErr(err)
+	for _, s := range samples {
+		if s.Count > 10 {
+			exitOnErr(fmt.Errorf("counts were not reset: %+v", s))
+		}
+	}
+
+	// periodic draining, until stopped
+	ch := make(chan []bpf.ProfileSample)
+	exitOnErr(profiler.Start(100*time.Millisecond, ch))
+	<-ch
+	profiler.Stop()
+	if _, ok := <-ch; ok {
+		exitOnErr(fmt.Errorf("expected the channel to be closed by Stop"))
+	}
+	exitOnErr(profiler.Err())
+}
@@ -0,0 +1,22 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+__u64 calls = 0;
+
+static __noinline int count(void)
+{
+    __sync_fetch_and_add(&calls, 1);
+
+    return 0;
+}
+
+SEC("tracepoint/syscalls/sys_enter_getpid")
+int getpid_enter(void *ctx)
+{
+    return count();
+}
+
+char LICENSE[] SEC("license") = "GPL";
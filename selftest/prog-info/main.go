@@ -0,0 +1,68 @@
+package main
+
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"strings"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	prog, err := bpfModule.GetProgram("getpid_enter")
+	exitOnErr(err)
+
+	info, err := prog.Info(bpf.BPFProgInfoOpts{
+		XlatedInsns: true,
+		JitedImage:  true,
+		FuncInfo:    true,
+		LineInfo:    true,
+	})
+	exitOnErr(err)
+
+	if info.Type != bpf.BPFProgTypeTracepoint || !strings.HasPrefix("getpid_enter", info.Name) {
+		exitOnErr(fmt.Errorf("unexpected program %s of type %s", info.Name, info.Type))
+	}
+	if len(info.Tag) != 16 || !info.GPLCompatible || len(info.MapIDs) != 1 {
+		exitOnErr(fmt.Errorf("unexpected program info %+v", info))
+	}
+	if len(info.XlatedInsns) != int(info.XlatedProgLen) || len(info.XlatedInsns) == 0 {
+		exitOnErr(fmt.Errorf("xlated dump of %d bytes, expected %d", len(info.XlatedInsns), info.XlatedProgLen))
+	}
+	if len(info.FuncInfo) != 2 || info.FuncInfo[0].Name != "getpid_enter" || info.FuncInfo[1].Name != "count" {
+		exitOnErr(fmt.Errorf("unexpected func info %+v", info.FuncInfo))
+	}
+	if len(info.LineInfo) == 0 {
+		exitOnErr(fmt.Errorf("no line info"))
+	}
+	line, ok := info.LineAtInsn(0)
+	if !ok || !strings.HasSuffix(line.FileName, "main.bpf.c") {
+		exitOnErr(fmt.Errorf("unexpected line info %+v", line))
+	}
+
+	// the JIT may be disabled, or its addresses hidden
+	if len(info.JitedImage) == 0 || len(info.JitedKsyms) == 0 || info.JitedKsyms[0] == 0 {
+		return
+	}
+	if len(info.JitedImage) != int(info.JitedProgLen) || len(info.JitedKsyms) != 2 {
+		exitOnErr(fmt.Errorf("jited dump of %d bytes in %d functions", len(info.JitedImage), len(info.JitedKsyms)))
+	}
+	if line, ok := info.LineAt(info.JitedKsyms[1]); !ok || line.LineNum == 0 {
+		exitOnErr(fmt.Errorf("no line at the jited address %#x", info.JitedKsyms[1]))
+	}
+}
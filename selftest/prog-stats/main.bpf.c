@@ -0,0 +1,16 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+__u64 calls = 0;
+
+SEC("raw_tp/sys_enter")
+int count_sys_enter(void *ctx)
+{
+    __sync_fetch_and_add(&calls, 1);
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,78 @@
+package main
+
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"syscall"
+	"time"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	prog, err := bpfModule.GetProgram("count_sys_enter")
+	exitOnErr(err)
+	_, err = prog.AttachRawTracepoint("sys_enter")
+	exitOnErr(err)
+
+	sampler, err := bpfModule.NewProgramStatsSampler()
+	exitOnErr(err)
+	defer sampler.Close()
+
+	ch := make(chan []bpf.ProgramStatsInterval)
+	err = sampler.Start(200*time.Millisecond, ch)
+	exitOnErr(err)
+	if err := sampler.Start(200*time.Millisecond, ch); err == nil {
+		exitOnErr(fmt.Errorf("expected the second start to fail"))
+	}
+
+	done := make(chan struct{})
+	go func() {
+		for {
+			select {
+			case <-done:
+				return
+			default:
+				syscall.Getpid()
+			}
+		}
+	}()
+
+	intervals := <-ch
+	close(done)
+	sampler.Stop()
+	if _, ok := <-ch; ok {
+		exitOnErr(fmt.Errorf("expected the channel to be closed by Stop"))
+	}
+	exitOnErr(sampler.Err())
+
+	if len(intervals) != 1 || intervals[0].Name != "count_sys_enter" {
+		exitOnErr(fmt.Errorf("unexpected intervals %+v", intervals))
+	}
+	interval := intervals[0]
+	if interval.RunCount == 0 || interval.RunTime == 0 || interval.Rate == 0 {
+		exitOnErr(fmt.Errorf("program runs not accounted: %+v", interval))
+	}
+	fmt.Printf("%s: %.0f runs/s, %v per run\n", interval.Name, interval.Rate, interval.AvgRunTime)
+
+	stats, err := bpfModule.ProgramStats()
+	exitOnErr(err)
+	if len(stats) != 1 || stats[0].RunCount < interval.RunCount {
+		exitOnErr(fmt.Errorf("unexpected stats %+v", stats))
+	}
+}
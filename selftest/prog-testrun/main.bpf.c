@@ -0,0 +1,24 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+// drops packets whose first byte is 0xff, and marks the others
+SEC("xdp")
+int xdp_mark(struct xdp_md *ctx)
+{
+    __u8 *data = (void *) (long) ctx->data;
+    __u8 *data_end = (void *) (long) ctx->data_end;
+
+    if (data + 1 > data_end)
+        return XDP_ABORTED;
+    if (data[0] == 0xff)
+        return XDP_DROP;
+
+    data[0] = 0xaa;
+
+    return XDP_PASS;
+}
+
+char LICENSE[] SEC("license") = "GPL";
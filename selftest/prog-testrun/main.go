@@ -0,0 +1,63 @@
+package main
+
+import "C"
+
+import (
+	"fmt"
+	"os"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+const (
+	xdpDrop = 1
+	xdpPass = 2
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	prog, err := bpfModule.GetProgram("xdp_mark")
+	exitOnErr(err)
+
+	passPacket := make([]byte, 64)
+	dropPacket := make([]byte, 64)
+	dropPacket[0] = 0xff
+
+	result, err := prog.TestRun(bpf.TestRunOpts{DataIn: passPacket, Repeat: 1})
+	exitOnErr(err)
+	if result.RetVal != xdpPass {
+		exitOnErr(fmt.Errorf("expected XDP_PASS, got %d", result.RetVal))
+	}
+	if len(result.DataOut) != len(passPacket) || result.DataOut[0] != 0xaa {
+		exitOnErr(fmt.Errorf("unexpected output packet %v", result.DataOut))
+	}
+
+	result, err = prog.TestRun(bpf.TestRunOpts{DataIn: dropPacket, Repeat: 1})
+	exitOnErr(err)
+	if result.RetVal != xdpDrop {
+		exitOnErr(fmt.Errorf("expected XDP_DROP, got %d", result.RetVal))
+	}
+
+	bench, err := prog.Benchmark(bpf.BenchmarkOpts{
+		Inputs:  []bpf.TestRunOpts{{DataIn: passPacket}, {DataIn: dropPacket}},
+		Samples: 20,
+		Repeat:  1000,
+	})
+	exitOnErr(err)
+	if len(bench.Samples) != 20 || bench.Min > bench.Max {
+		exitOnErr(fmt.Errorf("unexpected benchmark result: %v", bench))
+	}
+	fmt.Println(bench)
+}
@@ -0,0 +1,32 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+#define TCX_NEXT -1
+
+// the order the programs ran in, for the first packet
+__u32 first_seq = 0;
+__u32 last_seq = 0;
+__u32 seq = 0;
+
+SEC("tcx/egress")
+int egress_first(struct __sk_buff *skb)
+{
+    if (!first_seq)
+        first_seq = __sync_add_and_fetch(&seq, 1);
+
+    return TCX_NEXT;
+}
+
+SEC("tcx/egress")
+int egress_last(struct __sk_buff *skb)
+{
+    if (!last_seq)
+        last_seq = __sync_add_and_fetch(&seq, 1);
+
+    return TCX_NEXT;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,75 @@
+package main
+
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"net"
+	"os"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	lo, err := net.InterfaceByName("lo")
+	exitOnErr(err)
+
+	first, err := bpfModule.GetProgram("egress_first")
+	exitOnErr(err)
+	last, err := bpfModule.GetProgram("egress_last")
+	exitOnErr(err)
+
+	if _, err := first.AttachTCX(lo.Index, bpf.TCXIngress, bpf.MultiProgOpts{}); err == nil {
+		exitOnErr(fmt.Errorf("attached an egress program to ingress"))
+	}
+
+	// attach the last one first, then order the first one before it
+	lastLink, err := last.AttachTCX(lo.Index, bpf.TCXEgress, bpf.MultiProgOpts{})
+	exitOnErr(err)
+	query, err := bpf.QueryMultiProg(lo.Index, bpf.BPFAttachTypeTCXEgress)
+	exitOnErr(err)
+	_, err = first.AttachTCX(lo.Index, bpf.TCXEgress, bpf.MultiProgOpts{
+		Position:         bpf.MultiProgBefore,
+		AnchorLink:       lastLink,
+		ExpectedRevision: query.Revision,
+	})
+	exitOnErr(err)
+
+	after, err := bpf.QueryMultiProg(lo.Index, bpf.BPFAttachTypeTCXEgress)
+	exitOnErr(err)
+	if len(after.ProgIDs) != len(query.ProgIDs)+1 || after.Revision == query.Revision {
+		exitOnErr(fmt.Errorf("unexpected programs %+v after %+v", after, query))
+	}
+
+	conn, err := net.Dial("udp", "127.0.0.1:9")
+	exitOnErr(err)
+	_, err = conn.Write([]byte("tcx"))
+	exitOnErr(err)
+	conn.Close()
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	firstSeq := binary.LittleEndian.Uint32(value[0:])
+	lastSeq := binary.LittleEndian.Uint32(value[4:])
+	if firstSeq != 1 || lastSeq != 2 {
+		exitOnErr(fmt.Errorf("programs ran in order %d, %d, expected 1, 2", firstSeq, lastSeq))
+	}
+}
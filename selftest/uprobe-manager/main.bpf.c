@@ -0,0 +1,19 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+
+__u64 hits = 0;
+__u64 cookie = 0;
+
+SEC("uprobe")
+int uprobe_target(void *ctx)
+{
+    __sync_fetch_and_add(&hits, 1);
+    cookie = bpf_get_attach_cookie(ctx);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
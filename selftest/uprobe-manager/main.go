@@ -0,0 +1,88 @@
+package main
+
+/*
+__attribute__((noinline)) int uprobe_manager_target(int x) { return x + 1; }
+*/
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"os/exec"
+	"time"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	if len(os.Args) > 1 && os.Args[1] == "child" {
+		time.Sleep(10 * time.Second)
+		return
+	}
+
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	self, err := os.Executable()
+	exitOnErr(err)
+
+	// a second process running the same binary
+	child := exec.Command(self, "child")
+	exitOnErr(child.Start())
+	defer func() {
+		_ = child.Process.Kill()
+		_ = child.Wait()
+	}()
+
+	prog, err := bpfModule.GetProgram("uprobe_target")
+	exitOnErr(err)
+	manager, err := prog.NewUprobeManager(bpf.UprobeManagerOpts{
+		Path:   self,
+		Symbol: "uprobe_manager_target",
+		Cookie: 7,
+	})
+	exitOnErr(err)
+	defer manager.Close()
+
+	exitOnErr(manager.Sync([]int{os.Getpid(), child.Process.Pid}))
+	if manager.Processes() != 2 || manager.Binaries() != 1 {
+		exitOnErr(fmt.Errorf("expected 2 processes on 1 binary, got %d on %d", manager.Processes(), manager.Binaries()))
+	}
+
+	for i := 0; i < 10; i++ {
+		C.uprobe_manager_target(C.int(i))
+	}
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	hits := binary.LittleEndian.Uint64(value[0:])
+	cookie := binary.LittleEndian.Uint64(value[8:])
+	if hits != 10 || cookie != 7 {
+		exitOnErr(fmt.Errorf("got %d hits and cookie %d, expected 10 and 7", hits, cookie))
+	}
+
+	// the binary stays attached while a process of the set uses it
+	exitOnErr(manager.RemoveProcess(child.Process.Pid))
+	if manager.Binaries() != 1 {
+		exitOnErr(fmt.Errorf("expected 1 binary, got %d", manager.Binaries()))
+	}
+	exitOnErr(manager.Sync(nil))
+	if manager.Processes() != 0 || manager.Binaries() != 0 {
+		exitOnErr(fmt.Errorf("expected an empty set, got %d processes on %d binaries", manager.Processes(), manager.Binaries()))
+	}
+}
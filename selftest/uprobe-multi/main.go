@@ -0,0 +1,77 @@
+package main
+
+/*
+__attribute__((noinline)) int uprobe_multi_target_a(int x) { return x + 1; }
+__attribute__((noinline)) int uprobe_multi_target_b(int x) { return x + 2; }
+*/
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	self, err := os.Executable()
+	exitOnErr(err)
+
+	cookieProg, err := bpfModule.GetProgram("count_by_cookie")
+	exitOnErr(err)
+	_, err = cookieProg.AttachUprobeMulti(bpf.UprobeMultiOpts{
+		Path:    self,
+		Pid:     os.Getpid(),
+		Symbols: []string{"uprobe_multi_target_a", "uprobe_multi_target_b"},
+		Cookies: []uint64{0, 1},
+	})
+	exitOnErr(err)
+
+	patternProg, err := bpfModule.GetProgram("count_pattern")
+	exitOnErr(err)
+	_, err = patternProg.AttachUprobeMulti(bpf.UprobeMultiOpts{
+		Path:    self,
+		Pid:     -1,
+		Pattern: "uprobe_multi_target_*",
+	})
+	exitOnErr(err)
+
+	for i := 0; i < 10; i++ {
+		C.uprobe_multi_target_a(C.int(i))
+		C.uprobe_multi_target_b(C.int(i))
+	}
+
+	hitsMap, err := bpfModule.GetMap("hits_by_cookie")
+	exitOnErr(err)
+	for cookie := uint32(0); cookie < 2; cookie++ {
+		value, err := hitsMap.GetValue(unsafe.Pointer(&cookie))
+		exitOnErr(err)
+		if hits := binary.LittleEndian.Uint64(value); hits != 10 {
+			exitOnErr(fmt.Errorf("cookie %d: %d hits, expected 10", cookie, hits))
+		}
+	}
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	if hits := binary.LittleEndian.Uint64(value); hits != 20 {
+		exitOnErr(fmt.Errorf("pattern: %d hits, expected 20", hits))
+	}
+}
@@ -0,0 +1,22 @@
+//+build ignore
+
+#include <vmlinux.h>
+
+#include <bpf/bpf_helpers.h>
+#include <bpf/usdt.bpf.h>
+
+__u64 hits = 0;
+__u64 arg_sum = 0;
+__u64 cookie = 0;
+
+SEC("usdt")
+int BPF_USDT(usdt_tick, int x)
+{
+    __sync_fetch_and_add(&hits, 1);
+    __sync_fetch_and_add(&arg_sum, x);
+    cookie = bpf_usdt_cookie(ctx);
+
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
@@ -0,0 +1,74 @@
+package main
+
+/*
+#include <sys/sdt.h>
+
+__attribute__((noinline)) void usdt_tick(int x) { DTRACE_PROBE1(libbpfgo, tick, x); }
+*/
+import "C"
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"unsafe"
+
+	bpf "github.com/khulnasoft-lab/libbpfgo"
+	"github.com/khulnasoft-lab/libbpfgo/helpers"
+)
+
+func exitOnErr(err error) {
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(-1)
+	}
+}
+
+func main() {
+	bpfModule, err := bpf.NewModuleFromFile("main.bpf.o")
+	exitOnErr(err)
+	defer bpfModule.Close()
+
+	exitOnErr(bpfModule.BPFLoadObject())
+
+	self, err := os.Executable()
+	exitOnErr(err)
+
+	probes, err := helpers.USDTProbes(self)
+	exitOnErr(err)
+	found := false
+	for _, probe := range probes {
+		if probe.Provider == "libbpfgo" && probe.Name == "tick" {
+			found = true
+		}
+	}
+	if !found {
+		exitOnErr(fmt.Errorf("USDT probe libbpfgo:tick not found in %v", probes))
+	}
+
+	prog, err := bpfModule.GetProgram("usdt_tick")
+	exitOnErr(err)
+	_, err = prog.AttachUSDT(os.Getpid(), self, "libbpfgo", "tick", 42)
+	exitOnErr(err)
+
+	_, err = prog.AttachUSDT(os.Getpid(), self, "libbpfgo", "missing", 0)
+	if err == nil {
+		exitOnErr(fmt.Errorf("attaching a missing USDT probe should fail"))
+	}
+
+	for i := 1; i <= 10; i++ {
+		C.usdt_tick(C.int(i))
+	}
+
+	bss, err := bpfModule.GetMap(".bss")
+	exitOnErr(err)
+	key := uint32(0)
+	value, err := bss.GetValue(unsafe.Pointer(&key))
+	exitOnErr(err)
+	hits := binary.LittleEndian.Uint64(value[0:])
+	argSum := binary.LittleEndian.Uint64(value[8:])
+	cookie := binary.LittleEndian.Uint64(value[16:])
+	if hits != 10 || argSum != 55 || cookie != 42 {
+		exitOnErr(fmt.Errorf("got %d hits, arg sum %d and cookie %d, expected 10, 55 and 42", hits, argSum, cookie))
+	}
+}